@@ -16,10 +16,12 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
 #include <codecvt>
+#include <fstream>
+#include <utility>
 
 #include "Configuration.h"
-#include "utils\CompanionError.h"
 
 using namespace CompanionWinRT;
 
@@ -27,44 +29,297 @@ void Configuration::setProcessing(MatchRecognition^ processing)
 {
     this->matchRecognition = processing;
     this->configurationObj.setProcessing(this->matchRecognition->getMatchRecognition());
+    this->applyRegionMask();
 }
 
 void Configuration::setProcessing(HashRecognition^ processing)
 {
     this->hashRecognition = processing;
-    this->configurationObj.setProcessing(this->hashRecognition->getHashRecognition());
+    this->configurationObj.setProcessing(this->hashRecognition->getHashProcessing());
+    this->applyRegionMask();
 }
 
 void Configuration::setProcessing(HybridRecognition^ processing)
 {
     this->hybridRecognition = processing;
     this->configurationObj.setProcessing(this->hybridRecognition->getHybridRecognition());
+    this->applyRegionMask();
+}
+
+void Configuration::setProcessing(GatedRecognition^ processing)
+{
+    this->gatedRecognition = processing;
+    this->configurationObj.setProcessing(this->gatedRecognition->getGatedRecognition());
+    this->applyRegionMask();
+}
+
+void Configuration::setProcessing(ShardedRecognition^ processing)
+{
+    this->shardedRecognition = processing;
+    this->configurationObj.setProcessing(this->shardedRecognition->getShardedRecognition());
+    this->applyRegionMask();
+}
+
+void Configuration::setProcessing(PipelineRecognition^ processing)
+{
+    this->pipelineRecognition = processing;
+    this->configurationObj.setProcessing(this->pipelineRecognition->getPipelineRecognition());
+    this->applyRegionMask();
+}
+
+void Configuration::setProcessing(TemplateRecognition^ processing)
+{
+    this->templateRecognition = processing;
+    this->configurationObj.setProcessing(this->templateRecognition->getTemplateRecognition());
 }
 
 void Configuration::setProcessing(ObjectDetection^ processing)
 {
     this->objectDetection = processing;
     this->configurationObj.setProcessing(this->objectDetection->getObjectDetection());
+    this->applyRegionMask();
+}
+
+void Configuration::setProcessing(MarkerDetection^ processing)
+{
+    this->markerDetection = processing;
+    this->configurationObj.setProcessing(this->markerDetection->getMarkerDetection());
+    this->applyRegionMask();
+}
+
+void Configuration::setActiveTags(IVector<Platform::String^>^ tags)
+{
+    if (this->matchRecognition != nullptr)
+    {
+        this->matchRecognition->setActiveTags(tags);
+    }
+    if (this->hashRecognition != nullptr)
+    {
+        this->hashRecognition->setActiveTags(tags);
+    }
+    if (this->hybridRecognition != nullptr)
+    {
+        this->hybridRecognition->setActiveTags(tags);
+    }
+    if (this->gatedRecognition != nullptr)
+    {
+        this->gatedRecognition->setActiveTags(tags);
+    }
+    if (this->pipelineRecognition != nullptr)
+    {
+        this->pipelineRecognition->setActiveTags(tags);
+    }
+}
+
+void Configuration::setRegionMask(Platform::String^ maskPath)
+{
+    this->regionMask.release();
+    if (maskPath != nullptr)
+    {
+        this->regionMask = cv::imread(Utils::ps2ss(maskPath), cv::IMREAD_GRAYSCALE);
+        if (this->regionMask.empty())
+        {
+            int hresult = static_cast<int>(ErrorCode::image_not_found);
+            throw ref new Platform::Exception(hresult);
+        }
+    }
+
+    this->applyRegionMask();
+}
+
+void Configuration::applyRegionMask()
+{
+    if (this->objectDetection != nullptr)
+    {
+        this->objectDetection->getObjectDetection()->setRegionMask(this->regionMask);
+    }
+    if (this->matchRecognition != nullptr)
+    {
+        // Companion's recognition has no region mask
+        Native::MatchProcessing* processing = this->matchRecognition->getMatchProcessing();
+        if (processing != nullptr)
+        {
+            processing->setRegionMask(this->regionMask);
+        }
+        else if (!this->regionMask.empty())
+        {
+            int hresult = static_cast<int>(ErrorCode::native_processing_required);
+            throw ref new Platform::Exception(hresult);
+        }
+    }
+    if (this->hashRecognition != nullptr)
+    {
+        this->hashRecognition->getHashProcessing()->setRegionMask(this->regionMask);
+    }
+    if (this->hybridRecognition != nullptr)
+    {
+        // Companion's recognition has no region mask
+        Native::HybridProcessing* processing = this->hybridRecognition->getHybridProcessing();
+        if (processing != nullptr)
+        {
+            processing->setRegionMask(this->regionMask);
+        }
+        else if (!this->regionMask.empty())
+        {
+            int hresult = static_cast<int>(ErrorCode::native_processing_required);
+            throw ref new Platform::Exception(hresult);
+        }
+    }
+    if (this->gatedRecognition != nullptr)
+    {
+        this->gatedRecognition->getGatedRecognition()->setRegionMask(this->regionMask);
+    }
+    if (this->shardedRecognition != nullptr)
+    {
+        this->shardedRecognition->getShardedRecognition()->setRegionMask(this->regionMask);
+    }
+    if (this->pipelineRecognition != nullptr)
+    {
+        this->pipelineRecognition->getPipelineRecognition()->setRegionMask(this->regionMask);
+    }
+    if (this->markerDetection != nullptr)
+    {
+        this->markerDetection->getMarkerDetection()->setRegionMask(this->regionMask);
+    }
 }
 
 void Configuration::setResultCallback(ResultDelegate^ callback, ColorFormat colorFormat)
 {
-    Companion::ColorFormat colorForm = Utils::getColorFormat(colorFormat);
-    this->configurationObj.setResultHandler([callback](std::vector<Companion::Model::Result::Result*> results, cv::Mat image)
+    std::lock_guard<std::mutex> lock(this->callbackMutex);
+    this->resultDelegate = callback;
+    this->resultColorFormat = colorFormat;
+}
+
+void Configuration::setFrameWorkCallback(FrameWorkDelegate^ callback)
+{
+    std::lock_guard<std::mutex> lock(this->callbackMutex);
+    this->frameWorkDelegate = callback;
+}
+
+void Configuration::applyCallbacks()
+{
+    std::lock_guard<std::mutex> lock(this->callbackMutex);
+
+    // The session looks up the current handler, the delegates themselves are looked up for every frame in 'handleResults'
+    if ((this->resultDelegate != nullptr) || (this->frameWorkDelegate != nullptr))
     {
-        Vector<Result^>^ resultsCX = ref new Vector<Result^>();
-        Result^ resultCX;
-        Frame^ frameCX;
+        bool grayscale = (this->resultColorFormat == ColorFormat::GRAY);
+        this->configurationObj.setResultHandler([this](std::vector<Companion::Model::Result::Result*>& results, cv::Mat& image,
+                                                       const std::shared_ptr<const Native::FrameWork>& work)
+        {
+            this->handleResults(results, image, work);
+        }, grayscale ? Companion::ColorFormat::BGR : Utils::getColorFormat(this->resultColorFormat), grayscale);
+    }
 
-        Companion::Model::Result::Result* result;
-        Companion::Draw::Frame* frame;
+    if ((this->errorDelegate != nullptr) || (this->errorEventDelegate != nullptr))
+    {
+        if (this->errorAggregator == nullptr)
+        {
+            this->errorAggregator.reset(new Native::ErrorAggregator([this](const Native::ErrorEvent& event)
+            {
+                this->dispatchError(event);
+            }, this->errorInterval));
+        }
+
+        // Errors are only counted on the processing thread, conversion and callbacks happen on the dispatcher thread
+        Native::ErrorAggregator* aggregator = this->errorAggregator.get();
+        Native::ImageBuffer* imageBuffer = (this->stream != nullptr) ? this->stream->getImageStream() : nullptr;
+        this->configurationObj.setErrorHandler([aggregator, imageBuffer](Companion::Error::Code code)
+        {
+            aggregator->report(static_cast<int>(code), (imageBuffer != nullptr) ? imageBuffer->getObtained() : 0);
+        });
+    }
+}
 
-        // Process all positive results
-        for (size_t i = 0; i < results.size(); i++)
+void Configuration::dispatchError(const Native::ErrorEvent& event)
+{
+    ErrorDelegate^ errorCallback;
+    ErrorEventDelegate^ eventCallback;
+    {
+        std::lock_guard<std::mutex> lock(this->callbackMutex);
+        errorCallback = this->errorDelegate;
+        eventCallback = this->errorEventDelegate;
+    }
+
+    Companion::Error::Code code = static_cast<Companion::Error::Code>(event.code);
+    std::map<int, Platform::String^>::iterator message = this->errorMessages.find(event.code);
+    if (message == this->errorMessages.end())
+    {
+        message = this->errorMessages.insert(std::make_pair(event.code, Utils::ss2ps(Companion::Error::getError(code)))).first;
+    }
+
+    if (errorCallback != nullptr)
+    {
+        errorCallback->Invoke(message->second);
+    }
+    if (eventCallback != nullptr)
+    {
+        eventCallback->Invoke(ErrorEvent{ getErrorCode(code), message->second, event.count, event.firstTime, event.lastTime, event.frame });
+    }
+}
+
+void Configuration::handleResults(std::vector<Companion::Model::Result::Result*>& results, cv::Mat& image,
+                                  const std::shared_ptr<const Native::FrameWork>& work)
+{
+    // Take the callbacks and the crop settings of this frame at once
+    ResultDelegate^ callback;
+    FrameWorkDelegate^ workCallback;
+    cv::Size cropSize;
+    bool omitImage;
+    {
+        std::lock_guard<std::mutex> lock(this->callbackMutex);
+        callback = this->resultDelegate;
+        workCallback = this->frameWorkDelegate;
+        cropSize = cv::Size(this->cropWidth, this->cropHeight);
+        omitImage = this->omitImage;
+    }
+
+    bool crops = (cropSize.area() > 0);
+    omitImage = crops && omitImage;
+
+    std::shared_ptr<Native::ResultPublisher> publisher = std::atomic_load(&this->resultPublisher);
+    if (publisher != nullptr)
+    {
+        publisher->publish(results);
+    }
+
+    // The work of the frame is reported once, also for frames without results, and shared with the pose results of the frame
+    FrameWork^ workCX = (work != nullptr) ? ref new FrameWork(*work) : nullptr;
+    if ((workCallback != nullptr) && (workCX != nullptr))
+    {
+        workCallback->Invoke(workCX);
+    }
+
+    if (callback == nullptr)
+    {
+        image.release();
+        return;
+    }
+
+    // Crops are taken from the unmarked image
+    cv::Mat source = (crops && !omitImage) ? image.clone() : image;
+    Native::MemoryCharge buffers(Native::MemoryComponent::RESULT_BUFFERS, omitImage ? 0 : Native::MemoryAccount::getBytes(image));
+    if (source.data != image.data)
+    {
+        buffers.add(Native::MemoryAccount::getBytes(source));
+    }
+
+    Vector<Result^>^ resultsCX = ref new Vector<Result^>();
+    Result^ resultCX;
+    Frame^ frameCX;
+
+    Companion::Model::Result::Result* result;
+    Companion::Draw::Frame* frame;
+
+    // Process all positive results
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        result = results.at(i);
+        resultCX = nullptr;
+        frame = dynamic_cast<Companion::Draw::Frame*>(result->getDrawable());
+        if (frame != nullptr)
         {
-            result = results.at(i);
-            frame = dynamic_cast<Companion::Draw::Frame*>(result->getDrawable());
-            if (frame != nullptr)
+            if (!omitImage)
             {
                 // Draw a frame around the detected object
                 frame->draw(image);
@@ -77,46 +332,275 @@ void Configuration::setResultCallback(ResultDelegate^ callback, ColorFormat colo
                     2,
                     frame->getColor(),
                     frame->getThickness());
+            }
 
-                // Capsule the frame into an ABI friendly C++/CX object
-                frameCX = ref new Frame(Point{ frame->getTopLeft().x,     frame->getTopLeft().y },
-                                        Point{ frame->getTopRight().x,    frame->getTopRight().y },
-                                        Point{ frame->getBottomRight().x, frame->getBottomRight().y },
-                                        Point{ frame->getBottomLeft().x,  frame->getBottomLeft().y });
+            // Capsule the frame into an ABI friendly C++/CX object
+            frameCX = ref new Frame(Point{ frame->getTopLeft().x,     frame->getTopLeft().y },
+                                    Point{ frame->getTopRight().x,    frame->getTopRight().y },
+                                    Point{ frame->getBottomRight().x, frame->getBottomRight().y },
+                                    Point{ frame->getBottomLeft().x,  frame->getBottomLeft().y });
 
-                // Capusle the result into an ABI friendly C++/CX object
-                if (result->getType() == Companion::Model::Result::ResultType::RECOGNITION) {
-                    Companion::Model::Result::RecognitionResult* recResult = (Companion::Model::Result::RecognitionResult*) result;
-                    resultCX = ref new Result(ResultType::RECOGNITION, frameCX, recResult->getId(), recResult->getScoring());
-                }
-                else if (result->getType() == Companion::Model::Result::ResultType::DETECTION)
+            // Capusle the result into an ABI friendly C++/CX object
+            if (result->getType() == Companion::Model::Result::ResultType::RECOGNITION) {
+                Companion::Model::Result::RecognitionResult* recResult = (Companion::Model::Result::RecognitionResult*) result;
+                resultCX = ref new Result(ResultType::RECOGNITION, frameCX, recResult->getId(), recResult->getScoring());
+
+                Native::PoseResult* pose = dynamic_cast<Native::PoseResult*>(result);
+                if (pose != nullptr)
                 {
-                    Companion::Model::Result::DetectionResult* detResult = (Companion::Model::Result::DetectionResult*) result;
-                    resultCX = ref new Result(ResultType::DETECTION, frameCX, Utils::ss2ps(detResult->getObjectType()), detResult->getScoring());
+                    cv::Matx33d matrix = pose->getHomography();
+                    Platform::Array<float64>^ homography = ref new Platform::Array<float64>(matrix.val, 9);
+                    Platform::Array<PointF>^ corners = ref new Platform::Array<PointF>(static_cast<unsigned int>(pose->getCorners().size()));
+                    for (unsigned int j = 0; j < corners->Length; j++)
+                    {
+                        corners[j] = PointF{ pose->getCorners()[j].x, pose->getCorners()[j].y };
+                    }
+                    resultCX->setPose(homography, corners);
+
+                    resultCX->setWork((pose->getWork() != nullptr) ? workCX : nullptr);
                 }
             }
-            
+            else if (result->getType() == Companion::Model::Result::ResultType::DETECTION)
+            {
+                Companion::Model::Result::DetectionResult* detResult = (Companion::Model::Result::DetectionResult*) result;
+                resultCX = ref new Result(ResultType::DETECTION, frameCX, Utils::ss2ps(detResult->getObjectType()), detResult->getScoring());
+            }
+
+            if (crops && (resultCX != nullptr))
+            {
+                // Rectify the object to the requested crop size
+                std::vector<cv::Point2f> corners = { frame->getTopLeft(), frame->getTopRight(), frame->getBottomRight(), frame->getBottomLeft() };
+                std::vector<cv::Point2f> target = { cv::Point2f(0.0f, 0.0f), cv::Point2f(static_cast<float>(cropSize.width), 0.0f),
+                                                    cv::Point2f(static_cast<float>(cropSize.width), static_cast<float>(cropSize.height)),
+                                                    cv::Point2f(0.0f, static_cast<float>(cropSize.height)) };
+                cv::Mat crop;
+                cv::warpPerspective(source, crop, cv::getPerspectiveTransform(corners, target), cropSize);
+                buffers.add(Native::MemoryAccount::getBytes(crop));
+                resultCX->setCrop(ref new Platform::Array<uint8>(crop.data, static_cast<unsigned int>(crop.total() * crop.elemSize())));
+            }
+        }
+
+        // Results of unknown types are skipped
+        if (resultCX != nullptr)
+        {
             resultsCX->Append(resultCX);
         }
+    }
 
-        // Copy image data to a byte[] so it can be passed across the ABI
-        Platform::Array<uint8>^ imageData = ref new Platform::Array<uint8>(image.data, image.step.buf[1] * image.cols * image.rows);
+    // Copy image data to a byte[] so it can be passed across the ABI
+    Platform::Array<uint8>^ imageData = omitImage ? ref new Platform::Array<uint8>(0)
+                                                  : ref new Platform::Array<uint8>(image.data, image.step.buf[1] * image.cols * image.rows);
 
-        // Invoke callback
-        callback->Invoke(resultsCX, imageData);
+    // Invoke callback
+    callback->Invoke(resultsCX, imageData);
 
-        // Release data
-        image.release();
-        results.clear();
-    }, colorForm);
+    // Release data
+    image.release();
+    results.clear();
+}
+
+void Configuration::setResultCrops(int width, int height, bool omitImage)
+{
+    std::lock_guard<std::mutex> lock(this->callbackMutex);
+    this->cropWidth = std::max(0, width);
+    this->cropHeight = std::max(0, height);
+    this->omitImage = omitImage;
+}
+
+void Configuration::setResultPublisher(Platform::String^ name, int capacity)
+{
+    std::shared_ptr<Native::ResultPublisher> publisher;
+    if (name != nullptr)
+    {
+        publisher = std::make_shared<Native::ResultPublisher>(std::wstring(name->Data()), static_cast<uint32_t>(std::max(1, capacity)));
+        if (!publisher->isOpen())
+        {
+            int hresult = static_cast<int>(ErrorCode::publisher_not_created);
+            throw ref new Platform::Exception(hresult);
+        }
+    }
+
+    std::atomic_store(&this->resultPublisher, publisher);
+}
+
+uint64 Configuration::getPublishedResults()
+{
+    std::shared_ptr<Native::ResultPublisher> publisher = std::atomic_load(&this->resultPublisher);
+    return (publisher != nullptr) ? publisher->getPublished() : 0;
+}
+
+Histogram^ Configuration::getLatencyHistogram(LatencyStage stage)
+{
+    Native::HistogramSnapshot snapshot;
+
+    switch (stage)
+    {
+        case LatencyStage::IMAGE_ADD:
+            if (this->stream != nullptr)
+            {
+                snapshot = this->stream->getImageStream()->getAddTimes().getSnapshot();
+            }
+            break;
+        case LatencyStage::IMAGE_QUEUE:
+            if (this->stream != nullptr)
+            {
+                snapshot = this->stream->getImageStream()->getQueueTimes().getSnapshot();
+            }
+            break;
+        case LatencyStage::MODEL_LOCK_WAIT:
+        case LatencyStage::MODEL_LOCK_HOLD:
+        {
+            std::vector<Native::ContentionMutex*> mutexes = this->getModelMutexes();
+            for (size_t i = 0; i < mutexes.size(); i++)
+            {
+                const Native::LatencyHistogram& histogram = (stage == LatencyStage::MODEL_LOCK_WAIT) ? mutexes[i]->getWaitTimes() : mutexes[i]->getHoldTimes();
+                snapshot.merge(histogram.getSnapshot());
+            }
+            break;
+        }
+    }
+
+    return ref new Histogram(snapshot);
+}
+
+void Configuration::resetLatencyHistograms()
+{
+    if (this->stream != nullptr)
+    {
+        this->stream->getImageStream()->resetTimes();
+    }
+
+    std::vector<Native::ContentionMutex*> mutexes = this->getModelMutexes();
+    for (size_t i = 0; i < mutexes.size(); i++)
+    {
+        mutexes[i]->resetTimes();
+    }
+}
+
+void Configuration::exportLatencyHistograms(Platform::String^ path)
+{
+    std::ofstream file(Utils::ps2ss(path));
+    if (!file)
+    {
+        int hresult = static_cast<int>(ErrorCode::export_failed);
+        throw ref new Platform::Exception(hresult);
+    }
+
+    const std::pair<LatencyStage, const char*> stages[] = {
+        { LatencyStage::IMAGE_ADD, "image_add" },
+        { LatencyStage::IMAGE_QUEUE, "image_queue" },
+        { LatencyStage::MODEL_LOCK_WAIT, "model_lock_wait" },
+        { LatencyStage::MODEL_LOCK_HOLD, "model_lock_hold" }
+    };
+
+    file << "stage,bucket_us,count" << std::endl;
+    for (size_t i = 0; i < sizeof(stages) / sizeof(stages[0]); i++)
+    {
+        Platform::Array<uint64>^ buckets = this->getLatencyHistogram(stages[i].first)->getBuckets();
+        for (unsigned int j = 0; j < buckets->Length; j++)
+        {
+            file << stages[i].second << "," << (1ULL << j) << "," << buckets[j] << std::endl;
+        }
+    }
+
+    if (!file)
+    {
+        int hresult = static_cast<int>(ErrorCode::export_failed);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+MemoryUsage Configuration::getMemoryUsage(MemoryComponent component)
+{
+    Native::MemoryAccount& account = Native::MemoryAccount::get(static_cast<Native::MemoryComponent>(component));
+    return MemoryUsage{ account.getCurrent(), account.getPeak() };
+}
+
+void Configuration::resetMemoryPeaks()
+{
+    for (int i = 0; i < static_cast<int>(Native::MemoryComponent::COUNT); i++)
+    {
+        Native::MemoryAccount::get(static_cast<Native::MemoryComponent>(i)).resetPeak();
+    }
+}
+
+void Configuration::setSceneCache(bool enabled)
+{
+    Native::SceneFeatureCache::get().setEnabled(enabled);
+}
+
+SceneCacheStatistics Configuration::getSceneCacheStatistics()
+{
+    Native::SceneCacheStatistics statistics = Native::SceneFeatureCache::get().getStatistics();
+    uint64 extractions = statistics.hits + statistics.misses;
+    return SceneCacheStatistics{ statistics.hits, statistics.misses, (extractions > 0) ? static_cast<double>(statistics.hits) / extractions : 0.0 };
+}
+
+void Configuration::resetSceneCacheStatistics()
+{
+    Native::SceneFeatureCache::get().resetStatistics();
+}
+
+WorkStatistics Configuration::getWorkStatistics()
+{
+    Native::WorkStatistics statistics = Native::WorkCounter::getStatistics();
+    return WorkStatistics{ statistics.frames, FrameWork::toCounters(statistics.totals) };
+}
+
+void Configuration::resetWorkStatistics()
+{
+    Native::WorkCounter::resetStatistics();
+}
+
+std::vector<Native::ContentionMutex*> Configuration::getModelMutexes()
+{
+    std::vector<Native::ContentionMutex*> mutexes;
+    if ((this->matchRecognition != nullptr) && (this->matchRecognition->getMatchProcessing() != nullptr))
+    {
+        mutexes.push_back(&this->matchRecognition->getMatchProcessing()->getModelsMutex());
+    }
+    if ((this->hybridRecognition != nullptr) && (this->hybridRecognition->getHybridProcessing() != nullptr))
+    {
+        mutexes.push_back(&this->hybridRecognition->getHybridProcessing()->getModelsMutex());
+    }
+    if (this->gatedRecognition != nullptr)
+    {
+        mutexes.push_back(&this->gatedRecognition->getGatedRecognition()->getModelsMutex());
+    }
+    if (this->pipelineRecognition != nullptr)
+    {
+        mutexes.push_back(&this->pipelineRecognition->getPipelineRecognition()->getModelsMutex());
+    }
+    if (this->templateRecognition != nullptr)
+    {
+        mutexes.push_back(&this->templateRecognition->getTemplateRecognition()->getTemplatesMutex());
+    }
+    if (this->markerDetection != nullptr)
+    {
+        mutexes.push_back(&this->markerDetection->getMarkerDetection()->getMarkersMutex());
+    }
+    return mutexes;
 }
 
 void Configuration::setErrorCallback(ErrorDelegate^ callback)
 {
-    this->configurationObj.setErrorHandler([callback](Companion::Error::Code code)
+    std::lock_guard<std::mutex> lock(this->callbackMutex);
+    this->errorDelegate = callback;
+}
+
+void Configuration::setErrorEventCallback(ErrorEventDelegate^ callback)
+{
+    std::lock_guard<std::mutex> lock(this->callbackMutex);
+    this->errorEventDelegate = callback;
+}
+
+void Configuration::setErrorInterval(int interval)
+{
+    this->errorInterval = std::max(0, interval);
+    if (this->errorAggregator != nullptr)
     {
-        callback->Invoke(Utils::ss2ps(Companion::Error::getError(code)));
-    });
+        this->errorAggregator->setInterval(this->errorInterval);
+    }
 }
 
 void Configuration::setSkipFrame(int skipFrame)
@@ -137,7 +621,7 @@ int Configuration::getSkipFrame()
 void Configuration::setSource(ImageStream^ stream)
 {
     this->stream = stream;
-    this->configurationObj.setSource(this->stream->getImageStream());
+    this->configurationObj.setSource(this->stream->getImageStream(), this->stream->getGate());
 }
 
 ImageStream^ Configuration::getSource()
@@ -155,6 +639,8 @@ ImageStream^ Configuration::getSource()
 
 void Configuration::run()
 {
+    this->applyCallbacks();
+
     try
     {
         this->configurationObj.run();
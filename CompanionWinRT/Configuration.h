@@ -20,13 +20,31 @@
 #pragma once
 
 #include <collection.h>
-#include "processing\detection\ObjectDetection.h"
-#include "processing\recognition\HashRecognition.h"
-#include "processing\recognition\HybridRecognition.h"
-#include "processing\recognition\MatchRecognition.h"
-#include "input\ImageStream.h"
-#include "model\result\Result.h"
-#include "utils\CompanionUtils.h"
+#include <map>
+#include <memory>
+#include <mutex>
+#include "processing/detection/MarkerDetection.h"
+#include "processing/detection/ObjectDetection.h"
+#include "processing/recognition/GatedRecognition.h"
+#include "processing/recognition/HashRecognition.h"
+#include "processing/recognition/HybridRecognition.h"
+#include "processing/recognition/MatchRecognition.h"
+#include "processing/recognition/PipelineRecognition.h"
+#include "processing/recognition/ShardedRecognition.h"
+#include "processing/recognition/TemplateRecognition.h"
+#include "input/ImageStream.h"
+#include "native/ErrorAggregator.h"
+#include "native/ProcessingSession.h"
+#include "native/ResultPublisher.h"
+#include "native/SceneFeatureCache.h"
+#include "model/result/FrameWork.h"
+#include "model/result/Result.h"
+#include "model/statistics/Histogram.h"
+#include "model/statistics/MemoryUsage.h"
+#include "model/statistics/SceneCacheStatistics.h"
+#include "model/statistics/WorkStatistics.h"
+#include "utils/CompanionError.h"
+#include "utils/CompanionUtils.h"
 
 using namespace Platform::Collections;
 using namespace Windows::Foundation::Collections;
@@ -48,6 +66,56 @@ namespace CompanionWinRT
      */
     public delegate void ErrorDelegate(Platform::String^ errorMessage);
 
+    /**
+     * A delegate that defines a frame work callback function for the client app.
+     *
+     * @param work  algorithm-level work of a processed frame
+     */
+    public delegate void FrameWorkDelegate(FrameWork^ work);
+
+    /**
+     * This struct represents the coalesced occurrences of an error.
+     */
+    public value struct ErrorEvent
+    {
+        /**
+         * Error code.
+         */
+        ErrorCode code;
+
+        /**
+         * A message to describe the error.
+         */
+        Platform::String^ message;
+
+        /**
+         * Number of occurrences since the last event of this error code.
+         */
+        uint64 count;
+
+        /**
+         * Time of the first occurrence (in milliseconds since the Unix epoch).
+         */
+        int64 firstTime;
+
+        /**
+         * Time of the last occurrence (in milliseconds since the Unix epoch).
+         */
+        int64 lastTime;
+
+        /**
+         * Number of the frame of the last occurrence (counted from the start of the image stream).
+         */
+        uint64 frame;
+    };
+
+    /**
+     * A delegate that defines an error event callback function for the client app.
+     *
+     * @param errorEvent    coalesced occurrences of an error
+     */
+    public delegate void ErrorEventDelegate(ErrorEvent errorEvent);
+
     /**
      * This class provides WinRT compatible functionality wrapped around the Companion framework code.
      *
@@ -90,6 +158,50 @@ namespace CompanionWinRT
              */
             void setProcessing(HybridRecognition^ processing);
 
+            /**
+             * Set the image processing algorithm.
+             *
+             * @param processing    an image processing algorithm
+             *
+             * Note:
+             * Native code in interfaces and public inheritance are not possible in a WinRT context (with very few exceptions).
+             * We can not mirror the plausible interface / abstract class 'ImageProcessing' for this wrapper.
+             */
+            void setProcessing(GatedRecognition^ processing);
+
+            /**
+             * Set the image processing algorithm.
+             *
+             * @param processing    an image processing algorithm
+             *
+             * Note:
+             * Native code in interfaces and public inheritance are not possible in a WinRT context (with very few exceptions).
+             * We can not mirror the plausible interface / abstract class 'ImageProcessing' for this wrapper.
+             */
+            void setProcessing(ShardedRecognition^ processing);
+
+            /**
+             * Set the image processing algorithm.
+             *
+             * @param processing    an image processing algorithm
+             *
+             * Note:
+             * Native code in interfaces and public inheritance are not possible in a WinRT context (with very few exceptions).
+             * We can not mirror the plausible interface / abstract class 'ImageProcessing' for this wrapper.
+             */
+            void setProcessing(PipelineRecognition^ processing);
+
+            /**
+             * Set the image processing algorithm.
+             *
+             * @param processing    an image processing algorithm
+             *
+             * Note:
+             * Native code in interfaces and public inheritance are not possible in a WinRT context (with very few exceptions).
+             * We can not mirror the plausible interface / abstract class 'ImageProcessing' for this wrapper.
+             */
+            void setProcessing(TemplateRecognition^ processing);
+
             /**
              * Set the image processing algorithm.
              *
@@ -102,7 +214,42 @@ namespace CompanionWinRT
             void setProcessing(ObjectDetection^ processing);
 
             /**
-             * Set a function as a result callback for processing.
+             * Set the image processing algorithm.
+             *
+             * @param processing    an image processing algorithm
+             *
+             * Note:
+             * Native code in interfaces and public inheritance are not possible in a WinRT context (with very few exceptions).
+             * We can not mirror the plausible interface / abstract class 'ImageProcessing' for this wrapper.
+             */
+            void setProcessing(MarkerDetection^ processing);
+
+            /**
+             * Select the active model tags of all recognition algorithms of this configuration, for example the models that can be
+             * seen by the camera of this configuration. Only models with an active tag are searched for.
+             *
+             * @param tags  active tags (nullptr or an empty vector activates all models)
+             */
+            void setActiveTags(IVector<Platform::String^>^ tags);
+
+            /**
+             * Set a static region mask for the camera view of this configuration. White mask pixels are processed, black mask pixels
+             * are excluded, for example fixed textured areas like signage or shelves that never contain objects. The mask is scaled
+             * to the frame size.
+             *
+             * Keypoints are not detected in excluded regions. The shape detection of object detection, hash, hybrid, gated, marker and
+             * pipeline processing searches only the bounding rectangle of the processed region, and shapes with a corner in an excluded
+             * region or on the boundary of the processed region are skipped. The mask applies to all processing types except template recognition, match and
+             * hybrid recognition need their native processing ('native_processing_required' otherwise).
+             *
+             * @param maskPath  path of the mask image (nullptr to process the whole frame again)
+             */
+            void setRegionMask(Platform::String^ maskPath);
+
+            /**
+             * Set a function as a result callback for processing. The callback can be replaced while the processing is running, a
+             * new color format is used from the next start of the processing. With <code>ColorFormat::GRAY</code> gray frames (see
+             * 'ImageStream::setGrayscale') are returned without any conversion, with other color formats they are converted back.
              *
              * @param callback      a concrete function that works as a callback for the processing result
              * @param colorFormat   color format of the returned result image
@@ -110,12 +257,147 @@ namespace CompanionWinRT
             void setResultCallback(ResultDelegate^ callback, ColorFormat colorFormat);
 
             /**
-             * Set a function as an error callback for processing.
+             * Attach a rectified crop of each detected or recognized object to its result, see 'Result::getCrop'. The object's frame
+             * is warped to the requested size in native code, so consumers don't have to crop and rectify the full image.
+             *
+             * @param width     width of the crops (in pixels, 0 to disable crops)
+             * @param height    height of the crops (in pixels, 0 to disable crops)
+             * @param omitImage <code>true</code> to pass an empty image to the result callback instead of the full processed image
+             */
+            void setResultCrops(int width, int height, bool omitImage);
+
+            /**
+             * Set a function as a frame work callback for processing. The callback is invoked once for every processed frame, whatever
+             * the number of its results, with the algorithm-level work of the frame. Only the native processings count their work,
+             * so the callback isn't invoked for Companion's processings. The callback can be replaced while the processing is running.
+             *
+             * @param callback  a concrete function that works as a frame work callback (nullptr to disable it)
+             */
+            void setFrameWorkCallback(FrameWorkDelegate^ callback);
+
+            /**
+             * Publish all results to other local processes over a named shared memory ring, in addition to the result callback.
+             * Publishing never blocks the processing: once the ring is full the oldest records are overwritten and subscribers count
+             * them as dropped. See 'ResultSubscriber' for the subscriber library and 'ResultSchema.h' for the binary schema.
+             *
+             * @param name      name of the shared memory ring (nullptr to stop publishing)
+             * @param capacity  number of frames the ring can buffer
+             *
+             * @throws Platform::Exception if the shared memory ring could not be created
+             */
+            void setResultPublisher(Platform::String^ name, int capacity);
+
+            /**
+             * Return the number of frames published to the shared memory ring.
+             *
+             * @return number of published frames (0 if no publisher is set)
+             */
+            uint64 getPublishedResults();
+
+            /**
+             * Return the histogram of the durations at a point of the processing where frames or threads wait, so latency can be
+             * split into waiting and compute time. Lock times are summed over the models of all image processing algorithms of
+             * this configuration.
+             *
+             * @param stage the point of the processing
+             * @return histogram of the durations since the last reset
+             */
+            Histogram^ getLatencyHistogram(LatencyStage stage);
+
+            /**
+             * Reset the histograms of all points of the processing where frames or threads wait.
+             */
+            void resetLatencyHistograms();
+
+            /**
+             * Export the histograms of all points of the processing where frames or threads wait to a CSV file with the columns
+             * stage, upper bucket bound (in microseconds) and count.
+             *
+             * @param path  path of the CSV file
+             *
+             * @throws Platform::Exception if the file could not be written
+             */
+            void exportLatencyHistograms(Platform::String^ path);
+
+            /**
+             * Return the current and peak memory of a component. Memory is accounted over all configurations of the process, so the
+             * footprint of a catalog size or stream configuration can be measured before it is deployed.
+             *
+             * @param component the component
+             * @return current and peak memory of the component (in bytes)
+             */
+            static MemoryUsage getMemoryUsage(MemoryComponent component);
+
+            /**
+             * Reset the peak memory of all components to their current memory.
+             */
+            static void resetMemoryPeaks();
+
+            /**
+             * Enable or disable the scene feature cache (disabled by default). The cache extracts the scene features of a frame
+             * region once for all processors with equal feature matching settings, for example for candidate regions of a hybrid
+             * recognition that several candidates share or extraction stages of a pipeline recognition. A single match or gated
+             * recognition never hits the cache and only pays for it. The cache is shared by all configurations of the process,
+             * stopping a configuration only drops the entries of its own processing.
+             *
+             * @param enabled   <code>true</code> to enable the cache, <code>false</code> to disable it
+             */
+            static void setSceneCache(bool enabled);
+
+            /**
+             * Return the hits and misses of the scene feature cache since the start of the application or the last reset.
+             *
+             * @return hits, misses and hit rate of the scene feature cache
+             */
+            static SceneCacheStatistics getSceneCacheStatistics();
+
+            /**
+             * Reset the hits and misses of the scene feature cache.
+             */
+            static void resetSceneCacheStatistics();
+
+            /**
+             * Return the algorithm-level work of all processings of the process since the start of the application or the last
+             * reset: scene keypoints, matched descriptors, raw and filtered matches, robust estimation iterations, inliers,
+             * contours, hash candidates and verified models. The work of a single frame is attached to its results, see
+             * 'Result::getWork'.
+             *
+             * @return number of processed frames and their summed work
+             */
+            static WorkStatistics getWorkStatistics();
+
+            /**
+             * Reset the algorithm-level work of all processings.
+             */
+            static void resetWorkStatistics();
+
+            /**
+             * Set a function as an error callback for processing. The callback can be replaced while the processing is running.
+             *
+             * Errors are coalesced like error events (see 'setErrorEventCallback'), the callback is invoked once per error event.
              *
              * @param callback  a concrete function that works as an error callback
              */
             void setErrorCallback(ErrorDelegate^ callback);
 
+            /**
+             * Set a function as an error event callback for processing. The callback can be replaced while the processing is running.
+             *
+             * Errors are coalesced per error code and the callbacks are invoked on a background thread, at most once per error code
+             * and error interval. The first occurrence of an error code is passed right away, further occurrences within the
+             * interval are counted into the next event, so a failing source doesn't flood the app or slow down the processing.
+             *
+             * @param callback  a concrete function that works as an error event callback
+             */
+            void setErrorEventCallback(ErrorEventDelegate^ callback);
+
+            /**
+             * Set the minimum time between two error events of the same error code (1000 milliseconds by default).
+             *
+             * @param interval  minimum time between two error events of the same error code (in milliseconds)
+             */
+            void setErrorInterval(int interval);
+
             /**
              * Set the number of frames to skip.
              *
@@ -168,7 +450,8 @@ namespace CompanionWinRT
             void run();
 
             /**
-             * Stop the image processing.
+             * Stop the image processing. Producers that are blocked in 'ImageStream::addImage' by a full image buffer are released
+             * and further images are rejected until the processing is started again.
              */
             void stop();
 
@@ -179,15 +462,45 @@ namespace CompanionWinRT
              */
             ResultDelegate^ resultDelegate;
 
+            /**
+             * Handle to the frame work callback function.
+             */
+            FrameWorkDelegate^ frameWorkDelegate;
+
             /**
              * Handle to the error callback function.
              */
             ErrorDelegate^ errorDelegate;
-           
+
+            /**
+             * Handle to the error event callback function.
+             */
+            ErrorEventDelegate^ errorEventDelegate;
+
             /**
-             * The native 'Configuration' object of this instance.
+             * Minimum time between two error events of the same error code (in milliseconds).
              */
-            Companion::Configuration configurationObj;
+            int errorInterval = 1000;
+
+            /**
+             * Error messages per error code, converted once (only accessed by the error dispatcher thread).
+             */
+            std::map<int, Platform::String^> errorMessages;
+
+            /**
+             * Color format of the result image.
+             */
+            ColorFormat resultColorFormat = ColorFormat::RGB;
+
+            /**
+             * Mutex of the callback handles and the crop settings, which can be replaced while the processing is running.
+             */
+            std::mutex callbackMutex;
+
+            /**
+             * The native 'ProcessingSession' object of this instance.
+             */
+            Native::ProcessingSession configurationObj;
 
             /**
              * A handle to the 'MatchRecognition' wrapper object.
@@ -204,14 +517,103 @@ namespace CompanionWinRT
              */
             HybridRecognition^ hybridRecognition;
 
+            /**
+             * A handle to the 'GatedRecognition' wrapper object.
+             */
+            GatedRecognition^ gatedRecognition;
+
+            /**
+             * A handle to the 'ShardedRecognition' wrapper object.
+             */
+            ShardedRecognition^ shardedRecognition;
+
+            /**
+             * A handle to the 'PipelineRecognition' wrapper object.
+             */
+            PipelineRecognition^ pipelineRecognition;
+
+            /**
+             * A handle to the 'TemplateRecognition' wrapper object.
+             */
+            TemplateRecognition^ templateRecognition;
+
             /**
              * A handle to the 'ObjectDetection' wrapper object.
              */
             ObjectDetection^ objectDetection;
 
+            /**
+             * A handle to the 'MarkerDetection' wrapper object.
+             */
+            MarkerDetection^ markerDetection;
+
             /**
              * A handle to the 'ImageStream' wrapper object.
              */
             ImageStream^ stream;
+
+            /**
+             * Static region mask (empty if the whole frame is processed).
+             */
+            cv::Mat regionMask;
+
+            /**
+             * Width of the result crops (0 if crops are disabled).
+             */
+            int cropWidth = 0;
+
+            /**
+             * Height of the result crops (0 if crops are disabled).
+             */
+            int cropHeight = 0;
+
+            /**
+             * Indicator to omit the full processed image in the result callback.
+             */
+            bool omitImage = false;
+
+            /**
+             * Publisher of the results to other local processes (empty if results are not published).
+             */
+            std::shared_ptr<Native::ResultPublisher> resultPublisher;
+
+            /**
+             * Coalesces errors and dispatches them to the error callbacks (declared last, so its dispatcher thread is stopped first).
+             */
+            std::unique_ptr<Native::ErrorAggregator> errorAggregator;
+
+            /**
+             * Pass the region mask to the native processing of all image processing algorithms of this configuration.
+             */
+            void applyRegionMask();
+
+            /**
+             * Return the locks of the models of all image processing algorithms of this configuration.
+             *
+             * @return locks of the models
+             */
+            std::vector<Native::ContentionMutex*> getModelMutexes();
+
+            /**
+             * Install the native result and error handlers, which invoke the current callbacks.
+             */
+            void applyCallbacks();
+
+            /**
+             * Publish the results of a processed frame and pass them to the current result and frame work callbacks.
+             *
+             * @param results   results of the processed frame
+             * @param image     the processed frame
+             * @param work      work of the processed frame (nullptr if the processing doesn't count its work)
+             */
+            void handleResults(std::vector<Companion::Model::Result::Result*>& results, cv::Mat& image,
+                               const std::shared_ptr<const Native::FrameWork>& work);
+
+            /**
+             * Pass an error event to the current error callbacks.
+             *
+             * @param event coalesced occurrences of an error
+             */
+            void dispatchError(const Native::ErrorEvent& event);
     };
 }
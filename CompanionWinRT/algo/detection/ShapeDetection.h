@@ -19,9 +19,9 @@
  /// @file
 #pragma once
 
-#include <companion\algo\detection\ShapeDetection.h>
+#include <companion/algo/detection/ShapeDetection.h>
 
-#include "CompanionWinRT\utils\CompanionUtils.h"
+#include "CompanionWinRT/utils/CompanionUtils.h"
 
 namespace CompanionWinRT
 {
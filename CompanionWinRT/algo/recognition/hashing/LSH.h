@@ -18,7 +18,7 @@
 
 #pragma once
 
-#include <companion\algo\recognition\hashing\LSH.h>
+#include <companion/algo/recognition/hashing/LSH.h>
 
 namespace CompanionWinRT
 {
@@ -16,12 +16,17 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <algorithm>
+#include <cmath>
+
 #include "FeatureMatching.h"
+#include "CompanionWinRT/utils/CompanionError.h"
 
 using namespace CompanionWinRT;
 
 FeatureMatching::FeatureMatching(FeatureDetector detector, DescriptorMatcherType matcherType, int thresh, int nfeatures, int minSideLength, int countMatches,
                                  bool useIRA, double reprojThreshold, int ransacMaxIters, EstimationAlgorithm findHomographyMethod)
+    : detectorType(detector), thresh(thresh), nfeatures(nfeatures)
 {
     // Create descriptor matcher
     int type = (int) matcherType;
@@ -45,6 +50,12 @@ FeatureMatching::FeatureMatching(FeatureDetector detector, DescriptorMatcherType
             this->matcher.release();
             this->featureMatchingObj = nullptr;
     }
+
+    // Create the feature verification for the recognition processing of this wrapper
+    this->featureVerificationObj = (this->detector != nullptr)
+        ? new Native::FeatureVerification(this->detector, this->getDetectorKey(0), this->matcher, type, minSideLength, countMatches, reprojThreshold, ransacMaxIters,
+                                          (int) findHomographyMethod)
+        : nullptr;
 }
 
 FeatureMatching::~FeatureMatching()
@@ -56,9 +67,91 @@ FeatureMatching::~FeatureMatching()
     }
     delete this->featureMatchingObj;
     this->featureMatchingObj = nullptr;
+    delete this->featureVerificationObj;
+    this->featureVerificationObj = nullptr;
+}
+
+void FeatureMatching::setPreVerification(PreVerification preVerification)
+{
+    this->featureVerificationObj->setHoughVoting(preVerification == PreVerification::HOUGH_VOTING);
+}
+
+void FeatureMatching::setUpright(bool upright)
+{
+    if (upright && (this->detectorType != FeatureDetector::ORB))
+    {
+        int hresult = static_cast<int>(ErrorCode::upright_not_supported);
+        throw ref new Platform::Exception(hresult);
+    }
+
+    if (!this->featureVerificationObj->setUpright(upright))
+    {
+        int hresult = static_cast<int>(ErrorCode::settings_locked);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+bool FeatureMatching::isUpright()
+{
+    return this->featureVerificationObj->isUpright();
+}
+
+void FeatureMatching::setPyramidLevels(int modelLevels, int sceneLevels)
+{
+    sceneLevels = std::max(1, sceneLevels);
+    bool set = true;
+
+    switch (this->detectorType)
+    {
+        case FeatureDetector::BRISK :
+            // BRISK octaves are sampled with an intra-octave in between (0 octaves is a single scale)
+            set = this->featureVerificationObj->setPyramid(cv::BRISK::create(this->thresh, sceneLevels - 1), this->getDetectorKey(sceneLevels), modelLevels, std::sqrt(2.0));
+            break;
+        case FeatureDetector::ORB :
+            set = this->featureVerificationObj->setPyramid(cv::ORB::create(this->nfeatures, 1.2f, sceneLevels), this->getDetectorKey(sceneLevels), modelLevels, 1.2);
+            break;
+        default:
+            break;
+    }
+
+    if (!set)
+    {
+        int hresult = static_cast<int>(ErrorCode::settings_locked);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+PreVerificationStatistics FeatureMatching::getPreVerificationStatistics()
+{
+    Native::PreVerificationStatistics statistics = this->featureVerificationObj->getPreVerificationStatistics();
+    return PreVerificationStatistics{ statistics.matchesBefore, statistics.matchesAfter, statistics.rejectedModels, statistics.time };
+}
+
+void FeatureMatching::resetPreVerificationStatistics()
+{
+    this->featureVerificationObj->resetPreVerificationStatistics();
+}
+
+std::string FeatureMatching::getDetectorKey(int sceneLevels)
+{
+    // Default pyramids: 3 BRISK octaves (4 levels), 8 ORB levels
+    switch (this->detectorType)
+    {
+        case FeatureDetector::BRISK :
+            return "BRISK/" + std::to_string(this->thresh) + "/" + std::to_string((sceneLevels > 0) ? sceneLevels : 4);
+        case FeatureDetector::ORB :
+            return "ORB/" + std::to_string(this->nfeatures) + "/" + std::to_string((sceneLevels > 0) ? sceneLevels : 8);
+        default:
+            return std::string();
+    }
 }
 
 Companion::Algorithm::Recognition::Matching::FeatureMatching* FeatureMatching::getFeatureMatching()
 {
     return this->featureMatchingObj;
 }
+
+Native::FeatureVerification* FeatureMatching::getFeatureVerification()
+{
+    return this->featureVerificationObj;
+}
@@ -19,7 +19,9 @@
  /// @file
 #pragma once
 
-#include <companion\algo\recognition\matching\FeatureMatching.h>
+#include <companion/algo/recognition/matching/FeatureMatching.h>
+
+#include "CompanionWinRT/native/FeatureVerification.h"
 
 namespace CompanionWinRT
 {
@@ -55,6 +57,41 @@ namespace CompanionWinRT
         RHO = cv::RHO
     };
 
+    /**
+     * Geometric pre-verification types that run before the robust homography estimation.
+     */
+    public enum class PreVerification
+    {
+        NONE,
+        HOUGH_VOTING ///< Keypoint rotation and scale consistency vote.
+    };
+
+    /**
+     * This struct represents the counters of the geometric pre-verification.
+     */
+    public value struct PreVerificationStatistics
+    {
+        /**
+         * Number of distinctive matches before the pre-verification.
+         */
+        int64 matchesBefore;
+
+        /**
+         * Number of matches that passed the pre-verification.
+         */
+        int64 matchesAfter;
+
+        /**
+         * Number of models rejected by the pre-verification before the robust estimation.
+         */
+        int64 rejectedModels;
+
+        /**
+         * Time spent in the pre-verification (in milliseconds).
+         */
+        float64 time;
+    };
+
     /**
      * This class provides a WinRT wrapper for the 'FeatureMatching' functionality of the Companion framework (CPU only).
      *
@@ -96,7 +133,8 @@ namespace CompanionWinRT
              * @param nfeatures             (used by ORB) The maximum number of features to retain
              * @param minSideLength         minimum length of the detected area's sides (in pixels)
              * @param countMatches          how many matches should be found for a good matching result
-             * @param useIRA                indicator to use IRA algorithm to use last detected objects from last scene
+             * @param useIRA                indicator to use IRA algorithm to use last detected objects from last scene (ignored by the
+             *                              native processing of the wrapper, which always verifies recently recognized models first)
              * @param reprojThreshold       homography parameter: maximum allowed reprojection error to treat a point pair as an inlier
              * @param ransacMaxIters        homography parameter: maximum number of RANSAC iterations (2000 is the maximum)
              * @param findHomographyMethod  method used to compute a homography matrix
@@ -109,8 +147,70 @@ namespace CompanionWinRT
              */
             virtual ~FeatureMatching();
 
+            /**
+             * Set the geometric pre-verification. It prunes outliers and rejects hopeless models before the robust homography estimation.
+             *
+             * @param preVerification   geometric pre-verification type
+             */
+            void setPreVerification(PreVerification preVerification);
+
+            /**
+             * Enable or disable the upright mode for targets with a fixed orientation (for example posters on a wall). Keypoints get
+             * a fixed orientation and descriptors are computed with unrotated sampling patterns, which makes descriptors more
+             * distinctive. Recognition is no longer rotation invariant. The mode is only supported by ORB (OpenCV's BRISK always
+             * estimates the keypoint orientation) and doesn't save extraction time: ORB computes the descriptors of the detected
+             * keypoints in a second pass.
+             *
+             * This affects models and scenes alike and has to be set before any model is added ('settings_locked' otherwise,
+             * 'upright_not_supported' for BRISK).
+             *
+             * @param upright   <code>true</code> to enable the upright mode, <code>false</code> to disable it
+             */
+            void setUpright(bool upright);
+
+            /**
+             * Check whether the upright mode is enabled.
+             *
+             * @return <code>true</code> if the upright mode is enabled, <code>false</code> otherwise
+             */
+            bool isUpright();
+
+            /**
+             * Set the number of pyramid levels for models and scenes separately. Building a scale pyramid for every scene frame is
+             * a large part of the extraction cost. Since models are static, their descriptors can be precomputed at several scales
+             * once they are added instead, so scenes can be processed at a single or at fewer pyramid levels.
+             *
+             * This has to be set before any model is added ('settings_locked' otherwise).
+             *
+             * @param modelLevels   number of scales the model descriptors are precomputed at (1 for the original scale only)
+             * @param sceneLevels   number of pyramid levels for scene frames (1 for a single scale)
+             */
+            void setPyramidLevels(int modelLevels, int sceneLevels);
+
+            /**
+             * Return the counters of the geometric pre-verification. The ratio of 'matchesAfter' to 'matchesBefore' approximates the
+             * inlier ratio gained before the robust estimation.
+             *
+             * @return counters of the geometric pre-verification
+             */
+            PreVerificationStatistics getPreVerificationStatistics();
+
+            /**
+             * Reset the counters of the geometric pre-verification.
+             */
+            void resetPreVerificationStatistics();
+
         private:
 
+            /**
+             * Return the key of the scene detector type and parameters, so scene features are shared with feature matchings of equal
+             * settings.
+             *
+             * @param sceneLevels   number of scene pyramid levels (0 for the default pyramid of the detector)
+             * @return key of the scene detector (empty for unknown detectors)
+             */
+            std::string getDetectorKey(int sceneLevels);
+
             /**
              * The native 'FeatureMatching' object of this instance.
              */
@@ -129,6 +229,26 @@ namespace CompanionWinRT
              */
             cv::Ptr<cv::DescriptorMatcher> matcher;
 
+            /**
+             * Type of the feature detector and descriptor extractor.
+             */
+            FeatureDetector detectorType;
+
+            /**
+             * (used by BRISK) AGAST detection threshold score.
+             */
+            int thresh;
+
+            /**
+             * (used by ORB) The maximum number of features to retain.
+             */
+            int nfeatures;
+
+            /**
+             * The native feature verification used by the recognition processing of this wrapper.
+             */
+            Native::FeatureVerification* featureVerificationObj;
+
         internal:
 
             /**
@@ -137,5 +257,12 @@ namespace CompanionWinRT
              * @return pointer to the native 'FeatureMatching' object
              */
             Companion::Algorithm::Recognition::Matching::FeatureMatching* getFeatureMatching();
+
+            /**
+             * Internal method to provide the native 'FeatureVerification' object.
+             *
+             * @return pointer to the native 'FeatureVerification' object
+             */
+            Native::FeatureVerification* getFeatureVerification();
     };
 }
@@ -39,6 +39,22 @@ namespace CompanionWinRT
         int y;
     };
 
+    /**
+     * This strcut represents a point in an image with sub-pixel precision.
+     */
+    public value struct PointF
+    {
+        /**
+         * X-coordinate of this point.
+         */
+        float32 x;
+
+        /**
+         * Y-coordinate of this point.
+         */
+        float32 y;
+    };
+
     /**
      * This class represents a frame around a detected object in an image.
      *
@@ -17,13 +17,13 @@
  */
 
 #include "ImageStream.h"
-#include "CompanionWinRT\utils\CompanionUtils.h"
+#include "CompanionWinRT/utils/CompanionUtils.h"
 
 using namespace CompanionWinRT;
 
 ImageStream::ImageStream(int maxImages)
 {
-    this->imageStreamObj = new Companion::Input::Image(maxImages);
+    this->imageStreamObj = new Native::ImageBuffer(maxImages);
 }
 
 ImageStream::~ImageStream()
@@ -34,15 +34,39 @@ ImageStream::~ImageStream()
 
 bool ImageStream::addImage(Platform::String^ imgPath)
 {
-    return this->imageStreamObj->addImage(Utils::ps2ss(imgPath));
+    if (!this->gate.enter())
+    {
+        return false;
+    }
+
+    bool added = this->imageStreamObj->addImage(Utils::ps2ss(imgPath));
+    this->gate.leave();
+    return added;
 }
 
 bool ImageStream::addImage(int width, int height, int type, const Platform::Array<uint8>^ data)
 {
-    return this->imageStreamObj->addImage(width, height, type, data->Data);
+    if (!this->gate.enter())
+    {
+        return false;
+    }
+
+    bool added = this->imageStreamObj->addImage(width, height, type, data->Data);
+    this->gate.leave();
+    return added;
+}
+
+void ImageStream::setGrayscale(bool grayscale)
+{
+    this->imageStreamObj->setGrayscale(grayscale);
+}
+
+Native::StreamGate* ImageStream::getGate()
+{
+    return &this->gate;
 }
 
-Companion::Input::Image* ImageStream::getImageStream()
+Native::ImageBuffer* ImageStream::getImageStream()
 {
     return this->imageStreamObj;
 }
@@ -18,7 +18,8 @@
 
 #pragma once
 
-#include <companion\input\Image.h>
+#include "CompanionWinRT/native/ImageBuffer.h"
+#include "CompanionWinRT/native/StreamGate.h"
 
 namespace CompanionWinRT
 {
@@ -50,6 +51,9 @@ namespace CompanionWinRT
             /**
              * Load an image that is going to be processed.
              *
+             * Adding an image blocks while the image buffer is full. Once the processing is stopped, blocked and new calls return
+             * <code>false</code> until the processing is started again.
+             *
              * @param imgPath   path of the image that is going to be processed
              * @return <code>true</code> if image was added successfully, <code>false</code> otherwise
              */
@@ -58,6 +62,9 @@ namespace CompanionWinRT
             /**
              * Load an image that is going to be processed.
              *
+             * Adding an image blocks while the image buffer is full. Once the processing is stopped, blocked and new calls return
+             * <code>false</code> until the processing is started again.
+             *
              * @param width     width of the image that is going to be processed
              * @param height    height of the image that is going to be processed
              * @param type      type of the image that is going to be processed (i.e. OpenCV image types)
@@ -66,20 +73,42 @@ namespace CompanionWinRT
              */
             bool addImage(int width, int height, int type, const Platform::Array<uint8>^ data);
 
+            /**
+             * Enable or disable the gray mode. In gray mode images are loaded in gray and color images are converted to gray once when
+             * they are added, so gray image processing algorithms take the frames without any conversion. Gray images (CV_8UC1) are
+             * buffered as they are in both modes. Result images are converted into the color format of the result callback, only
+             * <code>ColorFormat::GRAY</code> returns the gray frames without a conversion.
+             *
+             * @param grayscale <code>true</code> to enable the gray mode, <code>false</code> to disable it
+             */
+            void setGrayscale(bool grayscale);
+
         private:
 
             /**
              * The native 'ImageStream' object of this instance.
              */
-            Companion::Input::Image* imageStreamObj;
+            Native::ImageBuffer* imageStreamObj;
+
+            /**
+             * Gate of the producers of this stream.
+             */
+            Native::StreamGate gate;
 
         internal:
 
+            /**
+             * Internal method to provide the gate of the producers of this stream.
+             *
+             * @return Pointer to the gate of the producers of this stream
+             */
+            Native::StreamGate* getGate();
+
             /**
              * Internal method to provide the native 'ImageStream' object.
              *
              * @return Pointer to the native 'ImageStream' object
              */
-            Companion::Input::Image* getImageStream();
+            Native::ImageBuffer* getImageStream();
     };
 }
@@ -0,0 +1,65 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "NetworkStream.h"
+#include "CompanionWinRT/utils/CompanionError.h"
+#include "CompanionWinRT/utils/CompanionUtils.h"
+
+using namespace CompanionWinRT;
+
+NetworkStream::NetworkStream(ImageStream^ stream, Platform::String^ host, int port, Platform::String^ path, StreamProtocol protocol, int decodeThreads)
+{
+    if ((stream != nullptr) && (host != nullptr))
+    {
+        this->stream = stream;
+        Native::NetworkProtocol nativeProtocol = (protocol == StreamProtocol::MJPEG) ? Native::NetworkProtocol::MJPEG : Native::NetworkProtocol::RAW;
+        this->networkStreamObj = new Native::NetworkSource(this->stream->getImageStream(), this->stream->getGate(), Utils::ps2ss(host), port,
+                                                           (path != nullptr) ? Utils::ps2ss(path) : "/", nativeProtocol, decodeThreads);
+    }
+    else
+    {
+        int hresult = static_cast<int>(ErrorCode::handle_is_null);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+NetworkStream::~NetworkStream()
+{
+    delete this->networkStreamObj;
+    this->networkStreamObj = nullptr;
+}
+
+bool NetworkStream::start()
+{
+    return this->networkStreamObj->start();
+}
+
+void NetworkStream::stop()
+{
+    this->networkStreamObj->stop();
+}
+
+uint64 NetworkStream::getReceivedFrames()
+{
+    return this->networkStreamObj->getReceived();
+}
+
+uint64 NetworkStream::getDroppedFrames()
+{
+    return this->networkStreamObj->getDropped();
+}
@@ -0,0 +1,104 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+#include "CompanionWinRT/input/ImageStream.h"
+#include "CompanionWinRT/native/NetworkSource.h"
+
+namespace CompanionWinRT
+{
+    /**
+     * Wire protocols of a network stream.
+     */
+    public enum class StreamProtocol
+    {
+        MJPEG, ///< Multipart MJPEG over HTTP, as served by most IP cameras.
+        RAW ///< Length-prefixed frames: payload length, width, height and OpenCV type as unsigned 32-bit big endian integers, followed by the payload (width and height 0 for encoded payloads).
+    };
+
+    /**
+     * This class receives frames from an IP camera or frame server and adds them to an image stream in native code, so frames don't
+     * have to be fetched in managed code and passed to 'ImageStream::addImage' one by one.
+     *
+     * Frames are decoded on a pool of decoder threads. Frames that arrive while all decoders are busy or while the image stream is
+     * full are dropped, so the stream stays live when the processing is saturated.
+     *
+     * @author Dimitri Kotlovsky, Andreas Sekulski
+     */
+    public ref class NetworkStream sealed
+    {
+        public:
+
+            /**
+             * Create a 'NetworkStream' wrapper.
+             *
+             * @param stream        image stream the received frames are added to
+             * @param host          host name or address of the camera or frame server
+             * @param port          TCP port of the camera or frame server
+             * @param path          request path of the MJPEG stream (ignored for raw frames)
+             * @param protocol      wire protocol of the camera or frame server
+             * @param decodeThreads number of decoder threads
+             */
+            NetworkStream(ImageStream^ stream, Platform::String^ host, int port, Platform::String^ path, StreamProtocol protocol, int decodeThreads);
+
+            /**
+             * Destruct this instance.
+             */
+            virtual ~NetworkStream();
+
+            /**
+             * Connect to the camera or frame server and start receiving frames.
+             *
+             * @return <code>true</code> if the connection was established, <code>false</code> otherwise
+             */
+            bool start();
+
+            /**
+             * Disconnect from the camera or frame server.
+             */
+            void stop();
+
+            /**
+             * Return the number of received frames.
+             *
+             * @return number of received frames
+             */
+            uint64 getReceivedFrames();
+
+            /**
+             * Return the number of dropped frames.
+             *
+             * @return number of dropped frames
+             */
+            uint64 getDroppedFrames();
+
+        private:
+
+            /**
+             * The native 'NetworkSource' object of this instance.
+             */
+            Native::NetworkSource* networkStreamObj;
+
+            /**
+             * A handle to the image stream the received frames are added to.
+             */
+            ImageStream^ stream;
+    };
+}
@@ -17,8 +17,9 @@
  */
 
 #include "FeatureMatchingModel.h"
-#include "CompanionWinRT\utils\CompanionUtils.h"
-#include "CompanionWinRT\utils\CompanionError.h"
+#include "CompanionWinRT/utils/CompanionUtils.h"
+#include "CompanionWinRT/utils/CompanionError.h"
+#include "CompanionWinRT/native/MemoryAccount.h"
 
 using namespace CompanionWinRT;
 
@@ -30,6 +31,7 @@ FeatureMatchingModel::FeatureMatchingModel(Platform::String^ imagePath, int id)
         this->imageModel = cv::imread(Utils::ps2ss(imagePath), cv::IMREAD_GRAYSCALE);
         this->featureMatchingModelObj->setImage(this->imageModel);
         this->featureMatchingModelObj->setID(id);
+        Native::MemoryAccount::get(Native::MemoryComponent::MODEL_IMAGES).add(Native::MemoryAccount::getBytes(this->imageModel));
     }
     else
     {
@@ -40,6 +42,7 @@ FeatureMatchingModel::FeatureMatchingModel(Platform::String^ imagePath, int id)
 
 FeatureMatchingModel::~FeatureMatchingModel()
 {
+    Native::MemoryAccount::get(Native::MemoryComponent::MODEL_IMAGES).add(-Native::MemoryAccount::getBytes(this->imageModel));
     delete this->featureMatchingModelObj;
     this->featureMatchingModelObj = nullptr;
 }
@@ -48,3 +51,8 @@ Companion::Model::Processing::FeatureMatchingModel* FeatureMatchingModel::getFea
 {
     return this->featureMatchingModelObj;
 }
+
+cv::Mat FeatureMatchingModel::getImage()
+{
+    return this->imageModel;
+}
@@ -18,8 +18,8 @@
 
 #pragma once
 
-#include <opencv2\imgcodecs\imgcodecs.hpp>
-#include <companion\model\processing\FeatureMatchingModel.h>
+#include <opencv2/imgcodecs/imgcodecs.hpp>
+#include <companion/model/processing/FeatureMatchingModel.h>
 
 namespace CompanionWinRT
 {
@@ -65,5 +65,12 @@ namespace CompanionWinRT
              * @return pointer to the native 'FeatureMatchingModel' object
              */
             Companion::Model::Processing::FeatureMatchingModel* getFeatureMatchingModel();
+
+            /**
+             * Internal method to provide the gray scale image of this model.
+             *
+             * @return gray scale image of this model
+             */
+            cv::Mat getImage();
     };
 }
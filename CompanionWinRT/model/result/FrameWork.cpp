@@ -0,0 +1,47 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "FrameWork.h"
+
+using namespace CompanionWinRT;
+
+FrameWork::FrameWork(const Native::FrameWork& work) : totals(toCounters(work)),
+    models(ref new Platform::Array<ModelWork>(static_cast<unsigned int>(work.models.size())))
+{
+    for (unsigned int i = 0; i < this->models->Length; i++)
+    {
+        const Native::ModelWork& model = work.models[i];
+        this->models[i] = ModelWork{ model.id, model.descriptorsMatched, model.rawMatches, model.filteredMatches, model.ransacIterations, model.inliers };
+    }
+}
+
+WorkCounters FrameWork::getTotals()
+{
+    return this->totals;
+}
+
+Platform::Array<ModelWork>^ FrameWork::getModels()
+{
+    return this->models;
+}
+
+WorkCounters FrameWork::toCounters(const Native::FrameWork& work)
+{
+    return WorkCounters{ work.sceneKeypoints, work.descriptorsMatched, work.rawMatches, work.filteredMatches, work.ransacIterations,
+                         work.inliers, work.contoursFound, work.contoursFiltered, work.hashCandidates, work.verifiedModels };
+}
@@ -0,0 +1,80 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "CompanionWinRT/model/statistics/WorkStatistics.h"
+#include "CompanionWinRT/native/WorkCounter.h"
+
+namespace CompanionWinRT
+{
+    /**
+     * This class represents the algorithm-level work of the frame a result was recognized in. All results of a frame share the
+     * same work, so the work counts the frame and not the single result.
+     *
+     * @author Dimitri Kotlovsky, Andreas Sekulski
+     */
+    public ref class FrameWork sealed
+    {
+        public:
+
+            /**
+             * Return the work of the frame summed over all verified models.
+             *
+             * @return work counters of the frame
+             */
+            WorkCounters getTotals();
+
+            /**
+             * Return the work of every model verified in this process. Models verified by shard processes are only part of the
+             * totals.
+             *
+             * @return work of the verified models in the order of verification
+             */
+            Platform::Array<ModelWork>^ getModels();
+
+        internal:
+
+            /**
+             * Create a 'FrameWork' object.
+             *
+             * @param work  native work of the frame
+             */
+            FrameWork(const Native::FrameWork& work);
+
+            /**
+             * Convert native work counters into an ABI friendly value struct.
+             *
+             * @param work  native work (per model work is ignored)
+             * @return work counters
+             */
+            static WorkCounters toCounters(const Native::FrameWork& work);
+
+        private:
+
+            /**
+             * Work of the frame summed over all verified models.
+             */
+            WorkCounters totals;
+
+            /**
+             * Work of every model verified in this process.
+             */
+            Platform::Array<ModelWork>^ models;
+    };
+}
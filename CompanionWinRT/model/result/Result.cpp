@@ -20,7 +20,8 @@
 
 using namespace CompanionWinRT;
 
-Result::Result(ResultType resultType, Frame^ frame, int id, Platform::String^ objectType, int score) : resultType(resultType), frame(frame), id(id), objectType(objectType), score(score)
+Result::Result(ResultType resultType, Frame^ frame, int id, Platform::String^ objectType, int score) : resultType(resultType), frame(frame), id(id), objectType(objectType), score(score),
+    crop(ref new Platform::Array<uint8>(0)), homography(ref new Platform::Array<float64>(0)), corners(ref new Platform::Array<PointF>(0)), work(nullptr)
 {
 }
 
@@ -52,3 +53,39 @@ int Result::getID()
 {
     return this->id;
 }
+
+Platform::Array<uint8>^ Result::getCrop()
+{
+    return this->crop;
+}
+
+void Result::setCrop(Platform::Array<uint8>^ crop)
+{
+    this->crop = crop;
+}
+
+Platform::Array<float64>^ Result::getHomography()
+{
+    return this->homography;
+}
+
+Platform::Array<PointF>^ Result::getCorners()
+{
+    return this->corners;
+}
+
+void Result::setPose(Platform::Array<float64>^ homography, Platform::Array<PointF>^ corners)
+{
+    this->homography = homography;
+    this->corners = corners;
+}
+
+FrameWork^ Result::getWork()
+{
+    return this->work;
+}
+
+void Result::setWork(FrameWork^ work)
+{
+    this->work = work;
+}
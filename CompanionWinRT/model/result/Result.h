@@ -19,7 +19,8 @@
  /// @file
 #pragma once
 
-#include "CompanionWinRT\draw\Frame.h"
+#include "CompanionWinRT/draw/Frame.h"
+#include "CompanionWinRT/model/result/FrameWork.h"
 
 namespace CompanionWinRT
 {
@@ -136,6 +137,39 @@ namespace CompanionWinRT
              */
             int getID();
 
+            /**
+             * Return the rectified crop of the detected or recognized object, see 'Configuration::setResultCrops'. The crop has the
+             * requested crop size and the color format of the result callback.
+             *
+             * @return image data of the rectified crop (empty if no crops are requested)
+             */
+            Platform::Array<uint8>^ getCrop();
+
+            /**
+             * Return the estimated homography of the recognized object, which maps model image coordinates to frame coordinates (for
+             * markers, the unit square of the marker). Overlays can be rendered with it directly instead of re-estimating it from
+             * the frame corners.
+             *
+             * @return the 3x3 homography in row-major order (empty if the processing doesn't estimate a homography)
+             */
+            Platform::Array<float64>^ getHomography();
+
+            /**
+             * Return the corners of the detected or recognized object with sub-pixel precision. The corners of 'getFrame' are
+             * rounded to pixels.
+             *
+             * @return sub-pixel corners (upper left, upper right, lower right, lower left, empty if the processing provides none)
+             */
+            Platform::Array<PointF>^ getCorners();
+
+            /**
+             * Return the algorithm-level work of the frame this result was recognized in. All results of a frame share the same
+             * work, frames without pose results report it through 'Configuration::setFrameWorkCallback'.
+             *
+             * @return work of the frame (<code>nullptr</code> if the processing doesn't count its work)
+             */
+            FrameWork^ getWork();
+
         private:
 
             /**
@@ -166,5 +200,49 @@ namespace CompanionWinRT
              * We can not mirror the plausible abstract class 'Result' for this wrapper.
              */
             int id;
+
+            /**
+             * Image data of the rectified crop.
+             */
+            Platform::Array<uint8>^ crop;
+
+            /**
+             * Homography from model to frame coordinates in row-major order.
+             */
+            Platform::Array<float64>^ homography;
+
+            /**
+             * Corners with sub-pixel precision.
+             */
+            Platform::Array<PointF>^ corners;
+
+            /**
+             * Algorithm-level work of the frame.
+             */
+            FrameWork^ work;
+
+        internal:
+
+            /**
+             * Set the rectified crop of the detected or recognized object.
+             *
+             * @param crop  image data of the rectified crop
+             */
+            void setCrop(Platform::Array<uint8>^ crop);
+
+            /**
+             * Set the estimated pose of the recognized object.
+             *
+             * @param homography    homography from model to frame coordinates in row-major order
+             * @param corners       sub-pixel corners (upper left, upper right, lower right, lower left)
+             */
+            void setPose(Platform::Array<float64>^ homography, Platform::Array<PointF>^ corners);
+
+            /**
+             * Set the algorithm-level work of the frame this result was recognized in.
+             *
+             * @param work  work of the frame
+             */
+            void setWork(FrameWork^ work);
     };
 }
\ No newline at end of file
@@ -0,0 +1,71 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "Histogram.h"
+
+using namespace CompanionWinRT;
+
+Histogram::Histogram(const Native::HistogramSnapshot& snapshot)
+    : snapshot(snapshot)
+{
+}
+
+uint64 Histogram::getCount()
+{
+    return this->snapshot.count;
+}
+
+float64 Histogram::getMean()
+{
+    return (this->snapshot.count > 0) ? (this->snapshot.sum / 1000.0) / this->snapshot.count : 0.0;
+}
+
+float64 Histogram::getMax()
+{
+    return this->snapshot.max / 1000.0;
+}
+
+float64 Histogram::getPercentile(float64 rank)
+{
+    if (this->snapshot.count == 0)
+    {
+        return 0.0;
+    }
+
+    uint64_t target = static_cast<uint64_t>(std::ceil(std::min(1.0, std::max(0.0, rank)) * this->snapshot.count));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < this->snapshot.buckets.size(); i++)
+    {
+        seen += this->snapshot.buckets[i];
+        if ((seen >= target) && (seen > 0))
+        {
+            // Upper bound of the bucket, but never above the longest duration
+            return std::min(static_cast<double>(1ULL << i), static_cast<double>(this->snapshot.max)) / 1000.0;
+        }
+    }
+
+    return this->getMax();
+}
+
+Platform::Array<uint64>^ Histogram::getBuckets()
+{
+    return ref new Platform::Array<uint64>(this->snapshot.buckets.data(), static_cast<unsigned int>(this->snapshot.buckets.size()));
+}
@@ -0,0 +1,99 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+#include "CompanionWinRT/native/LatencyHistogram.h"
+
+namespace CompanionWinRT
+{
+    /**
+     * Points of the processing where frames or threads wait.
+     */
+    public enum class LatencyStage
+    {
+        IMAGE_ADD, ///< Time a producer waits in 'ImageStream::addImage' for space in the image buffer.
+        IMAGE_QUEUE, ///< Time a frame waits in the image buffer until the processing takes it.
+        MODEL_LOCK_WAIT, ///< Time a thread waits for the lock of the models (contended locks only).
+        MODEL_LOCK_HOLD ///< Time a thread holds the lock of the models.
+    };
+
+    /**
+     * This class represents a histogram of durations with logarithmic buckets. Bucket 0 counts durations below 1 microsecond,
+     * bucket i counts durations from 2^(i-1) to 2^i microseconds (the last bucket counts all longer durations).
+     *
+     * @author Dimitri Kotlovsky, Andreas Sekulski
+     */
+    public ref class Histogram sealed
+    {
+        public:
+
+            /**
+             * Return the number of recorded durations.
+             *
+             * @return number of recorded durations
+             */
+            uint64 getCount();
+
+            /**
+             * Return the mean duration.
+             *
+             * @return mean duration (in milliseconds, 0 if no duration was recorded)
+             */
+            float64 getMean();
+
+            /**
+             * Return the longest duration.
+             *
+             * @return longest duration (in milliseconds)
+             */
+            float64 getMax();
+
+            /**
+             * Return an upper bound of a percentile (the upper bound of the bucket that contains the percentile).
+             *
+             * @param rank  rank of the percentile (0 - 1, for example 0.99)
+             * @return upper bound of the percentile (in milliseconds)
+             */
+            float64 getPercentile(float64 rank);
+
+            /**
+             * Return the number of durations per bucket.
+             *
+             * @return number of durations per bucket
+             */
+            Platform::Array<uint64>^ getBuckets();
+
+        internal:
+
+            /**
+             * Create a 'Histogram' object from the counters of a native histogram.
+             *
+             * @param snapshot  counters of a native histogram
+             */
+            Histogram(const Native::HistogramSnapshot& snapshot);
+
+        private:
+
+            /**
+             * Counters of the histogram.
+             */
+            Native::HistogramSnapshot snapshot;
+    };
+}
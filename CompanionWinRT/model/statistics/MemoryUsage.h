@@ -0,0 +1,47 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+#include "CompanionWinRT/native/MemoryAccount.h"
+
+namespace CompanionWinRT
+{
+    /**
+     * Components whose memory is accounted (same order as the native components).
+     */
+    public enum class MemoryComponent
+    {
+        STREAM_BUFFERS, ///< Images waiting in image streams.
+        MODEL_IMAGES, ///< Images kept by models and templates.
+        DESCRIPTORS, ///< Keypoints and descriptors of models.
+        INDEXES, ///< Search structures derived from models (for example cached template spectra).
+        SCRATCH, ///< Per frame working memory of the image processing.
+        RESULT_BUFFERS ///< Result images and crops handed to the result callback and shared memory result rings.
+    };
+
+    /**
+     * Current and peak memory of a component.
+     */
+    public value struct MemoryUsage
+    {
+        int64 current; ///< Current number of bytes.
+        int64 peak; ///< Peak number of bytes since the start of the application or the last reset.
+    };
+}
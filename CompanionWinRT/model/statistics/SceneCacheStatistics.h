@@ -0,0 +1,34 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+namespace CompanionWinRT
+{
+    /**
+     * Hits and misses of the scene feature cache, which shares the scene features of a frame region between processors with equal
+     * feature matching settings.
+     */
+    public value struct SceneCacheStatistics
+    {
+        uint64 hits; ///< Number of scene extractions served from the cache.
+        uint64 misses; ///< Number of scene extractions that had to be computed.
+        float64 hitRate; ///< Share of the extractions served from the cache (0 - 1).
+    };
+}
@@ -0,0 +1,62 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+namespace CompanionWinRT
+{
+    /**
+     * Algorithm-level work counters, summed over all verified models (for example of a frame).
+     */
+    public value struct WorkCounters
+    {
+        int64 sceneKeypoints; ///< Number of extracted scene keypoints.
+        int64 descriptorsMatched; ///< Number of model descriptors matched against the scene.
+        int64 rawMatches; ///< Number of distinctive matches (Lowe's ratio test).
+        int64 filteredMatches; ///< Number of matches passed to the robust estimation (after the geometric pre-verification).
+        int64 ransacIterations; ///< Number of robust estimation iterations, estimated from the inlier ratio.
+        int64 inliers; ///< Number of inliers of the estimated homographies.
+        int64 contoursFound; ///< Number of contours (shapes) found by the shape detection.
+        int64 contoursFiltered; ///< Number of contours left after filtering by the region mask.
+        int64 hashCandidates; ///< Number of hash candidates evaluated.
+        int64 verifiedModels; ///< Number of verified models.
+    };
+
+    /**
+     * Algorithm-level work of a single model verification.
+     */
+    public value struct ModelWork
+    {
+        int32 id; ///< The ID of the verified model.
+        int32 descriptorsMatched; ///< Number of model descriptors matched against the scene.
+        int32 rawMatches; ///< Number of distinctive matches (Lowe's ratio test).
+        int32 filteredMatches; ///< Number of matches passed to the robust estimation.
+        int32 ransacIterations; ///< Number of robust estimation iterations, estimated from the inlier ratio.
+        int32 inliers; ///< Number of inliers of the estimated homography.
+    };
+
+    /**
+     * Algorithm-level work aggregated over all processed frames of the process.
+     */
+    public value struct WorkStatistics
+    {
+        uint64 frames; ///< Number of processed frames.
+        WorkCounters totals; ///< Sum of the work of all frames.
+    };
+}
@@ -0,0 +1,138 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+
+#include "BitSelection.h"
+
+using namespace CompanionWinRT::Native;
+
+/**
+ * Maximum number of descriptors used to estimate bit statistics.
+ */
+static const int MAX_SAMPLES = 2000;
+
+/**
+ * Maximum absolute correlation between a candidate bit and an already selected bit.
+ */
+static const float MAX_CORRELATION = 0.2f;
+
+void BitSelection::select(const cv::Mat& descriptors, int bits)
+{
+    this->bits.clear();
+
+    int totalBits = descriptors.cols * 8;
+    int count = std::min(totalBits, (bits / 8) * 8);
+    if (descriptors.empty() || (descriptors.type() != CV_8U) || (count <= 0))
+    {
+        return;
+    }
+
+    // Unpack a sample of the descriptors to one column per bit
+    int step = std::max(1, descriptors.rows / MAX_SAMPLES);
+    int samples = descriptors.rows / step;
+    cv::Mat_<float> unpacked(samples, totalBits);
+    for (int i = 0; i < samples; i++)
+    {
+        const uchar* row = descriptors.ptr<uchar>(i * step);
+        for (int bit = 0; bit < totalBits; bit++)
+        {
+            unpacked(i, bit) = static_cast<float>((row[bit / 8] >> (7 - bit % 8)) & 1);
+        }
+    }
+
+    // Center all bit columns and order the bits by their information (mean close to 0.5)
+    std::vector<int> order(totalBits);
+    std::vector<float> deviations(totalBits);
+    std::vector<float> means(totalBits);
+    for (int bit = 0; bit < totalBits; bit++)
+    {
+        means[bit] = static_cast<float>(cv::mean(unpacked.col(bit))[0]);
+        unpacked.col(bit) -= means[bit];
+        deviations[bit] = static_cast<float>(cv::norm(unpacked.col(bit)));
+        order[bit] = bit;
+    }
+    std::stable_sort(order.begin(), order.end(), [&means](int a, int b)
+    {
+        return std::abs(means[a] - 0.5f) < std::abs(means[b] - 0.5f);
+    });
+
+    // Greedily select informative bits that are not correlated to already selected bits
+    std::vector<bool> selected(totalBits, false);
+    for (size_t i = 0; (i < order.size()) && (static_cast<int>(this->bits.size()) < count); i++)
+    {
+        int candidate = order[i];
+        if (deviations[candidate] <= 0.0f)
+        {
+            continue;
+        }
+
+        bool correlated = false;
+        for (size_t j = 0; (j < this->bits.size()) && !correlated; j++)
+        {
+            float correlation = static_cast<float>(unpacked.col(candidate).dot(unpacked.col(this->bits[j]))) / (deviations[candidate] * deviations[this->bits[j]]);
+            correlated = std::abs(correlation) > MAX_CORRELATION;
+        }
+
+        if (!correlated)
+        {
+            this->bits.push_back(candidate);
+            selected[candidate] = true;
+        }
+    }
+
+    // Fill up with the most informative remaining bits if the catalog is too small to find enough uncorrelated bits
+    for (size_t i = 0; (i < order.size()) && (static_cast<int>(this->bits.size()) < count); i++)
+    {
+        if (!selected[order[i]])
+        {
+            this->bits.push_back(order[i]);
+            selected[order[i]] = true;
+        }
+    }
+}
+
+void BitSelection::clear()
+{
+    this->bits.clear();
+}
+
+bool BitSelection::isEmpty() const
+{
+    return this->bits.empty();
+}
+
+void BitSelection::compact(const cv::Mat& descriptors, cv::Mat& compactDescriptors) const
+{
+    compactDescriptors = cv::Mat::zeros(descriptors.rows, static_cast<int>(this->bits.size()) / 8, CV_8U);
+
+    for (int i = 0; i < descriptors.rows; i++)
+    {
+        const uchar* row = descriptors.ptr<uchar>(i);
+        uchar* compactRow = compactDescriptors.ptr<uchar>(i);
+        for (size_t j = 0; j < this->bits.size(); j++)
+        {
+            int bit = this->bits[j];
+            if ((row[bit / 8] >> (7 - bit % 8)) & 1)
+            {
+                compactRow[j / 8] |= static_cast<uchar>(1 << (7 - j % 8));
+            }
+        }
+    }
+}
@@ -0,0 +1,77 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class selects the most informative and least correlated bits of binary descriptors and packs descriptors to compact
+         * descriptors made of the selected bits only.
+         *
+         * A bit is informative if it is set for about half of the descriptors of a catalog. Bits are chosen greedily by their
+         * information and skipped if they are strongly correlated to an already selected bit.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class BitSelection
+        {
+            public:
+
+                /**
+                 * Select bits over the given descriptors.
+                 *
+                 * @param descriptors   binary descriptors of the catalog (one row per descriptor)
+                 * @param bits          number of bits to select (rounded down to whole bytes)
+                 */
+                void select(const cv::Mat& descriptors, int bits);
+
+                /**
+                 * Remove the bit selection.
+                 */
+                void clear();
+
+                /**
+                 * Check whether bits are selected.
+                 *
+                 * @return <code>true</code> if no bits are selected, <code>false</code> otherwise
+                 */
+                bool isEmpty() const;
+
+                /**
+                 * Pack descriptors to compact descriptors made of the selected bits.
+                 *
+                 * @param descriptors           binary descriptors (one row per descriptor)
+                 * @param compactDescriptors    compact descriptors (one row per descriptor)
+                 */
+                void compact(const cv::Mat& descriptors, cv::Mat& compactDescriptors) const;
+
+            private:
+
+                /**
+                 * Indices of the selected bits.
+                 */
+                std::vector<int> bits;
+        };
+    }
+}
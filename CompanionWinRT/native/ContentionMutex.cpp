@@ -0,0 +1,68 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ContentionMutex.h"
+
+using namespace CompanionWinRT::Native;
+
+void ContentionMutex::lock()
+{
+    if (!this->mutex.try_lock())
+    {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        this->mutex.lock();
+        this->locked = std::chrono::steady_clock::now();
+        this->waitTimes.record(this->locked - start);
+        return;
+    }
+
+    this->locked = std::chrono::steady_clock::now();
+}
+
+bool ContentionMutex::try_lock()
+{
+    if (!this->mutex.try_lock())
+    {
+        return false;
+    }
+
+    this->locked = std::chrono::steady_clock::now();
+    return true;
+}
+
+void ContentionMutex::unlock()
+{
+    this->holdTimes.record(std::chrono::steady_clock::now() - this->locked);
+    this->mutex.unlock();
+}
+
+const LatencyHistogram& ContentionMutex::getWaitTimes() const
+{
+    return this->waitTimes;
+}
+
+const LatencyHistogram& ContentionMutex::getHoldTimes() const
+{
+    return this->holdTimes;
+}
+
+void ContentionMutex::resetTimes()
+{
+    this->waitTimes.reset();
+    this->holdTimes.reset();
+}
@@ -0,0 +1,99 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <mutex>
+
+#include "CompanionWinRT/native/LatencyHistogram.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class is a mutex that records how long threads wait for it and how long they hold it. It can be used with
+         * 'std::lock_guard' and 'std::unique_lock' like a 'std::mutex'.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class ContentionMutex
+        {
+            public:
+
+                /**
+                 * Lock the mutex and record the wait time if the mutex was held by another thread.
+                 */
+                void lock();
+
+                /**
+                 * Try to lock the mutex without waiting.
+                 *
+                 * @return <code>true</code> if the mutex was locked, <code>false</code> otherwise
+                 */
+                bool try_lock();
+
+                /**
+                 * Unlock the mutex and record the hold time.
+                 */
+                void unlock();
+
+                /**
+                 * Return the histogram of the wait times (contended locks only).
+                 *
+                 * @return histogram of the wait times
+                 */
+                const LatencyHistogram& getWaitTimes() const;
+
+                /**
+                 * Return the histogram of the hold times.
+                 *
+                 * @return histogram of the hold times
+                 */
+                const LatencyHistogram& getHoldTimes() const;
+
+                /**
+                 * Reset both histograms.
+                 */
+                void resetTimes();
+
+            private:
+
+                /**
+                 * The underlying mutex.
+                 */
+                std::mutex mutex;
+
+                /**
+                 * Point in time the mutex was locked (only accessed by the owner).
+                 */
+                std::chrono::steady_clock::time_point locked;
+
+                /**
+                 * Histogram of the wait times.
+                 */
+                LatencyHistogram waitTimes;
+
+                /**
+                 * Histogram of the hold times.
+                 */
+                LatencyHistogram holdTimes;
+        };
+    }
+}
@@ -0,0 +1,70 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include "DetectionProcessing.h"
+
+using namespace CompanionWinRT::Native;
+
+DetectionProcessing::DetectionProcessing(Companion::Algorithm::Detection::ShapeDetection* shapeDetection)
+{
+    this->objectDetection = new Companion::Processing::Detection::ObjectDetection(shapeDetection);
+}
+
+DetectionProcessing::~DetectionProcessing()
+{
+    delete this->objectDetection;
+    this->objectDetection = nullptr;
+}
+
+void DetectionProcessing::setRegionMask(const cv::Mat& mask)
+{
+    this->regionMask.set(mask);
+}
+
+std::vector<Companion::Model::Result::Result*> DetectionProcessing::execute(cv::Mat frame)
+{
+    this->work.begin();
+    // Only the bounds of the processed region are searched
+    cv::Rect bounds = this->regionMask.getBounds(frame.size());
+    std::vector<Companion::Model::Result::Result*> results;
+    if (bounds.area() > 0)
+    {
+        results = this->objectDetection->execute(frame(bounds));
+    }
+    size_t found = results.size();
+
+    // Shapes in excluded parts of the bounds or along the boundary of the processed region are dropped
+    size_t included = 0;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        if (this->regionMask.isIncluded(RegionMask::getPolygon(results[i], bounds.tl()), frame.size()))
+        {
+            results[included++] = RegionMask::toFrame(results[i], bounds.tl());
+        }
+        else
+        {
+            delete results[i];
+        }
+    }
+    results.resize(included);
+    this->work.addContours(found, included);
+
+    this->work.finish(results);
+    return results;
+}
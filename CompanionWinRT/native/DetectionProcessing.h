@@ -0,0 +1,88 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <companion/algo/detection/ShapeDetection.h>
+#include <companion/processing/ImageProcessing.h>
+#include <companion/processing/detection/ObjectDetection.h>
+
+#include "CompanionWinRT/native/RegionMask.h"
+#include "CompanionWinRT/native/WorkCounter.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class runs a native object detection on the processed region of the camera view. Only the bounds of the processed
+         * region are searched for contours.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class DetectionProcessing : public Companion::Processing::ImageProcessing
+        {
+            public:
+
+                /**
+                 * Create a 'DetectionProcessing' object.
+                 *
+                 * @param shapeDetection    native shape detection
+                 */
+                DetectionProcessing(Companion::Algorithm::Detection::ShapeDetection* shapeDetection);
+
+                /**
+                 * Destruct this instance.
+                 */
+                virtual ~DetectionProcessing();
+
+                /**
+                 * Set a static region mask. The shape detection searches the bounds of the processed region only, and shapes with a
+                 * corner outside the processed region or on its boundary are not reported.
+                 *
+                 * @param mask  8-bit mask with non-zero pixels for processed regions (empty to process the whole frame)
+                 */
+                void setRegionMask(const cv::Mat& mask);
+
+                /**
+                 * Detect objects in the given frame.
+                 *
+                 * @param frame frame to process
+                 * @return detection results inside the processed region
+                 */
+                virtual std::vector<Companion::Model::Result::Result*> execute(cv::Mat frame) override;
+
+            private:
+
+                /**
+                 * Native object detection.
+                 */
+                Companion::Processing::Detection::ObjectDetection* objectDetection;
+
+                /**
+                 * Static region mask of the camera view.
+                 */
+                RegionMask regionMask;
+
+                /**
+                 * Work counters of the current frame.
+                 */
+                WorkCounter work;
+        };
+    }
+}
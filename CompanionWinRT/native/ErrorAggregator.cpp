@@ -0,0 +1,124 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <vector>
+
+#include "ErrorAggregator.h"
+
+using namespace CompanionWinRT::Native;
+
+ErrorAggregator::ErrorAggregator(std::function<void(const ErrorEvent&)> dispatch, int interval)
+    : dispatch(dispatch), interval(std::max(0, interval)), stopped(false)
+{
+    this->dispatcher = std::thread(&ErrorAggregator::run, this);
+}
+
+ErrorAggregator::~ErrorAggregator()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->codesMutex);
+        this->stopped = true;
+    }
+    this->codesChanged.notify_all();
+    this->dispatcher.join();
+}
+
+void ErrorAggregator::setInterval(int interval)
+{
+    std::lock_guard<std::mutex> lock(this->codesMutex);
+    this->interval = std::chrono::milliseconds(std::max(0, interval));
+}
+
+void ErrorAggregator::report(int code, uint64_t frame)
+{
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+
+    std::lock_guard<std::mutex> lock(this->codesMutex);
+    CodeState& state = this->codes[code];
+    if (state.pending.count == 0)
+    {
+        state.pending.code = code;
+        state.pending.firstTime = now;
+    }
+    state.pending.count++;
+    state.pending.lastTime = now;
+    state.pending.frame = frame;
+
+    this->codesChanged.notify_one();
+}
+
+void ErrorAggregator::run()
+{
+    std::unique_lock<std::mutex> lock(this->codesMutex);
+    std::vector<ErrorEvent> events;
+
+    while (true)
+    {
+        // Collect all pending events whose interval has passed and find the next point in time an event is due
+        std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+        std::chrono::steady_clock::time_point next = std::chrono::steady_clock::time_point::max();
+        for (std::map<int, CodeState>::iterator it = this->codes.begin(); it != this->codes.end(); ++it)
+        {
+            CodeState& state = it->second;
+            if (state.pending.count == 0)
+            {
+                continue;
+            }
+
+            std::chrono::steady_clock::time_point due = state.dispatched + this->interval;
+            if (this->stopped || (due <= now))
+            {
+                events.push_back(state.pending);
+                state.pending.count = 0;
+                state.dispatched = now;
+            }
+            else
+            {
+                next = std::min(next, due);
+            }
+        }
+
+        if (!events.empty())
+        {
+            // Dispatch without holding the lock, so reporting threads never wait for the callbacks
+            lock.unlock();
+            for (size_t i = 0; i < events.size(); i++)
+            {
+                this->dispatch(events[i]);
+            }
+            events.clear();
+            lock.lock();
+            continue;
+        }
+
+        if (this->stopped)
+        {
+            break;
+        }
+
+        if (next == std::chrono::steady_clock::time_point::max())
+        {
+            this->codesChanged.wait(lock);
+        }
+        else
+        {
+            this->codesChanged.wait_until(lock, next);
+        }
+    }
+}
@@ -0,0 +1,163 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <thread>
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * Coalesced occurrences of an error code.
+         */
+        struct ErrorEvent
+        {
+            /**
+             * Error code.
+             */
+            int code;
+
+            /**
+             * Number of occurrences since the last event of this code.
+             */
+            uint64_t count;
+
+            /**
+             * Time of the first occurrence (in milliseconds since the Unix epoch).
+             */
+            int64_t firstTime;
+
+            /**
+             * Time of the last occurrence (in milliseconds since the Unix epoch).
+             */
+            int64_t lastTime;
+
+            /**
+             * Number of the frame of the last occurrence.
+             */
+            uint64_t frame;
+        };
+
+        /**
+         * This class coalesces reported errors per error code and dispatches them on a background thread, at most one event per
+         * error code and interval. The first occurrence of a code is dispatched right away, further occurrences within the
+         * interval are counted into the next event of this code.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class ErrorAggregator
+        {
+            public:
+
+                /**
+                 * Create an 'ErrorAggregator' object and start its dispatcher thread.
+                 *
+                 * @param dispatch  function that is called with each event on the dispatcher thread
+                 * @param interval  minimum time between two events of the same error code (in milliseconds)
+                 */
+                ErrorAggregator(std::function<void(const ErrorEvent&)> dispatch, int interval);
+
+                /**
+                 * Dispatch pending events, stop the dispatcher thread and destruct this instance.
+                 */
+                ~ErrorAggregator();
+
+                /**
+                 * Set the minimum time between two events of the same error code.
+                 *
+                 * @param interval  minimum time between two events of the same error code (in milliseconds)
+                 */
+                void setInterval(int interval);
+
+                /**
+                 * Report an error. Never blocks on the dispatch.
+                 *
+                 * @param code  error code
+                 * @param frame number of the frame the error occurred in
+                 */
+                void report(int code, uint64_t frame);
+
+            private:
+
+                /**
+                 * State of an error code.
+                 */
+                struct CodeState
+                {
+                    /**
+                     * Pending event (only valid if its count is not 0).
+                     */
+                    ErrorEvent pending;
+
+                    /**
+                     * Point in time the last event of this code was dispatched.
+                     */
+                    std::chrono::steady_clock::time_point dispatched;
+                };
+
+                /**
+                 * Dispatch events until the aggregator is destructed.
+                 */
+                void run();
+
+                /**
+                 * Function that is called with each event.
+                 */
+                std::function<void(const ErrorEvent&)> dispatch;
+
+                /**
+                 * Minimum time between two events of the same error code.
+                 */
+                std::chrono::milliseconds interval;
+
+                /**
+                 * State per error code.
+                 */
+                std::map<int, CodeState> codes;
+
+                /**
+                 * Mutex of the error code states.
+                 */
+                std::mutex codesMutex;
+
+                /**
+                 * Signals new errors and the destruction.
+                 */
+                std::condition_variable codesChanged;
+
+                /**
+                 * Indicator to stop the dispatcher thread.
+                 */
+                bool stopped;
+
+                /**
+                 * Dispatcher thread.
+                 */
+                std::thread dispatcher;
+        };
+    }
+}
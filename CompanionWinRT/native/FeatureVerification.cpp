@@ -0,0 +1,423 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <opencv2/calib3d/calib3d.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "FeatureVerification.h"
+
+using namespace CompanionWinRT::Native;
+
+/**
+ * Lowe's ratio between the best and the second best match of a descriptor.
+ */
+static const float MATCH_RATIO = 0.8f;
+
+/**
+ * Number of compact candidate matches per descriptor that are re-ranked with the full descriptors.
+ */
+static const int RERANK_CANDIDATES = 4;
+
+/**
+ * Number of rotation bins of the Hough voting (30 degrees per bin).
+ */
+static const int ROTATION_BINS = 12;
+
+/**
+ * Number of scale bins of the Hough voting (half an octave per bin, covering a scale change from 1/16 to 16).
+ */
+static const int SCALE_BINS = 16;
+
+/**
+ * Confidence of the robust homography estimation (OpenCV default).
+ */
+static const double ESTIMATION_CONFIDENCE = 0.995;
+
+/**
+ * Estimate the number of iterations of a robust homography estimation like the adaptive stopping criterion of OpenCV.
+ *
+ * @param method    method used to compute the homography
+ * @param maxIters  maximum number of iterations
+ * @param inliers   number of inliers
+ * @param points    number of point pairs
+ * @return estimated number of iterations (0 for the least squares method)
+ */
+static int estimateIterations(int method, int maxIters, int inliers, int points)
+{
+    if ((method == 0) || (points == 0))
+    {
+        return 0;
+    }
+
+    // Least median of squares assumes an outlier ratio of 45%, the sampling methods stop at the ratio of the best model
+    double outlierRatio = (method == cv::LMEDS) ? 0.45 : 1.0 - static_cast<double>(inliers) / points;
+    double numerator = std::log(1.0 - ESTIMATION_CONFIDENCE);
+    double denominator = std::log(1.0 - std::pow(1.0 - outlierRatio, 4.0));
+    if ((denominator >= 0.0) || (-numerator >= maxIters * -denominator))
+    {
+        return maxIters;
+    }
+    return std::max(1, static_cast<int>(std::round(numerator / denominator)));
+}
+
+int64_t Features::getBytes() const
+{
+    return static_cast<int64_t>(this->keypoints.size() * sizeof(cv::KeyPoint) + this->descriptors.total() * this->descriptors.elemSize()
+                                + this->compactDescriptors.total() * this->compactDescriptors.elemSize());
+}
+
+FeatureVerification::FeatureVerification(cv::Ptr<cv::Feature2D> detector, const std::string& detectorKey, cv::Ptr<cv::DescriptorMatcher> matcher, int matcherType,
+                                         int minSideLength, int countMatches, double reprojThreshold, int ransacMaxIters, int findHomographyMethod)
+    : detector(detector), detectorKey(detectorKey), matcher(matcher), matcherType(matcherType), modelLevels(1), modelScaleFactor(1.0), minSideLength(minSideLength), countMatches(countMatches), reprojThreshold(reprojThreshold),
+      ransacMaxIters(ransacMaxIters), findHomographyMethod(findHomographyMethod), houghVoting(false), upright(false), modelsExtracted(false), matchesBefore(0), matchesAfter(0),
+      rejectedModels(0), preVerificationTicks(0)
+{
+}
+
+void FeatureVerification::extract(const cv::Mat& image, Features& features, const cv::Mat& mask)
+{
+    cv::Ptr<cv::Feature2D> detector;
+    {
+        std::lock_guard<std::mutex> lock(this->settingsMutex);
+        detector = this->detector;
+    }
+
+    features.keypoints.clear();
+    features.size = image.size();
+
+    if (this->upright)
+    {
+        // Fix the orientation of all keypoints, so the descriptors are sampled without rotation
+        detector->detect(image, features.keypoints, mask);
+        for (size_t i = 0; i < features.keypoints.size(); i++)
+        {
+            features.keypoints[i].angle = 0.0f;
+        }
+        detector->compute(image, features.keypoints, features.descriptors);
+    }
+    else
+    {
+        detector->detectAndCompute(image, mask, features.keypoints, features.descriptors);
+    }
+}
+
+void FeatureVerification::extractModel(const cv::Mat& image, Features& features)
+{
+    int modelLevels;
+    double modelScaleFactor;
+    {
+        // The first model fixes the extraction settings
+        std::lock_guard<std::mutex> lock(this->settingsMutex);
+        this->modelsExtracted = true;
+        modelLevels = this->modelLevels;
+        modelScaleFactor = this->modelScaleFactor;
+    }
+
+    this->extract(image, features);
+
+    double scale = 1.0;
+    Features levelFeatures;
+    for (int level = 1; level < modelLevels; level++)
+    {
+        scale /= modelScaleFactor;
+        cv::Mat levelImage;
+        cv::resize(image, levelImage, cv::Size(), scale, scale, cv::INTER_AREA);
+        if (std::min(levelImage.cols, levelImage.rows) < this->minSideLength)
+        {
+            break;
+        }
+
+        this->extract(levelImage, levelFeatures);
+        for (size_t i = 0; i < levelFeatures.keypoints.size(); i++)
+        {
+            cv::KeyPoint keypoint = levelFeatures.keypoints[i];
+            keypoint.pt *= 1.0 / scale;
+            keypoint.size *= static_cast<float>(1.0 / scale);
+            keypoint.octave = level;
+            features.keypoints.push_back(keypoint);
+        }
+        features.descriptors.push_back(levelFeatures.descriptors);
+    }
+
+    features.size = image.size();
+}
+
+bool FeatureVerification::setPyramid(cv::Ptr<cv::Feature2D> detector, const std::string& detectorKey, int modelLevels, double modelScaleFactor)
+{
+    std::lock_guard<std::mutex> lock(this->settingsMutex);
+    if (this->modelsExtracted)
+    {
+        return false;
+    }
+
+    this->detector = detector;
+    this->detectorKey = detectorKey;
+    this->modelLevels = std::max(1, modelLevels);
+    this->modelScaleFactor = std::max(1.01, modelScaleFactor);
+    return true;
+}
+
+std::string FeatureVerification::getDetectorKey() const
+{
+    std::lock_guard<std::mutex> lock(this->settingsMutex);
+    if (this->detectorKey.empty())
+    {
+        return this->detectorKey;
+    }
+    return this->upright ? this->detectorKey + "/upright" : this->detectorKey;
+}
+
+VerificationParameters FeatureVerification::getParameters() const
+{
+    VerificationParameters parameters;
+    parameters.matcherType = this->matcherType;
+    parameters.minSideLength = this->minSideLength;
+    parameters.countMatches = this->countMatches;
+    parameters.reprojThreshold = this->reprojThreshold;
+    parameters.ransacMaxIters = this->ransacMaxIters;
+    parameters.findHomographyMethod = this->findHomographyMethod;
+    parameters.houghVoting = this->houghVoting;
+    {
+        std::lock_guard<std::mutex> lock(this->settingsMutex);
+        parameters.modelLevels = this->modelLevels;
+    }
+    return parameters;
+}
+
+bool FeatureVerification::verify(const Features& model, const Features& scene, Verification& verification, bool reRank)
+{
+    verification.descriptorsMatched = 0;
+    verification.rawMatches = 0;
+    verification.filteredMatches = 0;
+    verification.ransacIterations = 0;
+    verification.inliers = 0;
+
+    // Models may only keep their compact descriptors
+    int modelDescriptors = std::max(model.descriptors.rows, model.compactDescriptors.rows);
+    if ((modelDescriptors == 0) || (scene.descriptors.rows < 2))
+    {
+        return false;
+    }
+
+    // Match model descriptors against the scene and keep distinctive matches only
+    std::vector<cv::DMatch> matches;
+    this->match(model, scene, reRank && !model.descriptors.empty(), matches);
+    verification.descriptorsMatched = modelDescriptors;
+    verification.rawMatches = static_cast<int>(matches.size());
+    verification.filteredMatches = static_cast<int>(matches.size());
+
+    if (static_cast<int>(matches.size()) < this->countMatches)
+    {
+        return false;
+    }
+
+    // Prune geometrically inconsistent matches and reject hopeless models before the robust estimation
+    if (this->houghVoting)
+    {
+        int64 start = cv::getTickCount();
+        this->matchesBefore += matches.size();
+        this->filterByHoughVoting(model, scene, matches);
+        this->matchesAfter += matches.size();
+        this->preVerificationTicks += cv::getTickCount() - start;
+        verification.filteredMatches = static_cast<int>(matches.size());
+
+        if (static_cast<int>(matches.size()) < this->countMatches)
+        {
+            this->rejectedModels++;
+            return false;
+        }
+    }
+
+    std::vector<cv::Point2f> modelPoints;
+    std::vector<cv::Point2f> scenePoints;
+    for (size_t i = 0; i < matches.size(); i++)
+    {
+        modelPoints.push_back(model.keypoints[matches[i].queryIdx].pt);
+        scenePoints.push_back(scene.keypoints[matches[i].trainIdx].pt);
+    }
+
+    // Estimate the model pose (OpenCV seeds the RANSAC of every call with a fixed value, so the estimation is reproducible)
+    cv::Mat inliers;
+    cv::Mat homography = cv::findHomography(modelPoints, scenePoints, this->findHomographyMethod, this->reprojThreshold, inliers, this->ransacMaxIters);
+    verification.inliers = homography.empty() ? 0 : cv::countNonZero(inliers);
+    verification.ransacIterations = estimateIterations(this->findHomographyMethod, this->ransacMaxIters, verification.inliers, static_cast<int>(modelPoints.size()));
+    if (homography.empty())
+    {
+        return false;
+    }
+
+    std::vector<cv::Point2f> modelCorners = {
+        cv::Point2f(0.0f, 0.0f),
+        cv::Point2f(static_cast<float>(model.size.width), 0.0f),
+        cv::Point2f(static_cast<float>(model.size.width), static_cast<float>(model.size.height)),
+        cv::Point2f(0.0f, static_cast<float>(model.size.height))
+    };
+    std::vector<cv::Point2f> sceneCorners;
+    cv::perspectiveTransform(modelCorners, sceneCorners, homography);
+
+    if (!this->isPlausible(sceneCorners))
+    {
+        return false;
+    }
+
+    verification.score = (verification.inliers * 100) / static_cast<int>(modelPoints.size());
+    verification.corners = sceneCorners;
+    verification.homography = homography;
+
+    return true;
+}
+
+void FeatureVerification::match(const Features& model, const Features& scene, bool reRank, std::vector<cv::DMatch>& matches) const
+{
+    std::vector<std::vector<cv::DMatch>> knnMatches;
+
+    if (!model.compactDescriptors.empty() && !scene.compactDescriptors.empty())
+    {
+        // Search candidates with the compact descriptors
+        cv::BFMatcher compactMatcher(cv::NORM_HAMMING);
+        compactMatcher.knnMatch(model.compactDescriptors, scene.compactDescriptors, knnMatches, reRank ? RERANK_CANDIDATES : 2);
+
+        if (reRank)
+        {
+            for (size_t i = 0; i < knnMatches.size(); i++)
+            {
+                for (size_t j = 0; j < knnMatches[i].size(); j++)
+                {
+                    cv::DMatch& candidate = knnMatches[i][j];
+                    candidate.distance = static_cast<float>(cv::norm(model.descriptors.row(candidate.queryIdx), scene.descriptors.row(candidate.trainIdx), cv::NORM_HAMMING));
+                }
+                std::sort(knnMatches[i].begin(), knnMatches[i].end());
+            }
+        }
+    }
+    else
+    {
+        this->matcher->knnMatch(model.descriptors, scene.descriptors, knnMatches, 2);
+    }
+
+    for (size_t i = 0; i < knnMatches.size(); i++)
+    {
+        if ((knnMatches[i].size() >= 2) && (knnMatches[i][0].distance < MATCH_RATIO * knnMatches[i][1].distance))
+        {
+            matches.push_back(knnMatches[i][0]);
+        }
+    }
+}
+
+void FeatureVerification::setHoughVoting(bool houghVoting)
+{
+    this->houghVoting = houghVoting;
+}
+
+bool FeatureVerification::setUpright(bool upright)
+{
+    std::lock_guard<std::mutex> lock(this->settingsMutex);
+    if (this->modelsExtracted)
+    {
+        return false;
+    }
+
+    this->upright = upright;
+    return true;
+}
+
+bool FeatureVerification::isUpright() const
+{
+    return this->upright;
+}
+
+PreVerificationStatistics FeatureVerification::getPreVerificationStatistics() const
+{
+    PreVerificationStatistics statistics;
+    statistics.matchesBefore = this->matchesBefore;
+    statistics.matchesAfter = this->matchesAfter;
+    statistics.rejectedModels = this->rejectedModels;
+    statistics.time = (this->preVerificationTicks * 1000.0) / cv::getTickFrequency();
+    return statistics;
+}
+
+void FeatureVerification::resetPreVerificationStatistics()
+{
+    this->matchesBefore = 0;
+    this->matchesAfter = 0;
+    this->rejectedModels = 0;
+    this->preVerificationTicks = 0;
+}
+
+void FeatureVerification::filterByHoughVoting(const Features& model, const Features& scene, std::vector<cv::DMatch>& matches) const
+{
+    std::vector<int> bins(matches.size());
+    std::vector<int> votes(ROTATION_BINS * SCALE_BINS, 0);
+
+    for (size_t i = 0; i < matches.size(); i++)
+    {
+        const cv::KeyPoint& modelKeypoint = model.keypoints[matches[i].queryIdx];
+        const cv::KeyPoint& sceneKeypoint = scene.keypoints[matches[i].trainIdx];
+
+        // Keypoints without orientation (angle -1) vote for no rotation
+        float rotation = ((modelKeypoint.angle < 0.0f) || (sceneKeypoint.angle < 0.0f)) ? 0.0f : sceneKeypoint.angle - modelKeypoint.angle;
+        rotation = std::fmod(rotation + 360.0f, 360.0f);
+        int rotationBin = std::min(ROTATION_BINS - 1, static_cast<int>(rotation * ROTATION_BINS / 360.0f));
+
+        float scale = std::log2(std::max(sceneKeypoint.size, 1.0f) / std::max(modelKeypoint.size, 1.0f));
+        int scaleBin = std::min(SCALE_BINS - 1, std::max(0, static_cast<int>(std::floor(scale * 2.0f)) + SCALE_BINS / 2));
+
+        bins[i] = rotationBin * SCALE_BINS + scaleBin;
+        votes[bins[i]]++;
+    }
+
+    // Find the dominant rotation and scale change
+    int peak = static_cast<int>(std::max_element(votes.begin(), votes.end()) - votes.begin());
+    int peakRotation = peak / SCALE_BINS;
+    int peakScale = peak % SCALE_BINS;
+
+    // Keep matches in the peak bin and its neighbours (rotation is circular)
+    size_t kept = 0;
+    for (size_t i = 0; i < matches.size(); i++)
+    {
+        int rotationDistance = std::abs(bins[i] / SCALE_BINS - peakRotation);
+        rotationDistance = std::min(rotationDistance, ROTATION_BINS - rotationDistance);
+        int scaleDistance = std::abs(bins[i] % SCALE_BINS - peakScale);
+        if ((rotationDistance <= 1) && (scaleDistance <= 1))
+        {
+            matches[kept++] = matches[i];
+        }
+    }
+    matches.resize(kept);
+}
+
+bool FeatureVerification::isPlausible(const std::vector<cv::Point2f>& corners) const
+{
+    if (!cv::isContourConvex(corners))
+    {
+        return false;
+    }
+
+    for (size_t i = 0; i < corners.size(); i++)
+    {
+        cv::Point2f side = corners[(i + 1) % corners.size()] - corners[i];
+        if (std::sqrt(side.dot(side)) < this->minSideLength)
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,434 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <opencv2/core/core.hpp>
+#include <opencv2/features2d/features2d.hpp>
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * Keypoints and descriptors of a model or a scene.
+         */
+        struct Features
+        {
+            /**
+             * Detected keypoints.
+             */
+            std::vector<cv::KeyPoint> keypoints;
+
+            /**
+             * Descriptors of the detected keypoints (one row per keypoint, released for models that only keep compact descriptors).
+             */
+            cv::Mat descriptors;
+
+            /**
+             * Compact descriptors made of selected descriptor bits (empty if no bits are selected).
+             */
+            cv::Mat compactDescriptors;
+
+            /**
+             * Size of the image the features were extracted from.
+             */
+            cv::Size size;
+
+            /**
+             * Return the number of bytes of the keypoints and descriptors.
+             *
+             * @return number of bytes of the keypoints and descriptors
+             */
+            int64_t getBytes() const;
+        };
+
+        /**
+         * Outcome of a model verification. Score and pose are only valid if the model was found, the work counters are always set.
+         */
+        struct Verification
+        {
+            /**
+             * Verification score (0% - 100%).
+             */
+            int score;
+
+            /**
+             * Model corners projected into the scene (upper left, upper right, lower right, lower left).
+             */
+            std::vector<cv::Point2f> corners;
+
+            /**
+             * Estimated homography from model to scene coordinates.
+             */
+            cv::Mat homography;
+
+            /**
+             * Number of model descriptors matched against the scene.
+             */
+            int descriptorsMatched;
+
+            /**
+             * Number of distinctive matches (Lowe's ratio test).
+             */
+            int rawMatches;
+
+            /**
+             * Number of matches passed to the robust estimation (after the geometric pre-verification).
+             */
+            int filteredMatches;
+
+            /**
+             * Number of robust estimation iterations, estimated from the inlier ratio by the adaptive stopping criterion of OpenCV.
+             */
+            int ransacIterations;
+
+            /**
+             * Number of inliers of the estimated homography.
+             */
+            int inliers;
+        };
+
+        /**
+         * Counters of the geometric pre-verification.
+         */
+        struct PreVerificationStatistics
+        {
+            /**
+             * Number of distinctive matches before the pre-verification.
+             */
+            long long matchesBefore;
+
+            /**
+             * Number of matches that passed the pre-verification.
+             */
+            long long matchesAfter;
+
+            /**
+             * Number of models rejected by the pre-verification before the robust estimation.
+             */
+            long long rejectedModels;
+
+            /**
+             * Time spent in the pre-verification (in milliseconds).
+             */
+            double time;
+        };
+
+        /**
+         * Parameters of a model verification that are not part of the detector key.
+         */
+        struct VerificationParameters
+        {
+            /**
+             * OpenCV type of the descriptor matcher ('cv::DescriptorMatcher::MatcherType').
+             */
+            int matcherType;
+
+            /**
+             * Minimum length of the detected area's sides (in pixels).
+             */
+            int minSideLength;
+
+            /**
+             * How many matches should be found for a good matching result.
+             */
+            int countMatches;
+
+            /**
+             * Maximum allowed reprojection error to treat a point pair as an inlier.
+             */
+            double reprojThreshold;
+
+            /**
+             * Maximum number of RANSAC iterations.
+             */
+            int ransacMaxIters;
+
+            /**
+             * Method used to compute a homography matrix.
+             */
+            int findHomographyMethod;
+
+            /**
+             * Number of model pyramid levels.
+             */
+            int modelLevels;
+
+            /**
+             * Indicator that the geometric pre-verification is enabled.
+             */
+            bool houghVoting;
+        };
+
+        /**
+         * This class extracts features and verifies models against a scene by descriptor matching and robust homography estimation.
+         *
+         * It provides the per model verification step for the native recognition processing of this wrapper, so the processing
+         * can decide itself in which order models are verified and when to stop.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class FeatureVerification
+        {
+            public:
+
+                /**
+                 * Create a 'FeatureVerification' object.
+                 *
+                 * @param detector              feature detector and descriptor extractor
+                 * @param detectorKey           key of the detector type and parameters (features of equal keys are shared by the scene
+                 *                              feature cache, empty to never share them)
+                 * @param matcher               descriptor matcher
+                 * @param matcherType           OpenCV type of the descriptor matcher ('cv::DescriptorMatcher::MatcherType')
+                 * @param minSideLength         minimum length of the detected area's sides (in pixels)
+                 * @param countMatches          how many matches should be found for a good matching result
+                 * @param reprojThreshold       homography parameter: maximum allowed reprojection error to treat a point pair as an inlier
+                 * @param ransacMaxIters        homography parameter: maximum number of RANSAC iterations (2000 is the maximum)
+                 * @param findHomographyMethod  method used to compute a homography matrix
+                 */
+                FeatureVerification(cv::Ptr<cv::Feature2D> detector, const std::string& detectorKey, cv::Ptr<cv::DescriptorMatcher> matcher, int matcherType,
+                                    int minSideLength, int countMatches, double reprojThreshold, int ransacMaxIters, int findHomographyMethod);
+
+                /**
+                 * Detect keypoints and compute their descriptors.
+                 *
+                 * @param image     gray scale image
+                 * @param features  extracted features
+                 * @param mask      optional 8-bit mask of the image area to search for keypoints (empty for the whole image)
+                 */
+                void extract(const cv::Mat& image, Features& features, const cv::Mat& mask = cv::Mat());
+
+                /**
+                 * Detect keypoints and compute their descriptors of a model at all model pyramid levels. Keypoints of all levels are
+                 * mapped back to the coordinates of the original model image.
+                 *
+                 * @param image     gray scale model image
+                 * @param features  extracted features of all model pyramid levels
+                 */
+                void extractModel(const cv::Mat& image, Features& features);
+
+                /**
+                 * Move the scale search from the scenes to the models. Scenes are processed with the given detector (which should
+                 * build fewer pyramid levels) and models are extracted at several scales once they are added. The pyramid can't be
+                 * changed once a model was extracted.
+                 *
+                 * @param detector          feature detector and descriptor extractor with reduced pyramid levels
+                 * @param detectorKey       key of the detector type and parameters
+                 * @param modelLevels       number of model pyramid levels (1 for the original scale only)
+                 * @param modelScaleFactor  scale factor between two model pyramid levels (greater than 1)
+                 * @return <code>true</code> if the pyramid was set, <code>false</code> if models were already extracted
+                 */
+                bool setPyramid(cv::Ptr<cv::Feature2D> detector, const std::string& detectorKey, int modelLevels, double modelScaleFactor);
+
+                /**
+                 * Return the key of the scene extraction: the detector type and parameters and the upright mode.
+                 *
+                 * @return key of the scene extraction (empty if features must not be shared)
+                 */
+                std::string getDetectorKey() const;
+
+                /**
+                 * Return the verification parameters that are not part of the detector key.
+                 *
+                 * @return verification parameters
+                 */
+                VerificationParameters getParameters() const;
+
+                /**
+                 * Verify a model against a scene.
+                 *
+                 * If model and scene provide compact descriptors, candidate matches are searched with the compact descriptors.
+                 *
+                 * @param model         model features
+                 * @param scene         scene features
+                 * @param verification  verification outcome (only valid if the model was found)
+                 * @param reRank        <code>true</code> to re-rank compact candidate matches with the full descriptors
+                 * @return <code>true</code> if the model was found in the scene, <code>false</code> otherwise
+                 */
+                bool verify(const Features& model, const Features& scene, Verification& verification, bool reRank = false);
+
+                /**
+                 * Enable or disable the geometric pre-verification. Matches vote for their keypoint rotation and scale change and only
+                 * matches consistent with the dominant vote are passed to the robust homography estimation.
+                 *
+                 * @param houghVoting   <code>true</code> to enable the pre-verification, <code>false</code> to disable it
+                 */
+                void setHoughVoting(bool houghVoting);
+
+                /**
+                 * Enable or disable the upright mode. In upright mode all keypoints get a fixed orientation, so descriptors are computed
+                 * with unrotated sampling patterns for models and scenes alike. The detector has to keep the orientation of provided
+                 * keypoints (ORB does, BRISK always estimates it). The mode can't be changed once a model was extracted.
+                 *
+                 * @param upright   <code>true</code> to enable the upright mode, <code>false</code> to disable it
+                 * @return <code>true</code> if the mode was set, <code>false</code> if models were already extracted
+                 */
+                bool setUpright(bool upright);
+
+                /**
+                 * Check whether the upright mode is enabled.
+                 *
+                 * @return <code>true</code> if the upright mode is enabled, <code>false</code> otherwise
+                 */
+                bool isUpright() const;
+
+                /**
+                 * Return the counters of the geometric pre-verification.
+                 *
+                 * @return counters of the geometric pre-verification
+                 */
+                PreVerificationStatistics getPreVerificationStatistics() const;
+
+                /**
+                 * Reset the counters of the geometric pre-verification.
+                 */
+                void resetPreVerificationStatistics();
+
+            private:
+
+                /**
+                 * Find distinctive matches between model and scene descriptors (Lowe's ratio test).
+                 *
+                 * @param model     model features
+                 * @param scene     scene features
+                 * @param reRank    <code>true</code> to re-rank compact candidate matches with the full descriptors
+                 * @param matches   distinctive matches (query: model, train: scene)
+                 */
+                void match(const Features& model, const Features& scene, bool reRank, std::vector<cv::DMatch>& matches) const;
+
+                /**
+                 * Keep only matches that agree with the dominant rotation and scale change (Hough voting).
+                 *
+                 * @param model     model features
+                 * @param scene     scene features
+                 * @param matches   distinctive matches (query: model, train: scene), filtered in place
+                 */
+                void filterByHoughVoting(const Features& model, const Features& scene, std::vector<cv::DMatch>& matches) const;
+
+                /**
+                 * Check whether the projected model corners form a plausible object.
+                 *
+                 * @param corners   projected model corners
+                 * @return <code>true</code> if the corners form a convex quad with sides of at least the minimum side length
+                 */
+                bool isPlausible(const std::vector<cv::Point2f>& corners) const;
+
+                /**
+                 * Feature detector and descriptor extractor.
+                 */
+                cv::Ptr<cv::Feature2D> detector;
+
+                /**
+                 * Key of the detector type and parameters.
+                 */
+                std::string detectorKey;
+
+                /**
+                 * Mutex of the detector, its key and the model pyramid.
+                 */
+                mutable std::mutex settingsMutex;
+
+                /**
+                 * Descriptor matcher.
+                 */
+                cv::Ptr<cv::DescriptorMatcher> matcher;
+
+                /**
+                 * OpenCV type of the descriptor matcher.
+                 */
+                int matcherType;
+
+                /**
+                 * Number of model pyramid levels.
+                 */
+                int modelLevels;
+
+                /**
+                 * Scale factor between two model pyramid levels.
+                 */
+                double modelScaleFactor;
+
+                /**
+                 * Minimum length of the detected area's sides (in pixels).
+                 */
+                int minSideLength;
+
+                /**
+                 * How many matches should be found for a good matching result.
+                 */
+                int countMatches;
+
+                /**
+                 * Maximum allowed reprojection error to treat a point pair as an inlier.
+                 */
+                double reprojThreshold;
+
+                /**
+                 * Maximum number of RANSAC iterations.
+                 */
+                int ransacMaxIters;
+
+                /**
+                 * Method used to compute a homography matrix.
+                 */
+                int findHomographyMethod;
+
+                /**
+                 * Indicator to use the geometric pre-verification.
+                 */
+                std::atomic<bool> houghVoting;
+
+                /**
+                 * Indicator to use the upright mode.
+                 */
+                std::atomic<bool> upright;
+
+                /**
+                 * Indicator that a model was extracted, which fixes the extraction settings.
+                 */
+                std::atomic<bool> modelsExtracted;
+
+                /**
+                 * Number of distinctive matches before the pre-verification.
+                 */
+                std::atomic<long long> matchesBefore;
+
+                /**
+                 * Number of matches that passed the pre-verification.
+                 */
+                std::atomic<long long> matchesAfter;
+
+                /**
+                 * Number of models rejected by the pre-verification.
+                 */
+                std::atomic<long long> rejectedModels;
+
+                /**
+                 * Time spent in the pre-verification (in ticks).
+                 */
+                std::atomic<long long> preVerificationTicks;
+        };
+    }
+}
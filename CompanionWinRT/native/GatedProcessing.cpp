@@ -0,0 +1,102 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "GatedProcessing.h"
+#include "CompanionWinRT/native/MemoryAccount.h"
+
+using namespace CompanionWinRT::Native;
+
+GatedProcessing::GatedProcessing(Companion::Algorithm::Detection::ShapeDetection* shapeDetection, FeatureVerification* verification, int margin)
+    : RecognitionProcessing(verification), margin(std::max(0, margin))
+{
+    this->objectDetection = new Companion::Processing::Detection::ObjectDetection(shapeDetection);
+}
+
+GatedProcessing::~GatedProcessing()
+{
+    delete this->objectDetection;
+    this->objectDetection = nullptr;
+}
+
+std::vector<Companion::Model::Result::Result*> GatedProcessing::execute(cv::Mat frame)
+{
+    std::vector<Companion::Model::Result::Result*> results;
+    this->work.begin();
+    cv::Rect bounds = this->regionMask.getBounds(frame.size());
+    std::vector<Companion::Model::Result::Result*> shapes;
+    if (bounds.area() > 0)
+    {
+        shapes = this->objectDetection->execute(frame(bounds));
+    }
+
+    // Build the search mask from the detected shapes
+    cv::Mat mask = cv::Mat::zeros(frame.size(), CV_8U);
+    std::vector<std::vector<cv::Point>> polygons;
+    for (size_t i = 0; i < shapes.size(); i++)
+    {
+        std::vector<cv::Point> polygon = RegionMask::getPolygon(shapes[i], bounds.tl());
+        if (!polygon.empty() && this->regionMask.isIncluded(polygon, frame.size()))
+        {
+            polygons.push_back(polygon);
+        }
+        delete shapes[i];
+    }
+    this->work.addContours(shapes.size(), polygons.size());
+
+    // Frames without candidate shapes skip the feature pipeline
+    if (polygons.empty())
+    {
+        this->work.finish(results);
+        return results;
+    }
+
+    cv::fillPoly(mask, polygons, cv::Scalar(255));
+    if (this->margin > 0)
+    {
+        cv::polylines(mask, polygons, true, cv::Scalar(255), 2 * this->margin);
+    }
+
+    // Keypoints are never detected in excluded regions
+    cv::Mat processed = this->regionMask.get(frame.size());
+    if (!processed.empty())
+    {
+        cv::bitwise_and(mask, processed, mask);
+    }
+
+    cv::Mat scene = toGray(frame);
+
+    std::lock_guard<ContentionMutex> lock(this->modelsMutex);
+    this->frameCounter++;
+
+    Features sceneFeatures;
+    this->extractScene(frame, cv::Rect(0, 0, frame.cols, frame.rows), scene, sceneFeatures, mask);
+    MemoryCharge scratch(MemoryComponent::SCRATCH, MemoryAccount::getBytes(scene) + sceneFeatures.getBytes());
+
+    std::vector<std::pair<Model*, Verification>> recognized = this->verifyModels(this->rankModels(), sceneFeatures);
+    for (size_t i = 0; i < recognized.size(); i++)
+    {
+        this->recognized(recognized[i].first);
+        results.push_back(createResult(recognized[i].first->id, recognized[i].second));
+    }
+
+    this->work.finish(results);
+    return results;
+}
@@ -0,0 +1,77 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <companion/algo/detection/ShapeDetection.h>
+#include <companion/processing/detection/ObjectDetection.h>
+
+#include "CompanionWinRT/native/RecognitionProcessing.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class recognizes models by feature matching inside detected shapes only.
+         *
+         * Keypoints are extracted inside the detected polygons (plus a margin) and matched against all active models. Frames without
+         * any detected shape skip the feature extraction and matching entirely.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class GatedProcessing : public RecognitionProcessing
+        {
+            public:
+
+                /**
+                 * Create a 'GatedProcessing' object.
+                 *
+                 * @param shapeDetection    native shape detection that provides the candidate shapes
+                 * @param verification      feature verification used to verify models
+                 * @param margin            margin around the detected shapes (in pixels)
+                 */
+                GatedProcessing(Companion::Algorithm::Detection::ShapeDetection* shapeDetection, FeatureVerification* verification, int margin);
+
+                /**
+                 * Destruct this instance.
+                 */
+                virtual ~GatedProcessing();
+
+                /**
+                 * Recognize models inside the detected shapes of the given frame.
+                 *
+                 * @param frame frame to process
+                 * @return recognition results
+                 */
+                virtual std::vector<Companion::Model::Result::Result*> execute(cv::Mat frame) override;
+
+            private:
+
+                /**
+                 * Native object detection that provides the candidate shapes.
+                 */
+                Companion::Processing::Detection::ObjectDetection* objectDetection;
+
+                /**
+                 * Margin around the detected shapes (in pixels).
+                 */
+                int margin;
+        };
+    }
+}
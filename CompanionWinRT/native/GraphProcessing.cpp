@@ -0,0 +1,545 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <set>
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "GraphProcessing.h"
+#include "CompanionWinRT/native/MemoryAccount.h"
+
+using namespace CompanionWinRT::Native;
+
+/**
+ * Size of the thumbnails compared by a motion gate.
+ */
+static const cv::Size MOTION_THUMBNAIL(64, 36);
+
+GraphProcessing::GraphProcessing(FeatureVerification* verification, cv::Size scaling) : RecognitionProcessing(verification), scaling(scaling)
+{
+    std::unique_ptr<Node> preprocessing(new Node());
+    preprocessing->type = StageType::PREPROCESSING;
+    this->nodes.push_back(std::move(preprocessing));
+}
+
+int GraphProcessing::addMotionGate(double threshold, const std::vector<int>& inputs)
+{
+    std::unique_ptr<Node> node(new Node());
+    node->type = StageType::MOTION_GATE;
+    node->inputs = inputs;
+    node->threshold = std::max(0.0, threshold);
+    return this->addNode(std::move(node));
+}
+
+int GraphProcessing::addShapeGate(Companion::Algorithm::Detection::ShapeDetection* shapeDetection, int margin, const std::vector<int>& inputs)
+{
+    std::unique_ptr<Node> node(new Node());
+    node->type = StageType::SHAPE_GATE;
+    node->inputs = inputs;
+    node->margin = std::max(0, margin);
+    node->objectDetection.reset(new Companion::Processing::Detection::ObjectDetection(shapeDetection));
+    return this->addNode(std::move(node));
+}
+
+int GraphProcessing::addHashing(Companion::Processing::Recognition::HashRecognition* hashRecognition, const std::vector<int>& inputs)
+{
+    std::unique_ptr<Node> node(new Node());
+    node->type = StageType::HASHING;
+    node->inputs = inputs;
+    node->hashRecognition = hashRecognition;
+    return this->addNode(std::move(node));
+}
+
+int GraphProcessing::addExtraction(const std::vector<int>& inputs)
+{
+    std::unique_ptr<Node> node(new Node());
+    node->type = StageType::EXTRACTION;
+    node->inputs = inputs;
+    return this->addNode(std::move(node));
+}
+
+int GraphProcessing::addVerification(const std::vector<int>& inputs)
+{
+    std::unique_ptr<Node> node(new Node());
+    node->type = StageType::VERIFICATION;
+    node->inputs = inputs;
+    return this->addNode(std::move(node));
+}
+
+int GraphProcessing::getNodeCount()
+{
+    std::lock_guard<ContentionMutex> lock(this->modelsMutex);
+    return static_cast<int>(this->nodes.size());
+}
+
+bool GraphProcessing::addModel(int id, const cv::Mat& image, const std::string& tag)
+{
+    if (!RecognitionProcessing::addModel(id, image, tag))
+    {
+        return false;
+    }
+
+    std::lock_guard<ContentionMutex> lock(this->modelsMutex);
+    for (size_t i = 0; i < this->nodes.size(); i++)
+    {
+        Node& node = *this->nodes[i];
+        if (node.type == StageType::HASHING)
+        {
+            node.hashRecognition->addModel(id, image);
+        }
+
+        // The new model may be visible in an unchanged scene
+        node.reference.release();
+    }
+
+    return true;
+}
+
+std::vector<Companion::Model::Result::Result*> GraphProcessing::execute(cv::Mat frame)
+{
+    std::vector<Companion::Model::Result::Result*> results;
+    this->work.begin();
+
+    // Preprocessing (node 0)
+    Scene scene;
+    scene.frame = frame;
+    scene.bounds = this->regionMask.getBounds(frame.size());
+    scene.image = toGray(frame);
+    scene.mask = this->regionMask.get(frame.size());
+    scene.factor = std::min(1.0, std::min(static_cast<double>(this->scaling.width) / scene.image.cols, static_cast<double>(this->scaling.height) / scene.image.rows));
+    if (scene.factor < 1.0)
+    {
+        cv::resize(scene.image, scene.image, cv::Size(), scene.factor, scene.factor, cv::INTER_AREA);
+        if (!scene.mask.empty())
+        {
+            cv::resize(scene.mask, scene.mask, scene.image.size(), 0.0, 0.0, cv::INTER_NEAREST);
+        }
+    }
+
+    std::lock_guard<ContentionMutex> lock(this->modelsMutex);
+    this->frameCounter++;
+
+    // Execute the graph level by level, the nodes of a level only depend on nodes of lower levels
+    std::vector<Output> outputs(this->nodes.size());
+    int levels = 0;
+    for (size_t i = 0; i < this->nodes.size(); i++)
+    {
+        levels = std::max(levels, this->nodes[i]->level);
+    }
+
+    std::vector<int> level;
+    for (int l = 1; l <= levels; l++)
+    {
+        level.clear();
+        for (size_t i = 0; i < this->nodes.size(); i++)
+        {
+            if (this->nodes[i]->level == l)
+            {
+                level.push_back(static_cast<int>(i));
+            }
+        }
+
+        cv::parallel_for_(cv::Range(0, static_cast<int>(level.size())), [&](const cv::Range& range)
+        {
+            for (int i = range.start; i < range.end; i++)
+            {
+                this->run(level[i], scene, outputs);
+            }
+        });
+    }
+
+    int64_t scratchBytes = MemoryAccount::getBytes(scene.image);
+    for (size_t i = 0; i < outputs.size(); i++)
+    {
+        for (size_t j = 0; j < outputs[i].regions.size(); j++)
+        {
+            scratchBytes += outputs[i].regions[j].features.getBytes();
+        }
+    }
+    MemoryCharge scratch(MemoryComponent::SCRATCH, scratchBytes);
+
+    // Merge the verifications, an unchanged scene repeats the results of the last processed frame
+    bool verified = false;
+    bool still = false;
+    std::vector<std::pair<Model*, Verification>> recognized;
+    for (size_t i = 0; i < this->nodes.size(); i++)
+    {
+        if (this->nodes[i]->type == StageType::VERIFICATION)
+        {
+            verified = verified || (outputs[i].skip == StageSkip::NONE);
+            still = still || (outputs[i].skip == StageSkip::STILL);
+            recognized.insert(recognized.end(), outputs[i].recognized.begin(), outputs[i].recognized.end());
+        }
+    }
+
+    if (!verified && still)
+    {
+        for (size_t i = 0; i < this->lastRecognized.size(); i++)
+        {
+            Model* model = this->findModel(this->lastRecognized[i].first);
+            if (model != nullptr)
+            {
+                this->recognized(model);
+                results.push_back(createResult(model->id, this->lastRecognized[i].second));
+            }
+        }
+        this->work.finish(results);
+        return results;
+    }
+
+    // Best score per model (ties in node order)
+    std::stable_sort(recognized.begin(), recognized.end(), [](const std::pair<Model*, Verification>& a, const std::pair<Model*, Verification>& b)
+    {
+        return a.second.score > b.second.score;
+    });
+
+    std::set<int> mergedIDs;
+    this->lastRecognized.clear();
+    for (size_t i = 0; (i < recognized.size()) && !this->isSaturated(results.size()); i++)
+    {
+        Model* model = recognized[i].first;
+        if (mergedIDs.insert(model->id).second)
+        {
+            this->recognized(model);
+            this->lastRecognized.push_back(std::make_pair(model->id, recognized[i].second));
+            results.push_back(createResult(model->id, recognized[i].second));
+        }
+    }
+
+    this->work.finish(results);
+    return results;
+}
+
+int GraphProcessing::addNode(std::unique_ptr<Node> node)
+{
+    std::lock_guard<ContentionMutex> lock(this->modelsMutex);
+    if (!this->isValid(*node))
+    {
+        return -1;
+    }
+
+    // Every node depends on the preprocessing at least
+    node->level = 1;
+    for (size_t i = 0; i < node->inputs.size(); i++)
+    {
+        node->level = std::max(node->level, this->nodes[node->inputs[i]]->level + 1);
+    }
+
+    this->nodes.push_back(std::move(node));
+    return static_cast<int>(this->nodes.size()) - 1;
+}
+
+bool GraphProcessing::isValid(const Node& node)
+{
+    int hashings = 0;
+    int extractions = 0;
+    for (size_t i = 0; i < node.inputs.size(); i++)
+    {
+        // Inputs must exist already, so the graph can't contain cycles
+        int input = node.inputs[i];
+        if ((input < 0) || (input >= static_cast<int>(this->nodes.size())))
+        {
+            return false;
+        }
+
+        switch (this->nodes[input]->type)
+        {
+            case StageType::HASHING:
+                hashings++;
+                break;
+            case StageType::EXTRACTION:
+                extractions++;
+                break;
+            case StageType::VERIFICATION:
+                // Verifications are merged into the results only
+                return false;
+            default:
+                break;
+        }
+    }
+
+    switch (node.type)
+    {
+        case StageType::MOTION_GATE:
+        case StageType::SHAPE_GATE:
+        case StageType::HASHING:
+            return (hashings == 0) && (extractions == 0);
+        case StageType::EXTRACTION:
+            return (hashings <= 1) && (extractions == 0);
+        case StageType::VERIFICATION:
+            return (hashings == 0) && (extractions == 1);
+        default:
+            return false;
+    }
+}
+
+void GraphProcessing::run(int index, const Scene& scene, std::vector<Output>& outputs)
+{
+    Node& node = *this->nodes[index];
+    Output& output = outputs[index];
+
+    // Skipped inputs skip the node, unchanged scenes take precedence so their results are repeated
+    for (size_t i = 0; i < node.inputs.size(); i++)
+    {
+        StageSkip skip = outputs[node.inputs[i]].skip;
+        if ((skip == StageSkip::STILL) || ((skip == StageSkip::EMPTY) && (output.skip == StageSkip::NONE)))
+        {
+            output.skip = skip;
+        }
+    }
+    if (output.skip != StageSkip::NONE)
+    {
+        return;
+    }
+
+    switch (node.type)
+    {
+        case StageType::MOTION_GATE:
+            this->runMotionGate(node, scene, output);
+            break;
+        case StageType::SHAPE_GATE:
+            this->runShapeGate(node, scene, output);
+            break;
+        case StageType::HASHING:
+            this->runHashing(node, scene, output);
+            break;
+        case StageType::EXTRACTION:
+            this->runExtraction(node, scene, outputs, output);
+            break;
+        case StageType::VERIFICATION:
+            this->runVerification(node, scene, outputs, output);
+            break;
+        default:
+            break;
+    }
+}
+
+void GraphProcessing::runMotionGate(Node& node, const Scene& scene, Output& output)
+{
+    cv::Mat thumbnail;
+    cv::resize(scene.image, thumbnail, MOTION_THUMBNAIL, 0.0, 0.0, cv::INTER_AREA);
+
+    // Activity in excluded regions must not open the gate, thumbnail pixels that touch an excluded region are ignored
+    cv::Mat mask;
+    double pixels = static_cast<double>(thumbnail.total());
+    if (!scene.mask.empty())
+    {
+        cv::resize(scene.mask, mask, MOTION_THUMBNAIL, 0.0, 0.0, cv::INTER_AREA);
+        cv::compare(mask, 255, mask, cv::CMP_EQ);
+        pixels = std::max(1, cv::countNonZero(mask));
+    }
+
+    // Compare with the last frame that passed, so slow changes add up until they pass the gate
+    if (!node.reference.empty() && (cv::norm(thumbnail, node.reference, cv::NORM_L1, mask) / pixels < node.threshold))
+    {
+        output.skip = StageSkip::STILL;
+        return;
+    }
+
+    node.reference = thumbnail;
+}
+
+void GraphProcessing::runShapeGate(Node& node, const Scene& scene, Output& output)
+{
+    std::vector<Companion::Model::Result::Result*> shapes;
+    if (scene.bounds.area() > 0)
+    {
+        shapes = node.objectDetection->execute(scene.frame(scene.bounds));
+    }
+
+    std::vector<std::vector<cv::Point>> polygons;
+    for (size_t i = 0; i < shapes.size(); i++)
+    {
+        std::vector<cv::Point> polygon = RegionMask::getPolygon(shapes[i], scene.bounds.tl());
+        if (!polygon.empty() && this->regionMask.isIncluded(polygon, scene.frame.size()))
+        {
+            polygons.push_back(polygon);
+        }
+        delete shapes[i];
+    }
+    this->work.addContours(shapes.size(), polygons.size());
+
+    if (polygons.empty())
+    {
+        output.skip = StageSkip::EMPTY;
+        return;
+    }
+
+    cv::Mat mask = cv::Mat::zeros(scene.frame.size(), CV_8U);
+    cv::fillPoly(mask, polygons, cv::Scalar(255));
+    if (node.margin > 0)
+    {
+        cv::polylines(mask, polygons, true, cv::Scalar(255), 2 * node.margin);
+    }
+    cv::resize(mask, output.mask, scene.image.size(), 0.0, 0.0, cv::INTER_NEAREST);
+}
+
+void GraphProcessing::runHashing(Node& node, const Scene& scene, Output& output)
+{
+    std::vector<Companion::Model::Result::Result*> candidates;
+    if (scene.bounds.area() > 0)
+    {
+        candidates = node.hashRecognition->execute(scene.frame(scene.bounds));
+    }
+    this->work.addHashCandidates(candidates.size());
+
+    // Best candidates first (ties by model ID), so verification can stop early
+    std::stable_sort(candidates.begin(), candidates.end(), [](Companion::Model::Result::Result* a, Companion::Model::Result::Result* b)
+    {
+        if (a->getScoring() != b->getScoring())
+        {
+            return a->getScoring() > b->getScoring();
+        }
+        Companion::Model::Result::RecognitionResult* resultA = dynamic_cast<Companion::Model::Result::RecognitionResult*>(a);
+        Companion::Model::Result::RecognitionResult* resultB = dynamic_cast<Companion::Model::Result::RecognitionResult*>(b);
+        return (resultA != nullptr) && (resultB != nullptr) && (resultA->getId() < resultB->getId());
+    });
+
+    cv::Rect frameArea(0, 0, scene.frame.cols, scene.frame.rows);
+    cv::Rect sceneArea(0, 0, scene.image.cols, scene.image.rows);
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        Companion::Model::Result::RecognitionResult* candidate = dynamic_cast<Companion::Model::Result::RecognitionResult*>(candidates[i]);
+        std::vector<cv::Point> corners = (candidate != nullptr) ? RegionMask::getPolygon(candidate, scene.bounds.tl()) : std::vector<cv::Point>();
+        if (corners.empty())
+        {
+            continue;
+        }
+
+        Region region;
+        region.roi = cv::boundingRect(corners) & frameArea;
+        region.area = cv::Rect(cv::Point(cvFloor(region.roi.x * scene.factor), cvFloor(region.roi.y * scene.factor)),
+                               cv::Point(cvCeil(region.roi.br().x * scene.factor), cvCeil(region.roi.br().y * scene.factor))) & sceneArea;
+        if ((region.area.area() > 0) && this->regionMask.isIncluded(corners, scene.frame.size()))
+        {
+            region.candidates.push_back(candidate->getId());
+            output.regions.push_back(region);
+        }
+    }
+
+    // Candidates are owned by this processing
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        delete candidates[i];
+    }
+
+    if (output.regions.empty())
+    {
+        output.skip = StageSkip::EMPTY;
+    }
+}
+
+void GraphProcessing::runExtraction(Node& node, const Scene& scene, const std::vector<Output>& outputs, Output& output)
+{
+    // Keypoints are only detected inside the region mask and all shape gates
+    cv::Mat mask = scene.mask;
+    const Output* hashing = nullptr;
+    for (size_t i = 0; i < node.inputs.size(); i++)
+    {
+        int input = node.inputs[i];
+        if (this->nodes[input]->type == StageType::SHAPE_GATE)
+        {
+            cv::Mat combined;
+            if (mask.empty())
+            {
+                combined = outputs[input].mask;
+            }
+            else
+            {
+                cv::bitwise_and(mask, outputs[input].mask, combined);
+            }
+            mask = combined;
+        }
+        else if (this->nodes[input]->type == StageType::HASHING)
+        {
+            hashing = &outputs[input];
+        }
+    }
+
+    if (hashing == nullptr)
+    {
+        Region region;
+        region.roi = cv::Rect(0, 0, scene.frame.cols, scene.frame.rows);
+        region.area = cv::Rect(0, 0, scene.image.cols, scene.image.rows);
+        this->extractScene(scene.frame, region.roi, scene.image, region.features, mask);
+        output.regions.push_back(region);
+        return;
+    }
+
+    // Extract inside the candidate regions only
+    output.regions = hashing->regions;
+    for (size_t i = 0; i < output.regions.size(); i++)
+    {
+        Region& region = output.regions[i];
+        this->extractScene(scene.frame, region.roi, scene.image(region.area), region.features, mask.empty() ? cv::Mat() : mask(region.area));
+    }
+}
+
+void GraphProcessing::runVerification(Node& node, const Scene& scene, const std::vector<Output>& outputs, Output& output)
+{
+    const Output* extraction = nullptr;
+    for (size_t i = 0; i < node.inputs.size(); i++)
+    {
+        if (this->nodes[node.inputs[i]]->type == StageType::EXTRACTION)
+        {
+            extraction = &outputs[node.inputs[i]];
+        }
+    }
+
+    std::set<int> verifiedIDs;
+    for (size_t i = 0; (i < extraction->regions.size()) && !this->isSaturated(output.recognized.size()); i++)
+    {
+        const Region& region = extraction->regions[i];
+
+        // Candidate regions verify their candidates, whole scenes all active models
+        std::vector<Model*> ranking;
+        if (region.candidates.empty())
+        {
+            ranking = this->rankModels();
+        }
+        for (size_t j = 0; j < region.candidates.size(); j++)
+        {
+            Model* model = this->findModel(region.candidates[j]);
+            if (model != nullptr)
+            {
+                ranking.push_back(model);
+            }
+        }
+        ranking.erase(std::remove_if(ranking.begin(), ranking.end(), [&verifiedIDs](const Model* model)
+        {
+            return verifiedIDs.count(model->id) > 0;
+        }), ranking.end());
+
+        std::vector<std::pair<Model*, Verification>> recognized = this->verifyModels(ranking, region.features);
+        for (size_t j = 0; j < recognized.size(); j++)
+        {
+            // Map the verification back to frame coordinates
+            Verification& verification = recognized[j].second;
+            for (size_t k = 0; k < verification.corners.size(); k++)
+            {
+                verification.corners[k] = (verification.corners[k] + cv::Point2f(region.area.tl())) * (1.0 / scene.factor);
+            }
+            verification.homography = cv::Mat(cv::Matx33d(1.0 / scene.factor, 0.0, region.area.x / scene.factor, 0.0, 1.0 / scene.factor,
+                                                          region.area.y / scene.factor, 0.0, 0.0, 1.0)) * verification.homography;
+
+            verifiedIDs.insert(recognized[j].first->id);
+            output.recognized.push_back(recognized[j]);
+        }
+    }
+}
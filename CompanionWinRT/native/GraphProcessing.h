@@ -0,0 +1,368 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <companion/algo/detection/ShapeDetection.h>
+#include <companion/processing/detection/ObjectDetection.h>
+#include <companion/processing/recognition/HashRecognition.h>
+
+#include "CompanionWinRT/native/RecognitionProcessing.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * Stages of a processing graph.
+         */
+        enum class StageType
+        {
+            PREPROCESSING, ///< Gray conversion, scaling to the processing resolution and region mask (always node 0).
+            MOTION_GATE, ///< Skips dependent nodes while the scene does not change and repeats the last results.
+            SHAPE_GATE, ///< Restricts the extraction to detected shapes, skips dependent nodes if no shape is detected.
+            HASHING, ///< Provides candidate regions and models, skips dependent nodes if there is no candidate.
+            EXTRACTION, ///< Extracts scene features in the whole scene or in the candidate regions of a hashing input.
+            VERIFICATION ///< Matches and verifies models against the features of an extraction input.
+        };
+
+        /**
+         * Why a node was skipped for a frame.
+         */
+        enum class StageSkip
+        {
+            NONE, ///< The node was executed.
+            STILL, ///< A motion gate found no change since the last processed frame.
+            EMPTY ///< A shape gate or a hashing found nothing to process.
+        };
+
+        /**
+         * This class executes a configurable graph of processing stages.
+         *
+         * Every node reads the outputs of its input nodes, which must have been added before the node, so the graph is always acyclic.
+         * Gates (motion gate, shape gate and hashing without candidates) skip all nodes that depend on them. The scheduler executes
+         * the graph in levels: all nodes whose inputs are complete are executed in parallel, for example a shape gate and a hashing
+         * that both depend on the preprocessing only. The results of all verification nodes are merged (best score per model).
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class GraphProcessing : public RecognitionProcessing
+        {
+            public:
+
+                /**
+                 * Create a 'GraphProcessing' object with a single preprocessing node (node 0).
+                 *
+                 * @param verification  feature verification used by extraction and verification nodes
+                 * @param scaling       processing resolution of the frames
+                 */
+                GraphProcessing(FeatureVerification* verification, cv::Size scaling);
+
+                /**
+                 * Add a motion gate. The gate compares a thumbnail of the processed region of the scene with the last frame that passed
+                 * the gate, so activity in regions excluded by the region mask never opens it.
+                 *
+                 * @param threshold mean absolute gray value difference (0 - 255) below which the scene counts as unchanged
+                 * @param inputs    input nodes (gates only)
+                 * @return ID of the new node (-1 if the inputs are invalid)
+                 */
+                int addMotionGate(double threshold, const std::vector<int>& inputs);
+
+                /**
+                 * Add a shape gate.
+                 *
+                 * @param shapeDetection    shape detection that provides the candidate shapes
+                 * @param margin            margin around the detected shapes (in pixels)
+                 * @param inputs            input nodes (gates only)
+                 * @return ID of the new node (-1 if the inputs are invalid)
+                 */
+                int addShapeGate(Companion::Algorithm::Detection::ShapeDetection* shapeDetection, int margin, const std::vector<int>& inputs);
+
+                /**
+                 * Add a hashing. All models added to this processing afterwards are added to the hash recognition as well.
+                 *
+                 * @param hashRecognition   native hash recognition that provides the candidates
+                 * @param inputs            input nodes (gates only)
+                 * @return ID of the new node (-1 if the inputs are invalid)
+                 */
+                int addHashing(Companion::Processing::Recognition::HashRecognition* hashRecognition, const std::vector<int>& inputs);
+
+                /**
+                 * Add a feature extraction.
+                 *
+                 * @param inputs    input nodes (gates and at most one hashing)
+                 * @return ID of the new node (-1 if the inputs are invalid)
+                 */
+                int addExtraction(const std::vector<int>& inputs);
+
+                /**
+                 * Add a verification.
+                 *
+                 * @param inputs    input nodes (exactly one extraction and any gates)
+                 * @return ID of the new node (-1 if the inputs are invalid)
+                 */
+                int addVerification(const std::vector<int>& inputs);
+
+                /**
+                 * Return the number of nodes.
+                 *
+                 * @return number of nodes
+                 */
+                int getNodeCount();
+
+                /**
+                 * Add a model to all hashing nodes and to the feature verification.
+                 *
+                 * @param id    the ID of the model
+                 * @param image gray scale model image
+                 * @param tag   tag (group) of the model
+                 * @return <code>true</code> if the model was added successfully, <code>false</code> otherwise
+                 */
+                virtual bool addModel(int id, const cv::Mat& image, const std::string& tag) override;
+
+                /**
+                 * Execute the graph for the given frame.
+                 *
+                 * @param frame frame to process
+                 * @return recognition results
+                 */
+                virtual std::vector<Companion::Model::Result::Result*> execute(cv::Mat frame) override;
+
+            private:
+
+                /**
+                 * A region of the scene to extract and verify.
+                 */
+                struct Region
+                {
+                    /**
+                     * Region in frame coordinates.
+                     */
+                    cv::Rect roi;
+
+                    /**
+                     * Region in scene coordinates.
+                     */
+                    cv::Rect area;
+
+                    /**
+                     * IDs of the candidate models (empty for all active models).
+                     */
+                    std::vector<int> candidates;
+
+                    /**
+                     * Features extracted in the region (in region coordinates).
+                     */
+                    Features features;
+                };
+
+                /**
+                 * Preprocessed frame shared by all nodes.
+                 */
+                struct Scene
+                {
+                    /**
+                     * Original frame.
+                     */
+                    cv::Mat frame;
+
+                    /**
+                     * Bounds of the processed region in the original frame, the part the contour based stages search.
+                     */
+                    cv::Rect bounds;
+
+                    /**
+                     * Gray scale scene at the processing resolution.
+                     */
+                    cv::Mat image;
+
+                    /**
+                     * Region mask at the processing resolution (empty if the whole scene is processed).
+                     */
+                    cv::Mat mask;
+
+                    /**
+                     * Scale factor from frame to scene coordinates.
+                     */
+                    double factor;
+                };
+
+                /**
+                 * Output of a node for the current frame.
+                 */
+                struct Output
+                {
+                    /**
+                     * Why the node was skipped.
+                     */
+                    StageSkip skip;
+
+                    /**
+                     * Search mask of a shape gate (in scene coordinates).
+                     */
+                    cv::Mat mask;
+
+                    /**
+                     * Candidate regions of a hashing or extracted regions of an extraction.
+                     */
+                    std::vector<Region> regions;
+
+                    /**
+                     * Recognized models of a verification (in frame coordinates).
+                     */
+                    std::vector<std::pair<Model*, Verification>> recognized;
+                };
+
+                /**
+                 * A node of the graph.
+                 */
+                struct Node
+                {
+                    /**
+                     * Stage of the node.
+                     */
+                    StageType type;
+
+                    /**
+                     * Input nodes.
+                     */
+                    std::vector<int> inputs;
+
+                    /**
+                     * Motion threshold of a motion gate.
+                     */
+                    double threshold;
+
+                    /**
+                     * Thumbnail of the last frame that passed a motion gate.
+                     */
+                    cv::Mat reference;
+
+                    /**
+                     * Margin around the shapes of a shape gate (in pixels).
+                     */
+                    int margin;
+
+                    /**
+                     * Object detection of a shape gate.
+                     */
+                    std::unique_ptr<Companion::Processing::Detection::ObjectDetection> objectDetection;
+
+                    /**
+                     * Native hash recognition of a hashing.
+                     */
+                    Companion::Processing::Recognition::HashRecognition* hashRecognition;
+
+                    /**
+                     * Level of the node in the schedule (number of nodes on the longest path from the preprocessing).
+                     */
+                    int level;
+                };
+
+                /**
+                 * Add a node after checking its inputs.
+                 *
+                 * @param node  node to add
+                 * @return ID of the new node (-1 if the inputs are invalid)
+                 */
+                int addNode(std::unique_ptr<Node> node);
+
+                /**
+                 * Check whether the inputs of a node are valid for its stage.
+                 *
+                 * @param node  node to check
+                 * @return <code>true</code> if the inputs are valid, <code>false</code> otherwise
+                 */
+                bool isValid(const Node& node);
+
+                /**
+                 * Execute a node unless one of its inputs was skipped.
+                 *
+                 * @param index     ID of the node
+                 * @param scene     preprocessed frame
+                 * @param outputs   outputs of all nodes of the current frame
+                 */
+                void run(int index, const Scene& scene, std::vector<Output>& outputs);
+
+                /**
+                 * Execute a motion gate.
+                 *
+                 * @param node      motion gate node
+                 * @param scene     preprocessed frame
+                 * @param output    output of the node
+                 */
+                void runMotionGate(Node& node, const Scene& scene, Output& output);
+
+                /**
+                 * Execute a shape gate.
+                 *
+                 * @param node      shape gate node
+                 * @param scene     preprocessed frame
+                 * @param output    output of the node
+                 */
+                void runShapeGate(Node& node, const Scene& scene, Output& output);
+
+                /**
+                 * Execute a hashing.
+                 *
+                 * @param node      hashing node
+                 * @param scene     preprocessed frame
+                 * @param output    output of the node
+                 */
+                void runHashing(Node& node, const Scene& scene, Output& output);
+
+                /**
+                 * Execute an extraction.
+                 *
+                 * @param node      extraction node
+                 * @param scene     preprocessed frame
+                 * @param outputs   outputs of all nodes of the current frame
+                 * @param output    output of the node
+                 */
+                void runExtraction(Node& node, const Scene& scene, const std::vector<Output>& outputs, Output& output);
+
+                /**
+                 * Execute a verification.
+                 *
+                 * @param node      verification node
+                 * @param scene     preprocessed frame
+                 * @param outputs   outputs of all nodes of the current frame
+                 * @param output    output of the node
+                 */
+                void runVerification(Node& node, const Scene& scene, const std::vector<Output>& outputs, Output& output);
+
+                /**
+                 * Processing resolution of the frames.
+                 */
+                cv::Size scaling;
+
+                /**
+                 * Nodes of the graph in the order they were added.
+                 */
+                std::vector<std::unique_ptr<Node>> nodes;
+
+                /**
+                 * Results of the last frame that passed all motion gates (model ID and verification), repeated for unchanged scenes.
+                 */
+                std::vector<std::pair<int, Verification>> lastRecognized;
+        };
+    }
+}
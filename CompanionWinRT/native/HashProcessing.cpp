@@ -0,0 +1,76 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <companion/model/result/RecognitionResult.h>
+
+#include "HashProcessing.h"
+
+using namespace CompanionWinRT::Native;
+
+HashProcessing::HashProcessing(Companion::Processing::Recognition::HashRecognition* hashRecognition) : hashRecognition(hashRecognition)
+{
+}
+
+void HashProcessing::addModel(int id, const cv::Mat& image, const std::string& tag)
+{
+    this->tags.setTag(id, tag);
+    this->hashRecognition->addModel(id, image);
+}
+
+void HashProcessing::setActiveTags(const std::set<std::string>& tags)
+{
+    this->tags.setActiveTags(tags);
+}
+
+void HashProcessing::setRegionMask(const cv::Mat& mask)
+{
+    this->regionMask.set(mask);
+}
+
+std::vector<Companion::Model::Result::Result*> HashProcessing::execute(cv::Mat frame)
+{
+    this->work.begin();
+    // Only the bounds of the processed region are searched
+    cv::Rect bounds = this->regionMask.getBounds(frame.size());
+    std::vector<Companion::Model::Result::Result*> results;
+    if (bounds.area() > 0)
+    {
+        results = this->hashRecognition->execute(frame(bounds));
+    }
+    this->work.addHashCandidates(results.size());
+
+    // Drop results of inactive models and results in excluded regions
+    size_t active = 0;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        Companion::Model::Result::RecognitionResult* result = dynamic_cast<Companion::Model::Result::RecognitionResult*>(results[i]);
+        std::vector<cv::Point> polygon = RegionMask::getPolygon(results[i], bounds.tl());
+        if (((result == nullptr) || this->tags.isActive(result->getId())) && this->regionMask.isIncluded(polygon, frame.size()))
+        {
+            results[active++] = RegionMask::toFrame(results[i], bounds.tl());
+        }
+        else
+        {
+            delete results[i];
+        }
+    }
+    results.resize(active);
+
+    this->work.finish(results);
+    return results;
+}
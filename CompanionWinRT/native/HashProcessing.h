@@ -0,0 +1,105 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <set>
+#include <string>
+#include <companion/processing/ImageProcessing.h>
+#include <companion/processing/recognition/HashRecognition.h>
+
+#include "CompanionWinRT/native/ModelTags.h"
+#include "CompanionWinRT/native/RegionMask.h"
+#include "CompanionWinRT/native/WorkCounter.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class runs a native hash recognition and reports results of active models only.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class HashProcessing : public Companion::Processing::ImageProcessing
+        {
+            public:
+
+                /**
+                 * Create a 'HashProcessing' object.
+                 *
+                 * @param hashRecognition   native hash recognition
+                 */
+                HashProcessing(Companion::Processing::Recognition::HashRecognition* hashRecognition);
+
+                /**
+                 * Add an image hash model.
+                 *
+                 * @param id    the ID of the model
+                 * @param image gray scale model image
+                 * @param tag   tag (group) of the model
+                 */
+                void addModel(int id, const cv::Mat& image, const std::string& tag);
+
+                /**
+                 * Select the active model tags. Only results of models with an active tag are reported.
+                 *
+                 * @param tags  active tags (an empty set activates all models)
+                 */
+                void setActiveTags(const std::set<std::string>& tags);
+
+                /**
+                 * Set a static region mask. The hash recognition searches the bounds of the processed region only, and results with a
+                 * corner outside the processed region or on its boundary are not reported.
+                 *
+                 * @param mask  8-bit mask with non-zero pixels for processed regions (empty to process the whole frame)
+                 */
+                void setRegionMask(const cv::Mat& mask);
+
+                /**
+                 * Recognize image hash models in the given frame.
+                 *
+                 * @param frame frame to process
+                 * @return recognition results of active models
+                 */
+                virtual std::vector<Companion::Model::Result::Result*> execute(cv::Mat frame) override;
+
+            private:
+
+                /**
+                 * Native hash recognition.
+                 */
+                Companion::Processing::Recognition::HashRecognition* hashRecognition;
+
+                /**
+                 * Tags of all models.
+                 */
+                ModelTags tags;
+
+                /**
+                 * Static region mask of the camera view.
+                 */
+                RegionMask regionMask;
+
+                /**
+                 * Work counters of the current frame.
+                 */
+                WorkCounter work;
+        };
+    }
+}
@@ -0,0 +1,153 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <set>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "HybridProcessing.h"
+#include "CompanionWinRT/native/MemoryAccount.h"
+
+using namespace CompanionWinRT::Native;
+
+HybridProcessing::HybridProcessing(Companion::Processing::Recognition::HashRecognition* hashRecognition, FeatureVerification* verification, int resize)
+    : RecognitionProcessing(verification), hashRecognition(hashRecognition), resize(std::min(100, std::max(1, resize)))
+{
+}
+
+bool HybridProcessing::addModel(int id, const cv::Mat& image, const std::string& tag)
+{
+    if (!RecognitionProcessing::addModel(id, image, tag))
+    {
+        return false;
+    }
+
+    this->hashRecognition->addModel(id, image);
+    return true;
+}
+
+std::vector<Companion::Model::Result::Result*> HybridProcessing::execute(cv::Mat frame)
+{
+    std::vector<Companion::Model::Result::Result*> results;
+    this->work.begin();
+    cv::Rect bounds = this->regionMask.getBounds(frame.size());
+    std::vector<Companion::Model::Result::Result*> candidates;
+    if (bounds.area() > 0)
+    {
+        candidates = this->hashRecognition->execute(frame(bounds));
+    }
+    this->work.addHashCandidates(candidates.size());
+
+    cv::Mat scene = toGray(frame);
+    cv::Mat mask = this->regionMask.get(frame.size());
+    cv::Rect sceneArea(0, 0, scene.cols, scene.rows);
+    double factor = this->resize / 100.0;
+
+    // Verify recently recognized models first, then the best hash candidates (ties by model ID in deterministic mode)
+    {
+        std::lock_guard<ContentionMutex> lock(this->modelsMutex);
+        this->frameCounter++;
+        bool deterministic = this->deterministic;
+        std::stable_sort(candidates.begin(), candidates.end(), [this, deterministic](Companion::Model::Result::Result* a, Companion::Model::Result::Result* b)
+        {
+            int idA = static_cast<Companion::Model::Result::RecognitionResult*>(a)->getId();
+            int idB = static_cast<Companion::Model::Result::RecognitionResult*>(b)->getId();
+            Model* modelA = this->findModel(idA);
+            Model* modelB = this->findModel(idB);
+            int lastSeenA = ((modelA != nullptr) && !deterministic) ? modelA->lastSeen : 0;
+            int lastSeenB = ((modelB != nullptr) && !deterministic) ? modelB->lastSeen : 0;
+            if (lastSeenA != lastSeenB)
+            {
+                return lastSeenA > lastSeenB;
+            }
+            if (a->getScoring() != b->getScoring())
+            {
+                return a->getScoring() > b->getScoring();
+            }
+            return deterministic && (idA < idB);
+        });
+    }
+
+    std::set<int> verifiedIDs;
+    Verification verification;
+    for (size_t i = 0; (i < candidates.size()) && !this->isSaturated(results.size()); i++)
+    {
+        Companion::Model::Result::RecognitionResult* candidate = dynamic_cast<Companion::Model::Result::RecognitionResult*>(candidates[i]);
+        std::vector<cv::Point> corners = (candidate != nullptr) ? RegionMask::getPolygon(candidate, bounds.tl()) : std::vector<cv::Point>();
+        if (corners.empty() || (verifiedIDs.count(candidate->getId()) > 0))
+        {
+            continue;
+        }
+
+        // Extract scene features inside the candidate region only
+        cv::Rect roi = cv::boundingRect(corners) & sceneArea;
+        if ((roi.area() == 0) || !this->regionMask.isIncluded(corners, frame.size()))
+        {
+            continue;
+        }
+
+        cv::Mat region = scene(roi);
+        cv::Mat maskRegion = mask.empty() ? cv::Mat() : mask(roi);
+        if (this->resize < 100)
+        {
+            cv::resize(region, region, cv::Size(), factor, factor, cv::INTER_AREA);
+            if (!maskRegion.empty())
+            {
+                cv::resize(maskRegion, maskRegion, region.size(), 0.0, 0.0, cv::INTER_NEAREST);
+            }
+        }
+
+        // Extract without the model lock, the model is looked up afterwards (it may have been removed meanwhile)
+        Features regionFeatures;
+        this->extractSceneFeatures(frame, roi, region, regionFeatures, maskRegion);
+
+        std::lock_guard<ContentionMutex> lock(this->modelsMutex);
+        Model* model = this->findModel(candidate->getId());
+        if (model == nullptr)
+        {
+            continue;
+        }
+
+        this->compactScene(regionFeatures);
+        MemoryCharge scratch(MemoryComponent::SCRATCH, MemoryAccount::getBytes(region) + regionFeatures.getBytes());
+        bool found = this->verification->verify(model->features, regionFeatures, verification, this->reRank);
+        this->work.addModel(model->id, verification);
+        if (found)
+        {
+            // Map the verification back to frame coordinates
+            for (size_t j = 0; j < verification.corners.size(); j++)
+            {
+                verification.corners[j] = verification.corners[j] * (1.0 / factor) + cv::Point2f(roi.tl());
+            }
+            verification.homography = cv::Mat(cv::Matx33d(1.0 / factor, 0.0, roi.x, 0.0, 1.0 / factor, roi.y, 0.0, 0.0, 1.0)) * verification.homography;
+
+            verifiedIDs.insert(model->id);
+            this->recognized(model);
+            results.push_back(createResult(model->id, verification));
+        }
+    }
+
+    // Candidates are owned by this processing
+    for (size_t i = 0; i < candidates.size(); i++)
+    {
+        delete candidates[i];
+    }
+
+    this->work.finish(results);
+    return results;
+}
@@ -0,0 +1,78 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <companion/processing/recognition/HashRecognition.h>
+
+#include "CompanionWinRT/native/RecognitionProcessing.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class verifies the candidates of a hash recognition by feature matching inside the candidate regions.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class HybridProcessing : public RecognitionProcessing
+        {
+            public:
+
+                /**
+                 * Create a 'HybridProcessing' object.
+                 *
+                 * @param hashRecognition   native hash recognition that provides the candidates
+                 * @param verification      feature verification used to verify candidates
+                 * @param resize            resize factor for candidate regions from 1 to 100 (in percent)
+                 */
+                HybridProcessing(Companion::Processing::Recognition::HashRecognition* hashRecognition, FeatureVerification* verification, int resize);
+
+                /**
+                 * Add a model to the hash recognition and to the feature verification.
+                 *
+                 * @param id    the ID of the model
+                 * @param image gray scale model image
+                 * @param tag   tag (group) of the model
+                 * @return <code>true</code> if the model was added successfully, <code>false</code> otherwise
+                 */
+                virtual bool addModel(int id, const cv::Mat& image, const std::string& tag) override;
+
+                /**
+                 * Recognize models in the given frame.
+                 *
+                 * @param frame frame to process
+                 * @return recognition results
+                 */
+                virtual std::vector<Companion::Model::Result::Result*> execute(cv::Mat frame) override;
+
+            private:
+
+                /**
+                 * Native hash recognition that provides the candidates.
+                 */
+                Companion::Processing::Recognition::HashRecognition* hashRecognition;
+
+                /**
+                 * Resize factor for candidate regions from 1 to 100 (in percent).
+                 */
+                int resize;
+        };
+    }
+}
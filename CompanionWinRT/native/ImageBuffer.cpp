@@ -0,0 +1,182 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <opencv2/imgcodecs/imgcodecs.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "ImageBuffer.h"
+#include "CompanionWinRT/native/MemoryAccount.h"
+
+using namespace CompanionWinRT::Native;
+
+ImageBuffer::ImageBuffer(int maxImages)
+    : Companion::Input::Image(maxImages), unmatched(0), obtained(0), maxImages(maxImages), slots(0), bufferedBytes(0), grayscale(false)
+{
+}
+
+ImageBuffer::~ImageBuffer()
+{
+    MemoryAccount::get(MemoryComponent::STREAM_BUFFERS).add(-this->bufferedBytes);
+}
+
+bool ImageBuffer::addImage(const std::string& imgPath)
+{
+    cv::Mat image = cv::imread(imgPath, this->grayscale ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
+    if (image.empty())
+    {
+        return false;
+    }
+
+    return this->addImage(image.cols, image.rows, image.type(), image.data);
+}
+
+bool ImageBuffer::addImage(int width, int height, int type, uchar* data)
+{
+    // A blocked producer holds its slot while it waits, so non-blocking producers see the buffer as full
+    this->slots++;
+    if (!this->enqueue(width, height, type, data))
+    {
+        this->slots--;
+        return false;
+    }
+    return true;
+}
+
+bool ImageBuffer::tryAddImage(int width, int height, int type, uchar* data)
+{
+    // Reserve a slot first, the buffer can't be full for the reserved image then
+    int images = this->slots;
+    do
+    {
+        if (images >= this->maxImages)
+        {
+            return false;
+        }
+    } while (!this->slots.compare_exchange_weak(images, images + 1));
+
+    if (!this->enqueue(width, height, type, data))
+    {
+        this->slots--;
+        return false;
+    }
+    return true;
+}
+
+bool ImageBuffer::enqueue(int width, int height, int type, uchar* data)
+{
+    if (this->grayscale && (CV_MAT_CN(type) > 1))
+    {
+        cv::Mat gray;
+        cv::cvtColor(cv::Mat(height, width, type, data), gray, (CV_MAT_CN(type) == 4) ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+        return this->enqueue(gray.cols, gray.rows, gray.type(), gray.data);
+    }
+
+    // Account the image before it enters the buffer, so the account never runs negative
+    int64_t bytes = static_cast<int64_t>(width) * height * CV_ELEM_SIZE(type);
+    this->bufferedBytes += bytes;
+    MemoryAccount::get(MemoryComponent::STREAM_BUFFERS).add(bytes);
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    if (!Companion::Input::Image::addImage(width, height, type, data))
+    {
+        this->bufferedBytes -= bytes;
+        MemoryAccount::get(MemoryComponent::STREAM_BUFFERS).add(-bytes);
+        return false;
+    }
+
+    this->added(start);
+    return true;
+}
+
+void ImageBuffer::setGrayscale(bool grayscale)
+{
+    this->grayscale = grayscale;
+}
+
+bool ImageBuffer::isGrayscale() const
+{
+    return this->grayscale;
+}
+
+cv::Mat ImageBuffer::obtainImage()
+{
+    cv::Mat image = Companion::Input::Image::obtainImage();
+    if (image.empty())
+    {
+        return image;
+    }
+
+    this->obtained++;
+    this->slots--;
+    int64_t bytes = MemoryAccount::getBytes(image);
+    this->bufferedBytes -= bytes;
+    MemoryAccount::get(MemoryComponent::STREAM_BUFFERS).add(-bytes);
+
+    std::lock_guard<std::mutex> lock(this->timesMutex);
+    if (this->enqueued.empty())
+    {
+        // The producer hasn't recorded the enqueue time yet
+        this->unmatched++;
+    }
+    else
+    {
+        this->queueTimes.record(std::chrono::steady_clock::now() - this->enqueued.front());
+        this->enqueued.pop_front();
+    }
+
+    return image;
+}
+
+uint64_t ImageBuffer::getObtained() const
+{
+    return this->obtained;
+}
+
+const LatencyHistogram& ImageBuffer::getAddTimes() const
+{
+    return this->addTimes;
+}
+
+const LatencyHistogram& ImageBuffer::getQueueTimes() const
+{
+    return this->queueTimes;
+}
+
+void ImageBuffer::resetTimes()
+{
+    this->addTimes.reset();
+    this->queueTimes.reset();
+}
+
+void ImageBuffer::added(std::chrono::steady_clock::time_point start)
+{
+    std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+    this->addTimes.record(now - start);
+
+    std::lock_guard<std::mutex> lock(this->timesMutex);
+    if (this->unmatched > 0)
+    {
+        // The image already left the buffer, its queue time is negligible
+        this->unmatched--;
+        this->queueTimes.record(std::chrono::steady_clock::duration::zero());
+    }
+    else
+    {
+        this->enqueued.push_back(now);
+    }
+}
@@ -0,0 +1,208 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <companion/input/Image.h>
+
+#include "CompanionWinRT/native/LatencyHistogram.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class is an image stream that records how long producers wait for space in the image buffer and how long images wait
+         * in the buffer until the processing takes them.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class ImageBuffer : public Companion::Input::Image
+        {
+            public:
+
+                /**
+                 * Create an 'ImageBuffer' object.
+                 *
+                 * @param maxImages maximum amount of images that can be buffered at the same time
+                 */
+                ImageBuffer(int maxImages);
+
+                /**
+                 * Release the accounted bytes of the buffered images and destruct this instance.
+                 */
+                virtual ~ImageBuffer();
+
+                /**
+                 * Load an image and add it to the buffer (blocks while the buffer is full). The image is loaded in color (in gray
+                 * in gray mode), so its size can be accounted to the stream buffers.
+                 *
+                 * @param imgPath   path of the image
+                 * @return <code>true</code> if the image was added successfully, <code>false</code> otherwise
+                 */
+                bool addImage(const std::string& imgPath);
+
+                /**
+                 * Add an image to the buffer (blocks while the buffer is full). Gray images are buffered as they are, color images
+                 * are converted to gray once in gray mode.
+                 *
+                 * @param width     width of the image
+                 * @param height    height of the image
+                 * @param type      type of the image (i.e. OpenCV image types)
+                 * @param data      data of the image
+                 * @return <code>true</code> if the image was added successfully, <code>false</code> otherwise
+                 */
+                bool addImage(int width, int height, int type, uchar* data);
+
+                /**
+                 * Add an image to the buffer if there is space for it, without blocking. Gray mode applies like in 'addImage'.
+                 *
+                 * @param width     width of the image
+                 * @param height    height of the image
+                 * @param type      type of the image (i.e. OpenCV image types)
+                 * @param data      data of the image
+                 * @return <code>true</code> if the image was added, <code>false</code> if the buffer is full or the image couldn't be added
+                 */
+                bool tryAddImage(int width, int height, int type, uchar* data);
+
+                /**
+                 * Enable or disable the gray mode. In gray mode all images are buffered in gray, so the gray processing needs no
+                 * conversion and the buffer needs a third of the memory.
+                 *
+                 * @param grayscale <code>true</code> to enable the gray mode, <code>false</code> to disable it
+                 */
+                void setGrayscale(bool grayscale);
+
+                /**
+                 * Check whether the gray mode is enabled.
+                 *
+                 * @return <code>true</code> if the gray mode is enabled, <code>false</code> otherwise
+                 */
+                bool isGrayscale() const;
+
+                /**
+                 * Take the oldest image out of the buffer.
+                 *
+                 * @return the oldest image (empty if the buffer is empty)
+                 */
+                virtual cv::Mat obtainImage() override;
+
+                /**
+                 * Return the number of images taken out of the buffer.
+                 *
+                 * @return number of images taken out of the buffer
+                 */
+                uint64_t getObtained() const;
+
+                /**
+                 * Return the histogram of the times producers waited for space in the buffer.
+                 *
+                 * @return histogram of the add times
+                 */
+                const LatencyHistogram& getAddTimes() const;
+
+                /**
+                 * Return the histogram of the times images waited in the buffer.
+                 *
+                 * @return histogram of the queue times
+                 */
+                const LatencyHistogram& getQueueTimes() const;
+
+                /**
+                 * Reset both histograms.
+                 */
+                void resetTimes();
+
+            private:
+
+                /**
+                 * Convert an image in gray mode, account it and add it to the buffer. The caller holds a slot of the buffer.
+                 *
+                 * @param width     width of the image
+                 * @param height    height of the image
+                 * @param type      type of the image (i.e. OpenCV image types)
+                 * @param data      data of the image
+                 * @return <code>true</code> if the image was added successfully, <code>false</code> otherwise
+                 */
+                bool enqueue(int width, int height, int type, uchar* data);
+
+                /**
+                 * Record an added image.
+                 *
+                 * @param start point in time the producer started to add the image
+                 */
+                void added(std::chrono::steady_clock::time_point start);
+
+                /**
+                 * Mutex of the enqueue times.
+                 */
+                std::mutex timesMutex;
+
+                /**
+                 * Points in time the buffered images were added (oldest first).
+                 */
+                std::deque<std::chrono::steady_clock::time_point> enqueued;
+
+                /**
+                 * Number of images taken out of the buffer before their enqueue time was recorded.
+                 */
+                int unmatched;
+
+                /**
+                 * Number of images taken out of the buffer.
+                 */
+                std::atomic<uint64_t> obtained;
+
+                /**
+                 * Maximum amount of images that can be buffered at the same time.
+                 */
+                int maxImages;
+
+                /**
+                 * Number of buffered images, including the images producers are about to add.
+                 */
+                std::atomic<int> slots;
+
+                /**
+                 * Number of bytes of the buffered images.
+                 */
+                std::atomic<int64_t> bufferedBytes;
+
+                /**
+                 * Indicator to buffer all images in gray.
+                 */
+                std::atomic<bool> grayscale;
+
+                /**
+                 * Histogram of the times producers waited for space in the buffer.
+                 */
+                LatencyHistogram addTimes;
+
+                /**
+                 * Histogram of the times images waited in the buffer.
+                 */
+                LatencyHistogram queueTimes;
+        };
+    }
+}
@@ -0,0 +1,85 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "LatencyHistogram.h"
+
+using namespace CompanionWinRT::Native;
+
+void HistogramSnapshot::merge(const HistogramSnapshot& other)
+{
+    this->buckets.resize(std::max(this->buckets.size(), other.buckets.size()), 0);
+    for (size_t i = 0; i < other.buckets.size(); i++)
+    {
+        this->buckets[i] += other.buckets[i];
+    }
+    this->count += other.count;
+    this->sum += other.sum;
+    this->max = std::max(this->max, other.max);
+}
+
+LatencyHistogram::LatencyHistogram()
+{
+    this->reset();
+}
+
+void LatencyHistogram::record(std::chrono::steady_clock::duration duration)
+{
+    uint64_t microseconds = static_cast<uint64_t>(std::max<long long>(0, std::chrono::duration_cast<std::chrono::microseconds>(duration).count()));
+
+    // The bucket is the number of significant bits
+    int bucket = 0;
+    for (uint64_t value = microseconds; (value > 0) && (bucket < HISTOGRAM_BUCKETS - 1); value >>= 1)
+    {
+        bucket++;
+    }
+
+    this->buckets[bucket].fetch_add(1, std::memory_order_relaxed);
+    this->count.fetch_add(1, std::memory_order_relaxed);
+    this->sum.fetch_add(microseconds, std::memory_order_relaxed);
+
+    uint64_t max = this->max.load(std::memory_order_relaxed);
+    while ((microseconds > max) && !this->max.compare_exchange_weak(max, microseconds, std::memory_order_relaxed))
+    {
+    }
+}
+
+HistogramSnapshot LatencyHistogram::getSnapshot() const
+{
+    HistogramSnapshot snapshot;
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        snapshot.buckets[i] = this->buckets[i].load(std::memory_order_relaxed);
+    }
+    snapshot.count = this->count.load(std::memory_order_relaxed);
+    snapshot.sum = this->sum.load(std::memory_order_relaxed);
+    snapshot.max = this->max.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+void LatencyHistogram::reset()
+{
+    for (int i = 0; i < HISTOGRAM_BUCKETS; i++)
+    {
+        this->buckets[i] = 0;
+    }
+    this->count = 0;
+    this->sum = 0;
+    this->max = 0;
+}
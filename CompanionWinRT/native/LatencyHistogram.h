@@ -0,0 +1,126 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * Number of buckets of a latency histogram.
+         */
+        static const int HISTOGRAM_BUCKETS = 32;
+
+        /**
+         * Copy of the counters of a latency histogram.
+         */
+        struct HistogramSnapshot
+        {
+            /**
+             * Number of durations per bucket. Bucket 0 counts durations below 1 microsecond, bucket i counts durations from 2^(i-1)
+             * to 2^i microseconds (the last bucket counts all longer durations).
+             */
+            std::vector<uint64_t> buckets = std::vector<uint64_t>(HISTOGRAM_BUCKETS, 0);
+
+            /**
+             * Number of recorded durations.
+             */
+            uint64_t count = 0;
+
+            /**
+             * Sum of all recorded durations (in microseconds).
+             */
+            uint64_t sum = 0;
+
+            /**
+             * Longest recorded duration (in microseconds).
+             */
+            uint64_t max = 0;
+
+            /**
+             * Add the counters of another snapshot.
+             *
+             * @param other snapshot to add
+             */
+            void merge(const HistogramSnapshot& other);
+        };
+
+        /**
+         * This class records durations in a lock free histogram with logarithmic buckets.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class LatencyHistogram
+        {
+            public:
+
+                /**
+                 * Create an empty 'LatencyHistogram' object.
+                 */
+                LatencyHistogram();
+
+                /**
+                 * Record a duration.
+                 *
+                 * @param duration  the duration
+                 */
+                void record(std::chrono::steady_clock::duration duration);
+
+                /**
+                 * Return a copy of the counters.
+                 *
+                 * @return copy of the counters
+                 */
+                HistogramSnapshot getSnapshot() const;
+
+                /**
+                 * Reset all counters.
+                 */
+                void reset();
+
+            private:
+
+                /**
+                 * Number of durations per bucket.
+                 */
+                std::atomic<uint64_t> buckets[HISTOGRAM_BUCKETS];
+
+                /**
+                 * Number of recorded durations.
+                 */
+                std::atomic<uint64_t> count;
+
+                /**
+                 * Sum of all recorded durations (in microseconds).
+                 */
+                std::atomic<uint64_t> sum;
+
+                /**
+                 * Longest recorded duration (in microseconds).
+                 */
+                std::atomic<uint64_t> max;
+        };
+    }
+}
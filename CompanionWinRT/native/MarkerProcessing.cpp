@@ -0,0 +1,210 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "MarkerProcessing.h"
+#include "CompanionWinRT/native/PoseResult.h"
+#include "CompanionWinRT/native/RecognitionProcessing.h"
+
+using namespace CompanionWinRT::Native;
+
+/**
+ * Side length of a rectified marker cell (in pixels).
+ */
+static const int CELL_SIZE = 8;
+
+/**
+ * Minimum standard deviation of a rectified marker to be considered (rejects uniform quads).
+ */
+static const double MIN_CONTRAST = 10.0;
+
+MarkerProcessing::MarkerProcessing(Companion::Algorithm::Detection::ShapeDetection* shapeDetection, int markerBits)
+    : markerBits(std::min(8, std::max(3, markerBits)))
+{
+    this->objectDetection = new Companion::Processing::Detection::ObjectDetection(shapeDetection);
+}
+
+MarkerProcessing::~MarkerProcessing()
+{
+    delete this->objectDetection;
+    this->objectDetection = nullptr;
+}
+
+void MarkerProcessing::addMarker(uint64_t markerID, int modelID)
+{
+    std::lock_guard<ContentionMutex> lock(this->markersMutex);
+    this->markers[markerID] = modelID;
+}
+
+void MarkerProcessing::removeMarker(uint64_t markerID)
+{
+    std::lock_guard<ContentionMutex> lock(this->markersMutex);
+    this->markers.erase(markerID);
+}
+
+void MarkerProcessing::clearMarkers()
+{
+    std::lock_guard<ContentionMutex> lock(this->markersMutex);
+    this->markers.clear();
+}
+
+void MarkerProcessing::setRegionMask(const cv::Mat& mask)
+{
+    this->regionMask.set(mask);
+}
+
+std::vector<Companion::Model::Result::Result*> MarkerProcessing::execute(cv::Mat frame)
+{
+    std::vector<Companion::Model::Result::Result*> results;
+    this->work.begin();
+    cv::Rect bounds = this->regionMask.getBounds(frame.size());
+    std::vector<Companion::Model::Result::Result*> shapes;
+    if (bounds.area() > 0)
+    {
+        shapes = this->objectDetection->execute(frame(bounds));
+    }
+    if (shapes.empty())
+    {
+        this->work.finish(results);
+        return results;
+    }
+
+    cv::Mat gray = RecognitionProcessing::toGray(frame);
+
+    std::lock_guard<ContentionMutex> lock(this->markersMutex);
+    size_t included = 0;
+    for (size_t i = 0; i < shapes.size(); i++)
+    {
+        std::vector<cv::Point> polygon = RegionMask::getPolygon(shapes[i], bounds.tl());
+        if (!polygon.empty() && this->regionMask.isIncluded(polygon, frame.size()))
+        {
+            included++;
+            std::vector<cv::Point2f> corners(polygon.begin(), polygon.end());
+
+            // Bring the corners into clockwise order (image coordinates)
+            double area = 0.0;
+            for (size_t j = 0; j < corners.size(); j++)
+            {
+                const cv::Point2f& a = corners[j];
+                const cv::Point2f& b = corners[(j + 1) % corners.size()];
+                area += a.x * b.y - b.x * a.y;
+            }
+            if (area < 0.0)
+            {
+                std::swap(corners[1], corners[3]);
+            }
+
+            uint64_t markerID;
+            int rotation;
+            if (this->decode(gray, corners, markerID, rotation))
+            {
+                auto marker = this->markers.find(markerID);
+                if (marker != this->markers.end())
+                {
+                    // Report the corners in the upright orientation of the marker (model coordinates span the unit square)
+                    std::vector<cv::Point2f> upright = { corners[(4 - rotation) % 4], corners[(5 - rotation) % 4],
+                                                         corners[(6 - rotation) % 4], corners[(7 - rotation) % 4] };
+                    std::vector<cv::Point2f> unitSquare = { cv::Point2f(0.0f, 0.0f), cv::Point2f(1.0f, 0.0f), cv::Point2f(1.0f, 1.0f), cv::Point2f(0.0f, 1.0f) };
+                    cv::Matx33d homography(cv::getPerspectiveTransform(unitSquare, upright));
+                    results.push_back(new PoseResult(100, marker->second, upright, homography));
+                }
+            }
+        }
+        delete shapes[i];
+    }
+    this->work.addContours(shapes.size(), included);
+
+    this->work.finish(results);
+    return results;
+}
+
+bool MarkerProcessing::decode(const cv::Mat& gray, const std::vector<cv::Point2f>& corners, uint64_t& markerID, int& rotation) const
+{
+    int cells = this->markerBits + 2;
+    float side = static_cast<float>(cells * CELL_SIZE);
+
+    // Rectify the quad
+    std::vector<cv::Point2f> target = { cv::Point2f(0.0f, 0.0f), cv::Point2f(side, 0.0f), cv::Point2f(side, side), cv::Point2f(0.0f, side) };
+    cv::Mat rectified;
+    cv::warpPerspective(gray, rectified, cv::getPerspectiveTransform(corners, target), cv::Size(cells * CELL_SIZE, cells * CELL_SIZE), cv::INTER_NEAREST);
+
+    cv::Scalar mean, deviation;
+    cv::meanStdDev(rectified, mean, deviation);
+    if (deviation[0] < MIN_CONTRAST)
+    {
+        return false;
+    }
+    cv::threshold(rectified, rectified, 0, 255, cv::THRESH_BINARY | cv::THRESH_OTSU);
+
+    // Sample the center of every cell (black cells are ones)
+    std::vector<std::vector<int>> grid(cells, std::vector<int>(cells, 0));
+    int margin = CELL_SIZE / 4;
+    for (int row = 0; row < cells; row++)
+    {
+        for (int col = 0; col < cells; col++)
+        {
+            cv::Rect cell(col * CELL_SIZE + margin, row * CELL_SIZE + margin, CELL_SIZE - 2 * margin, CELL_SIZE - 2 * margin);
+            grid[row][col] = (cv::countNonZero(rectified(cell)) * 2 < cell.area()) ? 1 : 0;
+        }
+    }
+
+    // The border must be black
+    for (int i = 0; i < cells; i++)
+    {
+        if (!grid[0][i] || !grid[cells - 1][i] || !grid[i][0] || !grid[i][cells - 1])
+        {
+            return false;
+        }
+    }
+
+    // Read the inner grid in all four orientations (clockwise quarter turns)
+    int bits = this->markerBits;
+    for (rotation = 0; rotation < 4; rotation++)
+    {
+        markerID = 0;
+        for (int row = 0; row < bits; row++)
+        {
+            for (int col = 0; col < bits; col++)
+            {
+                int r = row;
+                int c = col;
+                for (int turn = 0; turn < rotation; turn++)
+                {
+                    int previous = r;
+                    r = bits - 1 - c;
+                    c = previous;
+                }
+                markerID = (markerID << 1) | static_cast<uint64_t>(grid[r + 1][c + 1]);
+            }
+        }
+
+        if (this->markers.count(markerID) > 0)
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+ContentionMutex& MarkerProcessing::getMarkersMutex()
+{
+    return this->markersMutex;
+}
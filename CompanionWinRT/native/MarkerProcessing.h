@@ -0,0 +1,151 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <vector>
+#include <companion/algo/detection/ShapeDetection.h>
+#include <companion/processing/ImageProcessing.h>
+#include <companion/processing/detection/ObjectDetection.h>
+
+#include "CompanionWinRT/native/ContentionMutex.h"
+#include "CompanionWinRT/native/RegionMask.h"
+#include "CompanionWinRT/native/WorkCounter.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class recognizes square fiducial markers. Quad candidates of a shape detection are rectified, the marker cells are
+         * sampled and the inner bit grid is decoded in all four orientations. Decoded marker IDs are mapped to model IDs.
+         *
+         * A marker consists of a black border of one cell and an inner grid of markerBits x markerBits cells. Black cells are
+         * ones, white cells are zeros and the marker ID is the inner grid read row by row (upper left cell as the most significant
+         * bit) in the upright orientation of the marker.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class MarkerProcessing : public Companion::Processing::ImageProcessing
+        {
+            public:
+
+                /**
+                 * Create a 'MarkerProcessing' object.
+                 *
+                 * @param shapeDetection    native shape detection that provides the quad candidates
+                 * @param markerBits        number of inner cells per marker side (3 to 8)
+                 */
+                MarkerProcessing(Companion::Algorithm::Detection::ShapeDetection* shapeDetection, int markerBits);
+
+                /**
+                 * Destruct this instance.
+                 */
+                virtual ~MarkerProcessing();
+
+                /**
+                 * Map a marker ID to a model ID.
+                 *
+                 * @param markerID  ID of the marker (inner bit grid in the upright orientation)
+                 * @param modelID   ID of the model reported for this marker
+                 */
+                void addMarker(uint64_t markerID, int modelID);
+
+                /**
+                 * Remove the mapping of the given marker ID.
+                 *
+                 * @param markerID  ID of the marker
+                 */
+                void removeMarker(uint64_t markerID);
+
+                /**
+                 * Remove all marker mappings.
+                 */
+                void clearMarkers();
+
+                /**
+                 * Set a static region mask. Quads are not searched in excluded regions and quads outside the processed region of the
+                 * mask are not decoded.
+                 *
+                 * @param mask  8-bit mask with non-zero pixels for processed regions (empty to process the whole frame)
+                 */
+                void setRegionMask(const cv::Mat& mask);
+
+                /**
+                 * Recognize markers in the given frame.
+                 *
+                 * @param frame frame to process
+                 * @return recognition results of all mapped markers
+                 */
+                virtual std::vector<Companion::Model::Result::Result*> execute(cv::Mat frame) override;
+
+                /**
+                 * Return the mutex of the marker mapping, which records its wait and hold times.
+                 *
+                 * @return mutex of the marker mapping
+                 */
+                ContentionMutex& getMarkersMutex();
+
+            private:
+
+                /**
+                 * Decode the marker inside the given quad. The caller has to hold the marker mapping lock.
+                 *
+                 * @param gray      gray scale frame
+                 * @param corners   quad corners in clockwise order
+                 * @param markerID  decoded marker ID
+                 * @param rotation  number of clockwise quarter turns to bring the marker upright
+                 * @return <code>true</code> if a valid marker was decoded, <code>false</code> otherwise
+                 */
+                bool decode(const cv::Mat& gray, const std::vector<cv::Point2f>& corners, uint64_t& markerID, int& rotation) const;
+
+                /**
+                 * Native object detection that provides the quad candidates.
+                 */
+                Companion::Processing::Detection::ObjectDetection* objectDetection;
+
+                /**
+                 * Number of inner cells per marker side.
+                 */
+                int markerBits;
+
+                /**
+                 * Mapping of marker IDs to model IDs.
+                 */
+                std::map<uint64_t, int> markers;
+
+                /**
+                 * Mutex to guard the marker mapping.
+                 */
+                ContentionMutex markersMutex;
+
+                /**
+                 * Static region mask of the camera view.
+                 */
+                RegionMask regionMask;
+
+                /**
+                 * Work counters of the current frame.
+                 */
+                WorkCounter work;
+        };
+    }
+}
@@ -0,0 +1,75 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "MatchProcessing.h"
+#include "CompanionWinRT/native/MemoryAccount.h"
+
+using namespace CompanionWinRT::Native;
+
+MatchProcessing::MatchProcessing(FeatureVerification* verification, cv::Size scaling) : RecognitionProcessing(verification), scaling(scaling)
+{
+}
+
+std::vector<Companion::Model::Result::Result*> MatchProcessing::execute(cv::Mat frame)
+{
+    std::vector<Companion::Model::Result::Result*> results;
+    this->work.begin();
+
+    // Scale the frame down to the processing resolution
+    cv::Mat scene = toGray(frame);
+    cv::Mat mask = this->regionMask.get(frame.size());
+    double factor = std::min(1.0, std::min(static_cast<double>(this->scaling.width) / scene.cols, static_cast<double>(this->scaling.height) / scene.rows));
+    if (factor < 1.0)
+    {
+        cv::resize(scene, scene, cv::Size(), factor, factor, cv::INTER_AREA);
+        if (!mask.empty())
+        {
+            cv::resize(mask, mask, scene.size(), 0.0, 0.0, cv::INTER_NEAREST);
+        }
+    }
+
+    // Extract the scene features before taking the model lock, so adding and removing models isn't blocked by the extraction
+    Features sceneFeatures;
+    this->extractSceneFeatures(frame, cv::Rect(0, 0, frame.cols, frame.rows), scene, sceneFeatures, mask);
+
+    std::lock_guard<ContentionMutex> lock(this->modelsMutex);
+    this->frameCounter++;
+    this->compactScene(sceneFeatures);
+    MemoryCharge scratch(MemoryComponent::SCRATCH, MemoryAccount::getBytes(scene) + sceneFeatures.getBytes());
+
+    std::vector<std::pair<Model*, Verification>> recognized = this->verifyModels(this->rankModels(), sceneFeatures);
+    for (size_t i = 0; i < recognized.size(); i++)
+    {
+        // Map the verification back to frame coordinates
+        Verification& verification = recognized[i].second;
+        for (size_t j = 0; j < verification.corners.size(); j++)
+        {
+            verification.corners[j] *= 1.0 / factor;
+        }
+        verification.homography = cv::Mat(cv::Matx33d(1.0 / factor, 0.0, 0.0, 0.0, 1.0 / factor, 0.0, 0.0, 0.0, 1.0)) * verification.homography;
+
+        this->recognized(recognized[i].first);
+        results.push_back(createResult(recognized[i].first->id, verification));
+    }
+
+    this->work.finish(results);
+    return results;
+}
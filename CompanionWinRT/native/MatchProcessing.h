@@ -0,0 +1,60 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "CompanionWinRT/native/RecognitionProcessing.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class recognizes models in a whole frame by feature matching.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class MatchProcessing : public RecognitionProcessing
+        {
+            public:
+
+                /**
+                 * Create a 'MatchProcessing' object.
+                 *
+                 * @param verification  feature verification used to verify models
+                 * @param scaling       maximum resolution for image processing (larger frames are scaled down)
+                 */
+                MatchProcessing(FeatureVerification* verification, cv::Size scaling);
+
+                /**
+                 * Recognize all models in the given frame.
+                 *
+                 * @param frame frame to process
+                 * @return recognition results
+                 */
+                virtual std::vector<Companion::Model::Result::Result*> execute(cv::Mat frame) override;
+
+            private:
+
+                /**
+                 * Maximum resolution for image processing.
+                 */
+                cv::Size scaling;
+        };
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MemoryAccount.h"
+
+using namespace CompanionWinRT::Native;
+
+MemoryAccount::MemoryAccount()
+    : current(0), peak(0)
+{
+}
+
+MemoryAccount& MemoryAccount::get(MemoryComponent component)
+{
+    static MemoryAccount accounts[static_cast<int>(MemoryComponent::COUNT)];
+    return accounts[static_cast<int>(component)];
+}
+
+int64_t MemoryAccount::getBytes(const cv::Mat& image)
+{
+    return static_cast<int64_t>(image.total() * image.elemSize());
+}
+
+void MemoryAccount::add(int64_t bytes)
+{
+    int64_t current = this->current.fetch_add(bytes) + bytes;
+    int64_t peak = this->peak.load();
+    while ((current > peak) && !this->peak.compare_exchange_weak(peak, current))
+    {
+    }
+}
+
+int64_t MemoryAccount::getCurrent() const
+{
+    return this->current;
+}
+
+int64_t MemoryAccount::getPeak() const
+{
+    return this->peak;
+}
+
+void MemoryAccount::resetPeak()
+{
+    this->peak = this->current.load();
+}
+
+MemoryCharge::MemoryCharge(MemoryComponent component, int64_t bytes)
+    : account(MemoryAccount::get(component)), bytes(0)
+{
+    this->add(bytes);
+}
+
+MemoryCharge::~MemoryCharge()
+{
+    this->account.add(-this->bytes);
+}
+
+void MemoryCharge::add(int64_t bytes)
+{
+    this->bytes += bytes;
+    this->account.add(bytes);
+}
@@ -0,0 +1,165 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <opencv2/core/core.hpp>
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * Components whose memory is accounted.
+         */
+        enum class MemoryComponent
+        {
+            STREAM_BUFFERS, ///< Images waiting in image buffers.
+            MODEL_IMAGES, ///< Images kept by models and templates.
+            DESCRIPTORS, ///< Keypoints and descriptors of models.
+            INDEXES, ///< Search structures derived from models (for example cached template spectra).
+            SCRATCH, ///< Per frame working memory of the native processing.
+            RESULT_BUFFERS, ///< Result images and crops handed to the result callback and result publisher rings.
+            COUNT ///< Number of components.
+        };
+
+        /**
+         * This class accounts the current and peak number of bytes of a component. Accounts are process wide.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class MemoryAccount
+        {
+            public:
+
+                /**
+                 * Return the account of a component.
+                 *
+                 * @param component the component
+                 * @return account of the component
+                 */
+                static MemoryAccount& get(MemoryComponent component);
+
+                /**
+                 * Return the number of bytes of an image.
+                 *
+                 * @param image the image
+                 * @return number of bytes of the image data
+                 */
+                static int64_t getBytes(const cv::Mat& image);
+
+                /**
+                 * Add bytes to the account (negative to release bytes).
+                 *
+                 * @param bytes number of bytes
+                 */
+                void add(int64_t bytes);
+
+                /**
+                 * Return the current number of bytes.
+                 *
+                 * @return current number of bytes
+                 */
+                int64_t getCurrent() const;
+
+                /**
+                 * Return the peak number of bytes since the creation or the last reset.
+                 *
+                 * @return peak number of bytes
+                 */
+                int64_t getPeak() const;
+
+                /**
+                 * Reset the peak to the current number of bytes.
+                 */
+                void resetPeak();
+
+            private:
+
+                /**
+                 * Create an empty 'MemoryAccount' object.
+                 */
+                MemoryAccount();
+
+                /**
+                 * Current number of bytes.
+                 */
+                std::atomic<int64_t> current;
+
+                /**
+                 * Peak number of bytes.
+                 */
+                std::atomic<int64_t> peak;
+        };
+
+        /**
+         * This class charges bytes to an account for the lifetime of the charge, for example working memory of a processed frame.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class MemoryCharge
+        {
+            public:
+
+                /**
+                 * Charge bytes to the account of a component.
+                 *
+                 * @param component the component
+                 * @param bytes     number of bytes
+                 */
+                MemoryCharge(MemoryComponent component, int64_t bytes);
+
+                /**
+                 * Release the charged bytes.
+                 */
+                ~MemoryCharge();
+
+                /**
+                 * Charge additional bytes.
+                 *
+                 * @param bytes number of bytes
+                 */
+                void add(int64_t bytes);
+
+            private:
+
+                /**
+                 * The account the bytes are charged to.
+                 */
+                MemoryAccount& account;
+
+                /**
+                 * Number of charged bytes.
+                 */
+                int64_t bytes;
+
+                /**
+                 * Charges can't be copied (the bytes would be released twice).
+                 */
+                MemoryCharge(const MemoryCharge&) = delete;
+
+                /**
+                 * Charges can't be copied (the bytes would be released twice).
+                 */
+                MemoryCharge& operator=(const MemoryCharge&) = delete;
+        };
+    }
+}
@@ -0,0 +1,58 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ModelTags.h"
+
+using namespace CompanionWinRT::Native;
+
+void ModelTags::setTag(int id, const std::string& tag)
+{
+    std::lock_guard<std::mutex> lock(this->tagsMutex);
+    this->tags[id] = tag;
+}
+
+void ModelTags::removeTag(int id)
+{
+    std::lock_guard<std::mutex> lock(this->tagsMutex);
+    this->tags.erase(id);
+}
+
+void ModelTags::clear()
+{
+    std::lock_guard<std::mutex> lock(this->tagsMutex);
+    this->tags.clear();
+}
+
+void ModelTags::setActiveTags(const std::set<std::string>& tags)
+{
+    std::lock_guard<std::mutex> lock(this->tagsMutex);
+    this->activeTags = tags;
+}
+
+bool ModelTags::isActive(int id)
+{
+    std::lock_guard<std::mutex> lock(this->tagsMutex);
+
+    if (this->activeTags.empty())
+    {
+        return true;
+    }
+
+    std::map<int, std::string>::const_iterator tag = this->tags.find(id);
+    return (tag != this->tags.end()) && (this->activeTags.count(tag->second) > 0);
+}
@@ -0,0 +1,95 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class assigns tags (groups) to model IDs and keeps track of the currently active tags.
+         *
+         * A model is active if no tags are selected or if its tag is one of the selected tags. Changing the active tags takes effect
+         * with the next processed frame and does not require to add the models again.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class ModelTags
+        {
+            public:
+
+                /**
+                 * Assign a tag to a model ID.
+                 *
+                 * @param id    the ID of the model
+                 * @param tag   tag of the model (an empty tag is only active if no tags are selected)
+                 */
+                void setTag(int id, const std::string& tag);
+
+                /**
+                 * Remove the tag of a model ID.
+                 *
+                 * @param id    the ID of the model
+                 */
+                void removeTag(int id);
+
+                /**
+                 * Remove all tags.
+                 */
+                void clear();
+
+                /**
+                 * Select the active tags.
+                 *
+                 * @param tags  active tags (an empty set activates all models)
+                 */
+                void setActiveTags(const std::set<std::string>& tags);
+
+                /**
+                 * Check whether the model with the given ID is active.
+                 *
+                 * @param id    the ID of the model
+                 * @return <code>true</code> if the model is active, <code>false</code> otherwise
+                 */
+                bool isActive(int id);
+
+            private:
+
+                /**
+                 * Tags of all model IDs.
+                 */
+                std::map<int, std::string> tags;
+
+                /**
+                 * Active tags (empty if all models are active).
+                 */
+                std::set<std::string> activeTags;
+
+                /**
+                 * Lock for the tags.
+                 */
+                std::mutex tagsMutex;
+        };
+    }
+}
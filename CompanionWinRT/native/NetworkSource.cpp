@@ -0,0 +1,454 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <opencv2/imgcodecs/imgcodecs.hpp>
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+#include "NetworkSource.h"
+
+using namespace CompanionWinRT::Native;
+
+/**
+ * Size of the receive buffer (in bytes).
+ */
+static const size_t BUFFER_SIZE = 64 * 1024;
+
+/**
+ * Maximum size of a single frame (in bytes), protects against corrupt length fields.
+ */
+static const size_t MAX_FRAME_SIZE = 64 * 1024 * 1024;
+
+/**
+ * Marker of a closed connection.
+ */
+static const uintptr_t NO_CONNECTION = static_cast<uintptr_t>(INVALID_SOCKET);
+
+/**
+ * Read an unsigned 32-bit big endian integer.
+ *
+ * @param data  first byte of the integer
+ * @return the integer
+ */
+static uint32_t readBigEndian(const uint8_t* data)
+{
+    return (static_cast<uint32_t>(data[0]) << 24) | (static_cast<uint32_t>(data[1]) << 16) | (static_cast<uint32_t>(data[2]) << 8) | data[3];
+}
+
+NetworkSource::NetworkSource(ImageBuffer* stream, StreamGate* gate, const std::string& host, int port, const std::string& path, NetworkProtocol protocol,
+                             int decodeThreads)
+    : stream(stream), gate(gate), host(host), port(port), path(path.empty() ? "/" : path), protocol(protocol), decodeThreads(std::max(1, decodeThreads)),
+      connection(NO_CONNECTION), bufferPosition(0), running(false), lastAdded(0), received(0), added(0), dropped(0)
+{
+    WSADATA wsaData;
+    WSAStartup(MAKEWORD(2, 2), &wsaData);
+}
+
+NetworkSource::~NetworkSource()
+{
+    this->stop();
+    WSACleanup();
+}
+
+bool NetworkSource::start()
+{
+    if (this->running)
+    {
+        return true;
+    }
+
+    // Connect to the frame server
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(this->host.c_str(), std::to_string(this->port).c_str(), &hints, &addresses) != 0)
+    {
+        return false;
+    }
+
+    SOCKET socket = INVALID_SOCKET;
+    for (addrinfo* address = addresses; (address != nullptr) && (socket == INVALID_SOCKET); address = address->ai_next)
+    {
+        socket = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if ((socket != INVALID_SOCKET) && (connect(socket, address->ai_addr, static_cast<int>(address->ai_addrlen)) == SOCKET_ERROR))
+        {
+            closesocket(socket);
+            socket = INVALID_SOCKET;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (socket == INVALID_SOCKET)
+    {
+        return false;
+    }
+
+    if (this->protocol == NetworkProtocol::MJPEG)
+    {
+        std::string request = "GET " + this->path + " HTTP/1.1\r\nHost: " + this->host + "\r\nConnection: close\r\n\r\n";
+        if (send(socket, request.c_str(), static_cast<int>(request.size()), 0) == SOCKET_ERROR)
+        {
+            closesocket(socket);
+            return false;
+        }
+    }
+
+    this->connection = static_cast<uintptr_t>(socket);
+    this->buffer.clear();
+    this->bufferPosition = 0;
+    this->lastAdded = 0;
+    this->running = true;
+
+    for (int i = 0; i < this->decodeThreads; i++)
+    {
+        this->decoders.push_back(std::thread(&NetworkSource::decode, this));
+    }
+    this->receiver = std::thread(&NetworkSource::receive, this);
+
+    return true;
+}
+
+void NetworkSource::stop()
+{
+    {
+        // Decoders check the indicator under the packet lock, so they can't miss the wakeup
+        std::lock_guard<std::mutex> lock(this->packetsMutex);
+        this->running = false;
+    }
+
+    // Unblock the receiver
+    SOCKET socket = static_cast<SOCKET>(this->connection.exchange(NO_CONNECTION));
+    if (socket != INVALID_SOCKET)
+    {
+        shutdown(socket, SD_BOTH);
+    }
+    if (this->receiver.joinable())
+    {
+        this->receiver.join();
+    }
+    if (socket != INVALID_SOCKET)
+    {
+        closesocket(socket);
+    }
+
+    this->packetsCondition.notify_all();
+    for (size_t i = 0; i < this->decoders.size(); i++)
+    {
+        this->decoders[i].join();
+    }
+    this->decoders.clear();
+    this->packets.clear();
+}
+
+uint64_t NetworkSource::getReceived() const
+{
+    return this->received;
+}
+
+uint64_t NetworkSource::getAdded() const
+{
+    return this->added;
+}
+
+uint64_t NetworkSource::getDropped() const
+{
+    return this->dropped;
+}
+
+void NetworkSource::receive()
+{
+    switch (this->protocol)
+    {
+        case NetworkProtocol::MJPEG:
+            this->receiveMJPEG();
+            break;
+        case NetworkProtocol::RAW:
+            this->receiveRaw();
+            break;
+    }
+}
+
+void NetworkSource::receiveMJPEG()
+{
+    // Status line and response headers
+    std::string line;
+    if (!this->readLine(line) || (line.find(" 200") == std::string::npos))
+    {
+        return;
+    }
+
+    std::string boundary;
+    while (this->readLine(line) && !line.empty())
+    {
+        std::string header = line;
+        std::transform(header.begin(), header.end(), header.begin(), ::tolower);
+        size_t position = header.find("boundary=");
+        if ((header.compare(0, 13, "content-type:") == 0) && (position != std::string::npos))
+        {
+            boundary = line.substr(position + 9);
+            boundary.erase(std::remove(boundary.begin(), boundary.end(), '"'), boundary.end());
+            if (boundary.compare(0, 2, "--") != 0)
+            {
+                boundary = "--" + boundary;
+            }
+        }
+    }
+    if (boundary.empty())
+    {
+        return;
+    }
+
+    while (this->running)
+    {
+        // Skip to the next part
+        bool found = false;
+        while (!found && this->readLine(line))
+        {
+            found = (line.compare(0, boundary.size(), boundary) == 0);
+        }
+        if (!found)
+        {
+            return;
+        }
+
+        // Part headers
+        size_t contentLength = 0;
+        while (this->readLine(line) && !line.empty())
+        {
+            std::string header = line;
+            std::transform(header.begin(), header.end(), header.begin(), ::tolower);
+            if (header.compare(0, 15, "content-length:") == 0)
+            {
+                contentLength = static_cast<size_t>(std::strtoull(header.c_str() + 15, nullptr, 10));
+            }
+        }
+
+        Packet packet;
+        packet.width = 0;
+        packet.height = 0;
+        packet.type = 0;
+        if (contentLength > 0)
+        {
+            if (contentLength > MAX_FRAME_SIZE)
+            {
+                return;
+            }
+            packet.data.resize(contentLength);
+            if (!this->readExact(packet.data.data(), contentLength))
+            {
+                return;
+            }
+        }
+        else
+        {
+            // Without a content length the JPEG ends with its end of image marker
+            uint8_t byte;
+            while (this->readByte(byte))
+            {
+                packet.data.push_back(byte);
+                size_t size = packet.data.size();
+                if (((size >= 2) && (packet.data[size - 2] == 0xFF) && (byte == 0xD9)) || (size > MAX_FRAME_SIZE))
+                {
+                    break;
+                }
+            }
+        }
+
+        this->dispatch(std::move(packet));
+    }
+}
+
+void NetworkSource::receiveRaw()
+{
+    uint8_t header[16];
+    while (this->running && this->readExact(header, sizeof(header)))
+    {
+        size_t length = readBigEndian(header);
+        if (length > MAX_FRAME_SIZE)
+        {
+            return;
+        }
+
+        Packet packet;
+        packet.width = static_cast<int>(readBigEndian(header + 4));
+        packet.height = static_cast<int>(readBigEndian(header + 8));
+        packet.type = static_cast<int>(readBigEndian(header + 12));
+        packet.data.resize(length);
+        if (!this->readExact(packet.data.data(), length))
+        {
+            return;
+        }
+
+        this->dispatch(std::move(packet));
+    }
+}
+
+void NetworkSource::dispatch(Packet&& packet)
+{
+    packet.number = this->received++;
+
+    std::lock_guard<std::mutex> lock(this->packetsMutex);
+    if (this->packets.size() >= static_cast<size_t>(this->decodeThreads))
+    {
+        // All decoders are busy: drop the oldest waiting frame to stay live
+        this->packets.pop_front();
+        this->dropped++;
+    }
+    this->packets.push_back(std::move(packet));
+    this->packetsCondition.notify_one();
+}
+
+void NetworkSource::decode()
+{
+    while (true)
+    {
+        Packet packet;
+        {
+            std::unique_lock<std::mutex> lock(this->packetsMutex);
+            this->packetsCondition.wait(lock, [this]() { return !this->running || !this->packets.empty(); });
+            if (!this->running)
+            {
+                return;
+            }
+            packet = std::move(this->packets.front());
+            this->packets.pop_front();
+        }
+
+        // Corrupt frames are dropped, an exception must not end the decoder thread
+        cv::Mat image;
+        try
+        {
+            if ((packet.width == 0) || (packet.height == 0))
+            {
+                // JPEG frames are decoded without chroma in gray mode
+                image = cv::imdecode(packet.data, this->stream->isGrayscale() ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR);
+            }
+            else if (isValidRaw(packet))
+            {
+                image = cv::Mat(packet.height, packet.width, packet.type, packet.data.data());
+            }
+        }
+        catch (const cv::Exception&)
+        {
+            image.release();
+        }
+
+        // Frames decoded after a newer frame are late, frames the stream can't take right now are dropped. Adding doesn't block,
+        // so the add lock only orders the decoders and never stalls the receiver or the other decoders on a full stream.
+        std::lock_guard<std::mutex> lock(this->addMutex);
+        bool added = false;
+        if (!image.empty() && (packet.number >= this->lastAdded) && this->gate->enter())
+        {
+            added = this->stream->tryAddImage(image.cols, image.rows, image.type(), image.data);
+            this->gate->leave();
+        }
+
+        if (!added)
+        {
+            this->dropped++;
+        }
+        else
+        {
+            this->lastAdded = packet.number + 1;
+            this->added++;
+        }
+    }
+}
+
+bool NetworkSource::isValidRaw(const Packet& packet)
+{
+    // Only 8-bit gray, BGR and BGRA frames are accepted
+    if (((packet.type != CV_8UC1) && (packet.type != CV_8UC3) && (packet.type != CV_8UC4)) || (packet.width <= 0) || (packet.height <= 0))
+    {
+        return false;
+    }
+
+    // The dimensions come from the network, so the frame size is compared without overflow
+    uint64_t pixels = static_cast<uint64_t>(packet.width) * static_cast<uint64_t>(packet.height);
+    return pixels <= packet.data.size() / CV_ELEM_SIZE(packet.type);
+}
+
+bool NetworkSource::readExact(uint8_t* data, size_t size)
+{
+    // Take buffered bytes first, then read the rest directly
+    size_t buffered = std::min(size, this->buffer.size() - this->bufferPosition);
+    std::copy(this->buffer.begin() + this->bufferPosition, this->buffer.begin() + this->bufferPosition + buffered, data);
+    this->bufferPosition += buffered;
+
+    SOCKET socket = static_cast<SOCKET>(this->connection.load());
+    for (size_t position = buffered; position < size;)
+    {
+        int count = recv(socket, reinterpret_cast<char*>(data + position), static_cast<int>(std::min<size_t>(size - position, BUFFER_SIZE)), 0);
+        if (count <= 0)
+        {
+            return false;
+        }
+        position += count;
+    }
+
+    return true;
+}
+
+bool NetworkSource::readLine(std::string& line)
+{
+    line.clear();
+
+    uint8_t byte;
+    while (this->readByte(byte))
+    {
+        if (byte == '\n')
+        {
+            if (!line.empty() && (line.back() == '\r'))
+            {
+                line.pop_back();
+            }
+            return true;
+        }
+        line.push_back(static_cast<char>(byte));
+    }
+
+    return false;
+}
+
+bool NetworkSource::readByte(uint8_t& byte)
+{
+    if (this->bufferPosition >= this->buffer.size())
+    {
+        this->buffer.resize(BUFFER_SIZE);
+        int count = recv(static_cast<SOCKET>(this->connection.load()), reinterpret_cast<char*>(this->buffer.data()), static_cast<int>(BUFFER_SIZE), 0);
+        if (count <= 0)
+        {
+            this->buffer.clear();
+            this->bufferPosition = 0;
+            return false;
+        }
+        this->buffer.resize(count);
+        this->bufferPosition = 0;
+    }
+
+    byte = this->buffer[this->bufferPosition++];
+    return true;
+}
@@ -0,0 +1,313 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CompanionWinRT/native/ImageBuffer.h"
+#include "CompanionWinRT/native/StreamGate.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * Wire protocols of a network frame source.
+         */
+        enum class NetworkProtocol
+        {
+            MJPEG, ///< Multipart MJPEG over HTTP (multipart/x-mixed-replace).
+            RAW ///< Length-prefixed frames, see 'NetworkSource'.
+        };
+
+        /**
+         * This class receives frames from a TCP socket and feeds them into an image stream.
+         *
+         * Received frames are decoded on a pool of decoder threads. Frames are dropped instead of queued if all decoders are busy or
+         * if the image stream is full, so the source never falls behind a saturated pipeline.
+         *
+         * Raw frames are prefixed by a header of four unsigned 32-bit big endian integers: payload length, width, height and OpenCV
+         * image type. A width or height of 0 marks an encoded payload (for example JPEG or PNG), otherwise the payload contains the
+         * raw pixel data.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class NetworkSource
+        {
+            public:
+
+                /**
+                 * Create a 'NetworkSource' object.
+                 *
+                 * @param stream            image stream the received frames are added to
+                 * @param gate              gate of the producers of the image stream
+                 * @param host              host name or address of the frame server
+                 * @param port              TCP port of the frame server
+                 * @param path              request path (MJPEG only)
+                 * @param protocol          wire protocol of the frame server
+                 * @param decodeThreads     number of decoder threads
+                 */
+                NetworkSource(ImageBuffer* stream, StreamGate* gate, const std::string& host, int port, const std::string& path, NetworkProtocol protocol, int decodeThreads);
+
+                /**
+                 * Stop receiving and destruct this instance.
+                 */
+                ~NetworkSource();
+
+                /**
+                 * Connect to the frame server and start receiving frames.
+                 *
+                 * @return <code>true</code> if the connection was established, <code>false</code> otherwise
+                 */
+                bool start();
+
+                /**
+                 * Disconnect from the frame server and stop all threads.
+                 */
+                void stop();
+
+                /**
+                 * Return the number of received frames.
+                 *
+                 * @return number of received frames
+                 */
+                uint64_t getReceived() const;
+
+                /**
+                 * Return the number of frames added to the image stream.
+                 *
+                 * @return number of added frames
+                 */
+                uint64_t getAdded() const;
+
+                /**
+                 * Return the number of dropped frames (busy decoders, full image stream, late or undecodable frames).
+                 *
+                 * @return number of dropped frames
+                 */
+                uint64_t getDropped() const;
+
+            private:
+
+                /**
+                 * A received frame waiting for a decoder.
+                 */
+                struct Packet
+                {
+                    /**
+                     * Receive order of the frame.
+                     */
+                    uint64_t number;
+
+                    /**
+                     * Frame width (0 for encoded frames).
+                     */
+                    int width;
+
+                    /**
+                     * Frame height (0 for encoded frames).
+                     */
+                    int height;
+
+                    /**
+                     * OpenCV image type of raw frames.
+                     */
+                    int type;
+
+                    /**
+                     * Frame data.
+                     */
+                    std::vector<uint8_t> data;
+                };
+
+                /**
+                 * Receive frames until the source is stopped or the connection is closed.
+                 */
+                void receive();
+
+                /**
+                 * Receive multipart MJPEG frames.
+                 */
+                void receiveMJPEG();
+
+                /**
+                 * Receive length-prefixed raw frames.
+                 */
+                void receiveRaw();
+
+                /**
+                 * Decode frames and add them to the image stream.
+                 */
+                void decode();
+
+                /**
+                 * Check whether a raw frame has a supported type, positive dimensions and enough data for its dimensions.
+                 *
+                 * @param packet    received raw frame
+                 * @return <code>true</code> if the frame can be added, <code>false</code> otherwise
+                 */
+                static bool isValidRaw(const Packet& packet);
+
+                /**
+                 * Hand a received frame to the decoders or drop it if all decoders are busy.
+                 *
+                 * @param packet    received frame
+                 */
+                void dispatch(Packet&& packet);
+
+                /**
+                 * Read exactly the given number of bytes from the socket.
+                 *
+                 * @param data  buffer for the bytes
+                 * @param size  number of bytes
+                 * @return <code>true</code> if all bytes were read, <code>false</code> if the connection was closed
+                 */
+                bool readExact(uint8_t* data, size_t size);
+
+                /**
+                 * Read a line (terminated by CRLF or LF) from the socket.
+                 *
+                 * @param line  the line without its terminator
+                 * @return <code>true</code> if a line was read, <code>false</code> if the connection was closed
+                 */
+                bool readLine(std::string& line);
+
+                /**
+                 * Read a single byte from the socket.
+                 *
+                 * @param byte  the byte
+                 * @return <code>true</code> if a byte was read, <code>false</code> if the connection was closed
+                 */
+                bool readByte(uint8_t& byte);
+
+                /**
+                 * Image stream the received frames are added to.
+                 */
+                ImageBuffer* stream;
+
+                /**
+                 * Gate of the producers of the image stream.
+                 */
+                StreamGate* gate;
+
+                /**
+                 * Host name or address of the frame server.
+                 */
+                std::string host;
+
+                /**
+                 * TCP port of the frame server.
+                 */
+                int port;
+
+                /**
+                 * Request path (MJPEG only).
+                 */
+                std::string path;
+
+                /**
+                 * Wire protocol of the frame server.
+                 */
+                NetworkProtocol protocol;
+
+                /**
+                 * Number of decoder threads.
+                 */
+                int decodeThreads;
+
+                /**
+                 * Socket of the connection (a Winsock 'SOCKET', ~0 if not connected).
+                 */
+                std::atomic<uintptr_t> connection;
+
+                /**
+                 * Receive buffer.
+                 */
+                std::vector<uint8_t> buffer;
+
+                /**
+                 * Read position in the receive buffer.
+                 */
+                size_t bufferPosition;
+
+                /**
+                 * Indicator that the source is running.
+                 */
+                std::atomic<bool> running;
+
+                /**
+                 * Receiver thread.
+                 */
+                std::thread receiver;
+
+                /**
+                 * Decoder threads.
+                 */
+                std::vector<std::thread> decoders;
+
+                /**
+                 * Frames waiting for a decoder (at most one per decoder).
+                 */
+                std::deque<Packet> packets;
+
+                /**
+                 * Lock for the waiting frames.
+                 */
+                std::mutex packetsMutex;
+
+                /**
+                 * Signals waiting frames to the decoders.
+                 */
+                std::condition_variable packetsCondition;
+
+                /**
+                 * Lock that orders the decoders adding frames to the image stream (separate from the waiting frames, adding never blocks).
+                 */
+                std::mutex addMutex;
+
+                /**
+                 * Receive order of the last frame added to the image stream.
+                 */
+                std::atomic<uint64_t> lastAdded;
+
+                /**
+                 * Number of received frames.
+                 */
+                std::atomic<uint64_t> received;
+
+                /**
+                 * Number of frames added to the image stream.
+                 */
+                std::atomic<uint64_t> added;
+
+                /**
+                 * Number of dropped frames.
+                 */
+                std::atomic<uint64_t> dropped;
+        };
+    }
+}
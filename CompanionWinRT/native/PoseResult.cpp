@@ -0,0 +1,47 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PoseResult.h"
+
+using namespace CompanionWinRT::Native;
+
+PoseResult::PoseResult(int score, int id, const std::vector<cv::Point2f>& corners, const cv::Matx33d& homography)
+    : Companion::Model::Result::RecognitionResult(score, id, new Companion::Draw::Frame(corners[0], corners[1], corners[3], corners[2])),
+      homography(homography), corners(corners)
+{
+}
+
+const cv::Matx33d& PoseResult::getHomography() const
+{
+    return this->homography;
+}
+
+const std::vector<cv::Point2f>& PoseResult::getCorners() const
+{
+    return this->corners;
+}
+
+void PoseResult::setWork(std::shared_ptr<const FrameWork> work)
+{
+    this->work = work;
+}
+
+std::shared_ptr<const FrameWork> PoseResult::getWork() const
+{
+    return this->work;
+}
@@ -0,0 +1,99 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <vector>
+#include <opencv2/core/core.hpp>
+#include <companion/draw/Frame.h>
+#include <companion/model/result/RecognitionResult.h>
+
+#include "CompanionWinRT/native/WorkCounter.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class is a recognition result that keeps the estimated pose of the model: the homography from model to frame
+         * coordinates and the sub-pixel corners, which the frame of the result only provides rounded to pixels.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class PoseResult : public Companion::Model::Result::RecognitionResult
+        {
+            public:
+
+                /**
+                 * Create a 'PoseResult' object with a frame of the rounded corners.
+                 *
+                 * @param score         recognition score (0% - 100%)
+                 * @param id            the ID of the recognized model
+                 * @param corners       sub-pixel model corners in the frame (upper left, upper right, lower right, lower left)
+                 * @param homography    homography from model to frame coordinates
+                 */
+                PoseResult(int score, int id, const std::vector<cv::Point2f>& corners, const cv::Matx33d& homography);
+
+                /**
+                 * Return the homography from model to frame coordinates.
+                 *
+                 * @return homography from model to frame coordinates
+                 */
+                const cv::Matx33d& getHomography() const;
+
+                /**
+                 * Return the sub-pixel model corners in the frame.
+                 *
+                 * @return sub-pixel model corners (upper left, upper right, lower right, lower left)
+                 */
+                const std::vector<cv::Point2f>& getCorners() const;
+
+                /**
+                 * Attach the work of the frame this result was recognized in.
+                 *
+                 * @param work  work of the frame (shared by all results of the frame)
+                 */
+                void setWork(std::shared_ptr<const FrameWork> work);
+
+                /**
+                 * Return the work of the frame this result was recognized in.
+                 *
+                 * @return work of the frame (nullptr if the processing doesn't count its work)
+                 */
+                std::shared_ptr<const FrameWork> getWork() const;
+
+            private:
+
+                /**
+                 * Homography from model to frame coordinates.
+                 */
+                cv::Matx33d homography;
+
+                /**
+                 * Sub-pixel model corners in the frame.
+                 */
+                std::vector<cv::Point2f> corners;
+
+                /**
+                 * Work of the frame this result was recognized in.
+                 */
+                std::shared_ptr<const FrameWork> work;
+        };
+    }
+}
@@ -0,0 +1,177 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "ProcessingSession.h"
+#include "CompanionWinRT/native/RecognitionProcessing.h"
+#include "CompanionWinRT/native/SceneFeatureCache.h"
+
+using namespace CompanionWinRT::Native;
+
+/**
+ * Convert a frame into the color format of the result images. Frames are BGR, BGRA or gray (in the gray mode of the image buffer
+ * or if gray images were added), so the conversion is chosen by the channels of every frame.
+ *
+ * @param frame         the processed frame
+ * @param colorFormat   color format of the result image
+ * @return result image (the frame itself if no conversion is needed)
+ */
+static cv::Mat convertFrame(const cv::Mat& frame, Companion::ColorFormat colorFormat)
+{
+    // Conversion codes of gray, BGR and BGRA frames into RGB, RGBA, BGR and BGRA (-1 for no conversion)
+    static const int codes[3][4] = { { cv::COLOR_GRAY2RGB, cv::COLOR_GRAY2RGBA, cv::COLOR_GRAY2BGR, cv::COLOR_GRAY2BGRA },
+                                     { cv::COLOR_BGR2RGB, cv::COLOR_BGR2RGBA, -1, cv::COLOR_BGR2BGRA },
+                                     { cv::COLOR_BGRA2RGB, cv::COLOR_BGRA2RGBA, cv::COLOR_BGRA2BGR, -1 } };
+
+    int format;
+    switch (colorFormat)
+    {
+        case Companion::ColorFormat::RGB:
+            format = 0;
+            break;
+        case Companion::ColorFormat::RGBA:
+            format = 1;
+            break;
+        case Companion::ColorFormat::BGR:
+            format = 2;
+            break;
+        case Companion::ColorFormat::BGRA:
+            format = 3;
+            break;
+        default:
+            return RecognitionProcessing::toGray(frame);
+    }
+
+    int channels = (frame.channels() == 1) ? 0 : ((frame.channels() == 3) ? 1 : ((frame.channels() == 4) ? 2 : -1));
+    if ((channels < 0) || (codes[channels][format] < 0))
+    {
+        return frame;
+    }
+
+    cv::Mat image;
+    cv::cvtColor(frame, image, codes[channels][format]);
+    return image;
+}
+
+ProcessingSession::ProcessingSession() : processing(nullptr), stream(nullptr), gate(nullptr), resultColorFormat(Companion::ColorFormat::RGB), grayscale(false)
+{
+}
+
+void ProcessingSession::setProcessing(Companion::Processing::ImageProcessing* processing)
+{
+    this->processing = processing;
+    this->configuration.setProcessing(processing);
+}
+
+void ProcessingSession::setSource(ImageBuffer* stream, StreamGate* gate)
+{
+    this->stream = stream;
+    this->gate = gate;
+    this->configuration.setSource(stream);
+}
+
+void ProcessingSession::setImageBuffer(int imageBuffer)
+{
+    this->configuration.setImageBuffer(imageBuffer);
+}
+
+void ProcessingSession::setSkipFrame(int skipFrame)
+{
+    this->configuration.setSkipFrame(skipFrame);
+}
+
+int ProcessingSession::getSkipFrame()
+{
+    return this->configuration.getSkipFrame();
+}
+
+void ProcessingSession::setResultHandler(const ResultHandler& handler, Companion::ColorFormat colorFormat, bool grayscale)
+{
+    std::atomic_store(&this->resultHandler, handler ? std::make_shared<ResultHandler>(handler) : std::shared_ptr<ResultHandler>());
+    this->resultColorFormat = colorFormat;
+    this->grayscale = grayscale;
+}
+
+void ProcessingSession::setErrorHandler(const ErrorHandler& handler)
+{
+    std::atomic_store(&this->errorHandler, handler ? std::make_shared<ErrorHandler>(handler) : std::shared_ptr<ErrorHandler>());
+}
+
+void ProcessingSession::run()
+{
+    this->applyHandlers();
+    if (this->gate != nullptr)
+    {
+        this->gate->open();
+    }
+
+    this->configuration.run();
+}
+
+void ProcessingSession::stop()
+{
+    this->configuration.stop();
+    if ((this->gate != nullptr) && (this->stream != nullptr))
+    {
+        ImageBuffer* stream = this->stream;
+        this->gate->close([stream]()
+        {
+            // Taking an image out of the buffer wakes up a blocked producer (an empty buffer yields an empty image)
+            stream->obtainImage();
+        });
+    }
+
+    // Cached scene features keep their frames alive, the entries of other sessions are kept
+    if (this->processing != nullptr)
+    {
+        SceneFeatureCache::get().clear(this->processing);
+    }
+}
+
+void ProcessingSession::applyHandlers()
+{
+    // The handlers look up the current handlers of this session, so they can be replaced without touching the running configuration.
+    // Frames are taken unconverted and converted here, gray frames of a gray image buffer can't be converted as BGR frames.
+    Companion::ColorFormat colorFormat = this->grayscale ? Companion::ColorFormat::GRAY : this->resultColorFormat.load();
+    this->configuration.setResultHandler([this, colorFormat](std::vector<Companion::Model::Result::Result*> results, cv::Mat image)
+    {
+        // The work of the frame travels with its results, the handlers only get the results of the processing
+        std::shared_ptr<const FrameWork> work = WorkCounter::take(results);
+
+        std::shared_ptr<ResultHandler> handler = std::atomic_load(&this->resultHandler);
+        if (handler == nullptr)
+        {
+            image.release();
+            return;
+        }
+
+        cv::Mat converted = convertFrame(image, colorFormat);
+        image.release();
+        (*handler)(results, converted, work);
+    }, Companion::ColorFormat::BGR);
+
+    this->configuration.setErrorHandler([this](Companion::Error::Code code)
+    {
+        std::shared_ptr<ErrorHandler> handler = std::atomic_load(&this->errorHandler);
+        if (handler != nullptr)
+        {
+            (*handler)(code);
+        }
+    });
+}
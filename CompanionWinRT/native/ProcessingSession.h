@@ -0,0 +1,179 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include <companion/Configuration.h>
+
+#include "CompanionWinRT/native/ImageBuffer.h"
+#include "CompanionWinRT/native/StreamGate.h"
+#include "CompanionWinRT/native/WorkCounter.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class runs a native processing on an image buffer and dispatches its results and errors.
+         *
+         * Producers pass the gate of the stream, so stopping the processing releases all producers that are blocked by a full image
+         * buffer (see 'StreamGate'). Result and error handlers can be replaced at any time, the handlers installed in the native
+         * configuration look up the current ones for every frame. A new result color format is used from the next start of the
+         * processing.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class ProcessingSession
+        {
+            public:
+
+                /**
+                 * Function that handles the results, the image and the work of a frame. The work is passed once per frame, also for
+                 * frames without results (nullptr if the processing doesn't count its work).
+                 */
+                using ResultHandler = std::function<void(std::vector<Companion::Model::Result::Result*>&, cv::Mat&,
+                                                         const std::shared_ptr<const FrameWork>&)>;
+
+                /**
+                 * Function that handles an error of the processing.
+                 */
+                using ErrorHandler = std::function<void(Companion::Error::Code)>;
+
+                /**
+                 * Create a 'ProcessingSession' object without a processing and a source.
+                 */
+                ProcessingSession();
+
+                /**
+                 * Set the processing of the frames.
+                 *
+                 * @param processing    native processing
+                 */
+                void setProcessing(Companion::Processing::ImageProcessing* processing);
+
+                /**
+                 * Set the source of the frames.
+                 *
+                 * @param stream    image buffer of the frames
+                 * @param gate      gate of the producers of the image buffer
+                 */
+                void setSource(ImageBuffer* stream, StreamGate* gate);
+
+                /**
+                 * Set the maximum number of buffered images of the processing.
+                 *
+                 * @param imageBuffer   maximum number of buffered images
+                 */
+                void setImageBuffer(int imageBuffer);
+
+                /**
+                 * Set the number of frames to skip between two processed frames.
+                 *
+                 * @param skipFrame number of frames to skip
+                 */
+                void setSkipFrame(int skipFrame);
+
+                /**
+                 * Return the number of frames to skip between two processed frames.
+                 *
+                 * @return number of frames to skip
+                 */
+                int getSkipFrame();
+
+                /**
+                 * Set the result handler. Frames are taken unconverted and converted once by their channels, so gray frames (of a gray
+                 * image buffer) are passed on as they are in gray mode and converted to the color format otherwise.
+                 *
+                 * @param handler       result handler (empty to release the frames without handling them)
+                 * @param colorFormat   color format of the result images (ignored in gray mode)
+                 * @param grayscale     <code>true</code> to pass gray result images, <code>false</code> otherwise
+                 */
+                void setResultHandler(const ResultHandler& handler, Companion::ColorFormat colorFormat, bool grayscale);
+
+                /**
+                 * Set the error handler.
+                 *
+                 * @param handler   error handler (empty to ignore errors)
+                 */
+                void setErrorHandler(const ErrorHandler& handler);
+
+                /**
+                 * Open the gate of the stream and run the processing until it is stopped (blocks). Errors of the native
+                 * configuration are thrown as 'Companion::Error::Code'.
+                 */
+                void run();
+
+                /**
+                 * Stop the processing, close the gate of the stream and release all blocked producers. Images taken out of the buffer
+                 * to release blocked producers are discarded.
+                 */
+                void stop();
+
+            private:
+
+                /**
+                 * Install the handlers of this session in the native configuration.
+                 */
+                void applyHandlers();
+
+                /**
+                 * The native configuration.
+                 */
+                Companion::Configuration configuration;
+
+                /**
+                 * Processing of the frames.
+                 */
+                Companion::Processing::ImageProcessing* processing;
+
+                /**
+                 * Image buffer of the frames.
+                 */
+                ImageBuffer* stream;
+
+                /**
+                 * Gate of the producers of the image buffer.
+                 */
+                StreamGate* gate;
+
+                /**
+                 * Current result handler.
+                 */
+                std::shared_ptr<ResultHandler> resultHandler;
+
+                /**
+                 * Current error handler.
+                 */
+                std::shared_ptr<ErrorHandler> errorHandler;
+
+                /**
+                 * Color format of the result images.
+                 */
+                std::atomic<Companion::ColorFormat> resultColorFormat;
+
+                /**
+                 * Indicator to pass gray result images.
+                 */
+                std::atomic<bool> grayscale;
+        };
+    }
+}
@@ -0,0 +1,320 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "RecognitionProcessing.h"
+#include "CompanionWinRT/native/MemoryAccount.h"
+#include "CompanionWinRT/native/SceneFeatureCache.h"
+
+using namespace CompanionWinRT::Native;
+
+RecognitionProcessing::RecognitionProcessing(FeatureVerification* verification)
+    : verification(verification), reRank(false), compactOnly(false), maxObjects(0), frameCounter(0), deterministic(false)
+{
+}
+
+RecognitionProcessing::~RecognitionProcessing()
+{
+    this->clearModels();
+}
+
+bool RecognitionProcessing::addModel(int id, const cv::Mat& image, const std::string& tag)
+{
+    if (image.empty())
+    {
+        return false;
+    }
+
+    std::unique_ptr<Model> model(new Model());
+    model->id = id;
+    model->lastSeen = 0;
+    model->hits = 0;
+    this->verification->extractModel(image, model->features);
+
+    std::lock_guard<ContentionMutex> lock(this->modelsMutex);
+    if (!this->bitSelection.isEmpty())
+    {
+        this->bitSelection.compact(model->features.descriptors, model->features.compactDescriptors);
+        if (this->compactOnly)
+        {
+            model->features.descriptors.release();
+        }
+    }
+    MemoryAccount::get(MemoryComponent::DESCRIPTORS).add(model->features.getBytes());
+    this->models.push_back(std::move(model));
+    this->tags.setTag(id, tag);
+
+    return true;
+}
+
+void RecognitionProcessing::removeModel(int id)
+{
+    std::lock_guard<ContentionMutex> lock(this->modelsMutex);
+    this->models.erase(std::remove_if(this->models.begin(), this->models.end(), [id](const std::unique_ptr<Model>& model)
+    {
+        if (model->id != id)
+        {
+            return false;
+        }
+        MemoryAccount::get(MemoryComponent::DESCRIPTORS).add(-model->features.getBytes());
+        return true;
+    }), this->models.end());
+    this->tags.removeTag(id);
+}
+
+void RecognitionProcessing::clearModels()
+{
+    std::lock_guard<ContentionMutex> lock(this->modelsMutex);
+    for (size_t i = 0; i < this->models.size(); i++)
+    {
+        MemoryAccount::get(MemoryComponent::DESCRIPTORS).add(-this->models[i]->features.getBytes());
+    }
+    this->models.clear();
+    this->tags.clear();
+}
+
+void RecognitionProcessing::setMaxObjects(int maxObjects)
+{
+    this->maxObjects = std::max(0, maxObjects);
+}
+
+int RecognitionProcessing::getMaxObjects()
+{
+    return this->maxObjects;
+}
+
+void RecognitionProcessing::setDeterministic(bool deterministic)
+{
+    this->deterministic = deterministic;
+}
+
+bool RecognitionProcessing::isDeterministic()
+{
+    return this->deterministic;
+}
+
+void RecognitionProcessing::setActiveTags(const std::set<std::string>& tags)
+{
+    this->tags.setActiveTags(tags);
+}
+
+bool RecognitionProcessing::selectDescriptorBits(int bits, bool reRank)
+{
+    std::lock_guard<ContentionMutex> lock(this->modelsMutex);
+    if (this->compactOnly)
+    {
+        return false;
+    }
+
+    // Select the bits over the descriptors of the whole catalog
+    cv::Mat catalog;
+    for (size_t i = 0; i < this->models.size(); i++)
+    {
+        catalog.push_back(this->models[i]->features.descriptors);
+    }
+
+    if (bits > 0)
+    {
+        this->bitSelection.select(catalog, bits);
+    }
+    else
+    {
+        this->bitSelection.clear();
+    }
+    this->reRank = reRank;
+
+    // Full descriptors are only kept to re-rank candidates
+    this->compactOnly = !this->bitSelection.isEmpty() && !reRank;
+
+    for (size_t i = 0; i < this->models.size(); i++)
+    {
+        Features& features = this->models[i]->features;
+        int64_t bytes = features.getBytes();
+        if (this->bitSelection.isEmpty())
+        {
+            features.compactDescriptors.release();
+        }
+        else
+        {
+            this->bitSelection.compact(features.descriptors, features.compactDescriptors);
+            if (this->compactOnly)
+            {
+                features.descriptors.release();
+            }
+        }
+        MemoryAccount::get(MemoryComponent::DESCRIPTORS).add(features.getBytes() - bytes);
+    }
+
+    return true;
+}
+
+void RecognitionProcessing::setRegionMask(const cv::Mat& mask)
+{
+    this->regionMask.set(mask);
+}
+
+void RecognitionProcessing::extractScene(const cv::Mat& frame, const cv::Rect& region, const cv::Mat& image, Features& features, const cv::Mat& mask)
+{
+    this->extractSceneFeatures(frame, region, image, features, mask);
+    this->compactScene(features);
+}
+
+void RecognitionProcessing::extractSceneFeatures(const cv::Mat& frame, const cv::Rect& region, const cv::Mat& image, Features& features, const cv::Mat& mask)
+{
+    SceneFeatureCache::get().extract(static_cast<const Companion::Processing::ImageProcessing*>(this), *this->verification, frame, region, image, mask, features);
+    this->work.addSceneKeypoints(features.keypoints.size());
+}
+
+void RecognitionProcessing::compactScene(Features& features)
+{
+    if (!this->bitSelection.isEmpty())
+    {
+        this->bitSelection.compact(features.descriptors, features.compactDescriptors);
+    }
+}
+
+std::vector<Model*> RecognitionProcessing::rankModels()
+{
+    std::vector<Model*> ranking;
+    ranking.reserve(this->models.size());
+    for (size_t i = 0; i < this->models.size(); i++)
+    {
+        if (this->tags.isActive(this->models[i]->id))
+        {
+            ranking.push_back(this->models[i].get());
+        }
+    }
+
+    if (this->deterministic)
+    {
+        // The recognition history depends on the processing order of frames
+        return ranking;
+    }
+
+    // Recently recognized models first, then frequently recognized models (registration order otherwise)
+    std::stable_sort(ranking.begin(), ranking.end(), [](const Model* a, const Model* b)
+    {
+        if (a->lastSeen != b->lastSeen)
+        {
+            return a->lastSeen > b->lastSeen;
+        }
+        return a->hits > b->hits;
+    });
+
+    return ranking;
+}
+
+std::vector<std::pair<Model*, Verification>> RecognitionProcessing::verifyModels(const std::vector<Model*>& ranking, const Features& scene)
+{
+    std::vector<std::pair<Model*, Verification>> recognized;
+
+    if (this->maxObjects > 0)
+    {
+        // Verify in the order of likelihood to stop as early as possible
+        Verification verification;
+        for (size_t i = 0; (i < ranking.size()) && !this->isSaturated(recognized.size()); i++)
+        {
+            bool found = this->verification->verify(ranking[i]->features, scene, verification, this->reRank);
+            this->work.addModel(ranking[i]->id, verification);
+            if (found)
+            {
+                recognized.push_back(std::make_pair(ranking[i], verification));
+            }
+        }
+        return recognized;
+    }
+
+    // Verify all models in parallel and merge them in the order of the ranking
+    std::vector<Verification> verifications(ranking.size());
+    std::vector<char> found(ranking.size(), 0);
+    cv::parallel_for_(cv::Range(0, static_cast<int>(ranking.size())), [&](const cv::Range& range)
+    {
+        for (int i = range.start; i < range.end; i++)
+        {
+            found[i] = this->verification->verify(ranking[i]->features, scene, verifications[i], this->reRank) ? 1 : 0;
+        }
+    });
+
+    for (size_t i = 0; i < ranking.size(); i++)
+    {
+        this->work.addModel(ranking[i]->id, verifications[i]);
+        if (found[i])
+        {
+            recognized.push_back(std::make_pair(ranking[i], verifications[i]));
+        }
+    }
+    return recognized;
+}
+
+Model* RecognitionProcessing::findModel(int id)
+{
+    for (size_t i = 0; i < this->models.size(); i++)
+    {
+        if (this->models[i]->id == id)
+        {
+            return this->tags.isActive(id) ? this->models[i].get() : nullptr;
+        }
+    }
+
+    return nullptr;
+}
+
+void RecognitionProcessing::recognized(Model* model)
+{
+    model->lastSeen = this->frameCounter;
+    model->hits++;
+}
+
+bool RecognitionProcessing::isSaturated(size_t resultCount)
+{
+    int maxObjects = this->maxObjects;
+    return (maxObjects > 0) && (resultCount >= static_cast<size_t>(maxObjects));
+}
+
+cv::Mat RecognitionProcessing::toGray(const cv::Mat& frame)
+{
+    cv::Mat gray;
+
+    switch (frame.channels())
+    {
+        case 3:
+            cv::cvtColor(frame, gray, cv::COLOR_BGR2GRAY);
+            break;
+        case 4:
+            cv::cvtColor(frame, gray, cv::COLOR_BGRA2GRAY);
+            break;
+        default:
+            gray = frame;
+            break;
+    }
+
+    return gray;
+}
+
+Companion::Model::Result::Result* RecognitionProcessing::createResult(int id, const Verification& verification)
+{
+    return new PoseResult(verification.score, id, verification.corners, cv::Matx33d(verification.homography));
+}
+
+ContentionMutex& RecognitionProcessing::getModelsMutex()
+{
+    return this->modelsMutex;
+}
@@ -0,0 +1,334 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+#include <companion/processing/ImageProcessing.h>
+#include <companion/model/result/RecognitionResult.h>
+#include <companion/draw/Frame.h>
+
+#include "CompanionWinRT/native/BitSelection.h"
+#include "CompanionWinRT/native/ContentionMutex.h"
+#include "CompanionWinRT/native/FeatureVerification.h"
+#include "CompanionWinRT/native/ModelTags.h"
+#include "CompanionWinRT/native/PoseResult.h"
+#include "CompanionWinRT/native/RegionMask.h"
+#include "CompanionWinRT/native/WorkCounter.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * A recognition model together with its features and recognition history.
+         */
+        struct Model
+        {
+            /**
+             * The ID of this model.
+             */
+            int id;
+
+            /**
+             * Features of the model image.
+             */
+            Features features;
+
+            /**
+             * Number of the last frame this model was recognized in (0 if it was never recognized).
+             */
+            int lastSeen;
+
+            /**
+             * Number of frames this model was recognized in.
+             */
+            int hits;
+        };
+
+        /**
+         * This class provides the model handling shared by the native recognition processing of this wrapper.
+         *
+         * Models are verified in the order of their likelihood: models that were recognized recently come first, followed by models
+         * that were recognized more often. Verification stops as soon as the maximum number of objects per frame is reached.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class RecognitionProcessing : public Companion::Processing::ImageProcessing
+        {
+            public:
+
+                /**
+                 * Create a 'RecognitionProcessing' object.
+                 *
+                 * @param verification  feature verification used to verify models
+                 */
+                RecognitionProcessing(FeatureVerification* verification);
+
+                /**
+                 * Destruct this instance.
+                 */
+                virtual ~RecognitionProcessing();
+
+                /**
+                 * Add a model. Its features are extracted right away.
+                 *
+                 * @param id    the ID of the model
+                 * @param image gray scale model image
+                 * @param tag   tag (group) of the model
+                 * @return <code>true</code> if the model was added successfully, <code>false</code> otherwise
+                 */
+                virtual bool addModel(int id, const cv::Mat& image, const std::string& tag);
+
+                /**
+                 * Remove all models with the given ID.
+                 *
+                 * @param id    the ID of the model
+                 */
+                void removeModel(int id);
+
+                /**
+                 * Remove all models.
+                 */
+                void clearModels();
+
+                /**
+                 * Set the maximum number of objects per frame. Model verification stops once this many objects were recognized.
+                 *
+                 * @param maxObjects    maximum number of objects per frame (0 for no limit)
+                 */
+                void setMaxObjects(int maxObjects);
+
+                /**
+                 * Return the maximum number of objects per frame.
+                 *
+                 * @return maximum number of objects per frame (0 for no limit)
+                 */
+                int getMaxObjects();
+
+                /**
+                 * Enable or disable the deterministic mode. In deterministic mode the results of a frame don't depend on thread
+                 * scheduling or on previously processed frames: models are verified in registration order and parallel verifications
+                 * are merged in model order. The robust estimation itself is reproducible, OpenCV seeds its RANSAC with a fixed value
+                 * for every call of 'cv::findHomography'.
+                 *
+                 * @param deterministic <code>true</code> to enable the deterministic mode, <code>false</code> to disable it
+                 */
+                void setDeterministic(bool deterministic);
+
+                /**
+                 * Check whether the deterministic mode is enabled.
+                 *
+                 * @return <code>true</code> if the deterministic mode is enabled, <code>false</code> otherwise
+                 */
+                bool isDeterministic();
+
+                /**
+                 * Select the active model tags. Only models with an active tag are verified.
+                 *
+                 * @param tags  active tags (an empty set activates all models)
+                 */
+                void setActiveTags(const std::set<std::string>& tags);
+
+                /**
+                 * Select the most informative and least correlated descriptor bits over all models and match with compact
+                 * descriptors made of these bits from now on. Models that are added later use the same bit selection.
+                 *
+                 * Without re-ranking the full model descriptors are released, so the selection can't be changed afterwards.
+                 *
+                 * @param bits      number of bits to select (0 to match with the full descriptors again)
+                 * @param reRank    <code>true</code> to re-rank compact candidate matches with the full descriptors
+                 * @return <code>true</code> if the bits were selected, <code>false</code> if the full descriptors were already released
+                 */
+                bool selectDescriptorBits(int bits, bool reRank);
+
+                /**
+                 * Set a static region mask. Keypoints are only detected in the processed region of the mask.
+                 *
+                 * @param mask  8-bit mask with non-zero pixels for processed regions (empty to process the whole frame)
+                 */
+                void setRegionMask(const cv::Mat& mask);
+
+                /**
+                 * Convert the given frame to gray scale (no copy if the frame is already gray).
+                 *
+                 * @param frame frame to convert
+                 * @return gray scale frame
+                 */
+                static cv::Mat toGray(const cv::Mat& frame);
+
+                /**
+                 * Return the lock of the models, which records its wait and hold times.
+                 *
+                 * @return lock of the models
+                 */
+                ContentionMutex& getModelsMutex();
+
+            protected:
+
+                /**
+                 * Extract the features of a scene (including compact descriptors if descriptor bits are selected). Features of the same
+                 * frame region are taken from the scene feature cache. The caller has to hold the model lock.
+                 *
+                 * @param frame     the processed frame
+                 * @param region    region of the frame the scene image was taken from
+                 * @param image     gray scale scene image at the processing resolution
+                 * @param features  extracted scene features
+                 * @param mask      optional 8-bit mask of the image area to search for keypoints (empty for the whole image)
+                 */
+                void extractScene(const cv::Mat& frame, const cv::Rect& region, const cv::Mat& image, Features& features, const cv::Mat& mask = cv::Mat());
+
+                /**
+                 * Extract the features of a scene without compact descriptors. This doesn't touch the models, so the caller doesn't
+                 * have to hold the model lock. Features of the same frame region are taken from the scene feature cache.
+                 *
+                 * @param frame     the processed frame
+                 * @param region    region of the frame the scene image was taken from
+                 * @param image     gray scale scene image at the processing resolution
+                 * @param features  extracted scene features
+                 * @param mask      optional 8-bit mask of the image area to search for keypoints (empty for the whole image)
+                 */
+                void extractSceneFeatures(const cv::Mat& frame, const cv::Rect& region, const cv::Mat& image, Features& features, const cv::Mat& mask = cv::Mat());
+
+                /**
+                 * Add the compact descriptors of the selected descriptor bits to extracted scene features. The caller has to hold the
+                 * model lock.
+                 *
+                 * @param features  extracted scene features
+                 */
+                void compactScene(Features& features);
+
+                /**
+                 * Return all active models ordered by their likelihood. The caller has to hold the model lock.
+                 *
+                 * @return active models ordered by their likelihood
+                 */
+                std::vector<Model*> rankModels();
+
+                /**
+                 * Verify the given models against a scene. Without an object limit the models are verified in parallel, otherwise in
+                 * the given order until the limit is reached. The caller has to hold the model lock.
+                 *
+                 * @param ranking   models to verify in their order of likelihood
+                 * @param scene     scene features
+                 * @return recognized models and their verification in the order of the ranking
+                 */
+                std::vector<std::pair<Model*, Verification>> verifyModels(const std::vector<Model*>& ranking, const Features& scene);
+
+                /**
+                 * Return the active model with the given ID. The caller has to hold the model lock.
+                 *
+                 * @param id    the ID of the model
+                 * @return the model or <code>nullptr</code> if there is no such active model
+                 */
+                Model* findModel(int id);
+
+                /**
+                 * Update the recognition history of a recognized model. The caller has to hold the model lock.
+                 *
+                 * @param model recognized model
+                 */
+                void recognized(Model* model);
+
+                /**
+                 * Check whether the maximum number of objects for the current frame is reached.
+                 *
+                 * @param resultCount   number of objects recognized in the current frame
+                 * @return <code>true</code> if no further model has to be verified, <code>false</code> otherwise
+                 */
+                bool isSaturated(size_t resultCount);
+
+                /**
+                 * Create a recognition result for a verified model, which keeps the homography and the sub-pixel corners.
+                 *
+                 * @param id            the ID of the recognized model
+                 * @param verification  verification outcome in frame coordinates
+                 * @return recognition result
+                 */
+                static Companion::Model::Result::Result* createResult(int id, const Verification& verification);
+
+                /**
+                 * Feature verification used to verify models.
+                 */
+                FeatureVerification* verification;
+
+                /**
+                 * All models of this processing.
+                 */
+                std::vector<std::unique_ptr<Model>> models;
+
+                /**
+                 * Lock for the models and their recognition history.
+                 */
+                ContentionMutex modelsMutex;
+
+                /**
+                 * Tags of all models.
+                 */
+                ModelTags tags;
+
+                /**
+                 * Selected descriptor bits for compact descriptors.
+                 */
+                BitSelection bitSelection;
+
+                /**
+                 * Static region mask of the camera view.
+                 */
+                RegionMask regionMask;
+
+                /**
+                 * Indicator to re-rank compact candidate matches with the full descriptors.
+                 */
+                std::atomic<bool> reRank;
+
+                /**
+                 * Indicator that the full model descriptors were released and only compact descriptors are kept.
+                 */
+                bool compactOnly;
+
+                /**
+                 * Maximum number of objects per frame (0 for no limit).
+                 */
+                std::atomic<int> maxObjects;
+
+                /**
+                 * Number of processed frames.
+                 */
+                int frameCounter;
+
+                /**
+                 * Indicator to use the deterministic mode.
+                 */
+                std::atomic<bool> deterministic;
+
+                /**
+                 * Work counters of the current frame.
+                 */
+                WorkCounter work;
+        };
+    }
+}
@@ -0,0 +1,159 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <opencv2/imgproc/imgproc.hpp>
+#include <companion/draw/Frame.h>
+#include <companion/model/result/DetectionResult.h>
+#include <companion/model/result/RecognitionResult.h>
+
+#include "RegionMask.h"
+
+using namespace CompanionWinRT::Native;
+
+void RegionMask::set(const cv::Mat& mask)
+{
+    cv::Mat binary;
+    if (!mask.empty())
+    {
+        cv::Mat gray = mask;
+        if (mask.channels() > 1)
+        {
+            cv::cvtColor(mask, gray, (mask.channels() == 4) ? cv::COLOR_BGRA2GRAY : cv::COLOR_BGR2GRAY);
+        }
+        cv::compare(gray, 0, binary, cv::CMP_GT);
+    }
+
+    std::lock_guard<std::mutex> lock(this->maskMutex);
+    this->mask = binary;
+    this->scaledMask.release();
+    this->interiorMask.release();
+}
+
+void RegionMask::clear()
+{
+    std::lock_guard<std::mutex> lock(this->maskMutex);
+    this->mask.release();
+    this->scaledMask.release();
+    this->interiorMask.release();
+}
+
+cv::Mat RegionMask::get(cv::Size size)
+{
+    std::lock_guard<std::mutex> lock(this->maskMutex);
+    if (this->mask.empty())
+    {
+        return cv::Mat();
+    }
+
+    // The cached mask is replaced but never modified, so a shared header is safe
+    this->scale(size);
+    return this->scaledMask;
+}
+
+cv::Rect RegionMask::getBounds(cv::Size size)
+{
+    std::lock_guard<std::mutex> lock(this->maskMutex);
+    if (this->mask.empty())
+    {
+        return cv::Rect(cv::Point(0, 0), size);
+    }
+
+    this->scale(size);
+    return this->bounds;
+}
+
+bool RegionMask::isIncluded(const std::vector<cv::Point>& polygon, cv::Size size)
+{
+    cv::Mat interior;
+    {
+        std::lock_guard<std::mutex> lock(this->maskMutex);
+        if (this->mask.empty() || polygon.empty())
+        {
+            return true;
+        }
+        this->scale(size);
+        interior = this->interiorMask;
+    }
+
+    // Shapes along the boundary of the processed region are cut off by it, so every corner has to lie in the interior
+    cv::Rect area(0, 0, interior.cols, interior.rows);
+    for (size_t i = 0; i < polygon.size(); i++)
+    {
+        if (!area.contains(polygon[i]) || (interior.at<uchar>(polygon[i]) == 0))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+std::vector<cv::Point> RegionMask::getPolygon(Companion::Model::Result::Result* result, cv::Point offset)
+{
+    Companion::Draw::Frame* frame = dynamic_cast<Companion::Draw::Frame*>(result->getDrawable());
+    if (frame == nullptr)
+    {
+        return std::vector<cv::Point>();
+    }
+
+    return { frame->getTopLeft() + offset, frame->getTopRight() + offset, frame->getBottomRight() + offset, frame->getBottomLeft() + offset };
+}
+
+Companion::Model::Result::Result* RegionMask::toFrame(Companion::Model::Result::Result* result, cv::Point offset)
+{
+    std::vector<cv::Point> polygon = getPolygon(result, offset);
+    if ((offset == cv::Point(0, 0)) || polygon.empty())
+    {
+        return result;
+    }
+
+    Companion::Model::Result::Result* moved = result;
+    Companion::Draw::Frame* frame = new Companion::Draw::Frame(polygon[0], polygon[1], polygon[3], polygon[2]);
+    if (result->getType() == Companion::Model::Result::ResultType::RECOGNITION)
+    {
+        Companion::Model::Result::RecognitionResult* recognition = static_cast<Companion::Model::Result::RecognitionResult*>(result);
+        moved = new Companion::Model::Result::RecognitionResult(recognition->getScoring(), recognition->getId(), frame);
+    }
+    else if (result->getType() == Companion::Model::Result::ResultType::DETECTION)
+    {
+        Companion::Model::Result::DetectionResult* detection = static_cast<Companion::Model::Result::DetectionResult*>(result);
+        moved = new Companion::Model::Result::DetectionResult(detection->getScoring(), detection->getObjectType(), frame);
+    }
+    else
+    {
+        delete frame;
+        return result;
+    }
+
+    delete result;
+    return moved;
+}
+
+void RegionMask::scale(cv::Size size)
+{
+    if (this->scaledMask.size() == size)
+    {
+        return;
+    }
+
+    cv::resize(this->mask, this->scaledMask, size, 0.0, 0.0, cv::INTER_NEAREST);
+    cv::erode(this->scaledMask, this->interiorMask, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(2 * BORDER_MARGIN + 1, 2 * BORDER_MARGIN + 1)));
+
+    std::vector<cv::Point> processed;
+    cv::findNonZero(this->scaledMask, processed);
+    this->bounds = processed.empty() ? cv::Rect() : cv::boundingRect(processed);
+}
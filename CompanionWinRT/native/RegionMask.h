@@ -0,0 +1,140 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include <opencv2/core/core.hpp>
+#include <companion/model/result/Result.h>
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class holds a static region mask of the camera view. Non-zero mask pixels are processed, zero pixels are excluded
+         * from processing, for example fixed textured areas that never contain objects.
+         *
+         * The mask is scaled to the frame size with nearest neighbour interpolation and the scaled mask is cached per frame size.
+         * Contour based stages search only the bounding rectangle of the processed pixels and keep shapes whose corners all lie
+         * inside the processed region, at least 'BORDER_MARGIN' pixels away from its boundary.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class RegionMask
+        {
+            public:
+
+                /**
+                 * Set the region mask.
+                 *
+                 * @param mask  8-bit single channel mask (empty to process the whole frame)
+                 */
+                void set(const cv::Mat& mask);
+
+                /**
+                 * Remove the region mask, so the whole frame is processed.
+                 */
+                void clear();
+
+                /**
+                 * Return the region mask scaled to the given frame size.
+                 *
+                 * @param size  frame size
+                 * @return 8-bit mask with 255 for processed pixels (empty if the whole frame is processed)
+                 */
+                cv::Mat get(cv::Size size);
+
+                /**
+                 * Return the bounding rectangle of the processed pixels, the part of a frame contour based stages have to search.
+                 *
+                 * @param size  frame size
+                 * @return bounding rectangle of the processed region (the whole frame without a mask, empty if nothing is processed)
+                 */
+                cv::Rect getBounds(cv::Size size);
+
+                /**
+                 * Check whether all corners of the given polygon lie inside the processed region and don't touch its boundary.
+                 *
+                 * @param polygon   polygon in frame coordinates
+                 * @param size      frame size
+                 * @return <code>true</code> if the polygon has to be processed, <code>false</code> otherwise
+                 */
+                bool isIncluded(const std::vector<cv::Point>& polygon, cv::Size size);
+
+                /**
+                 * Return the corners of the frame of a result (upper left, upper right, lower right, lower left).
+                 *
+                 * @param result    result of a contour based stage
+                 * @param offset    offset of the searched image in the frame, see 'getBounds'
+                 * @return corners in frame coordinates (empty if the result has no frame)
+                 */
+                static std::vector<cv::Point> getPolygon(Companion::Model::Result::Result* result, cv::Point offset);
+
+                /**
+                 * Move the frame of a result of a contour based stage to frame coordinates. Recognition and detection results are
+                 * replaced by a moved copy and the given result is deleted, other results are returned unchanged.
+                 *
+                 * @param result    result found in the searched image
+                 * @param offset    offset of the searched image in the frame, see 'getBounds'
+                 * @return result in frame coordinates
+                 */
+                static Companion::Model::Result::Result* toFrame(Companion::Model::Result::Result* result, cv::Point offset);
+
+                /**
+                 * Minimum distance of shape corners from the boundary of the processed region (in pixels).
+                 */
+                static const int BORDER_MARGIN = 3;
+
+            private:
+
+                /**
+                 * Scale the cached masks to the given frame size. The caller has to hold the mask lock.
+                 *
+                 * @param size  frame size
+                 */
+                void scale(cv::Size size);
+
+                /**
+                 * Region mask in its original size.
+                 */
+                cv::Mat mask;
+
+                /**
+                 * Region mask scaled to the last requested frame size.
+                 */
+                cv::Mat scaledMask;
+
+                /**
+                 * Scaled region mask eroded by 'BORDER_MARGIN', the area shape corners have to lie in.
+                 */
+                cv::Mat interiorMask;
+
+                /**
+                 * Bounding rectangle of the processed pixels of the scaled mask.
+                 */
+                cv::Rect bounds;
+
+                /**
+                 * Lock for the region mask.
+                 */
+                std::mutex maskMutex;
+        };
+    }
+}
@@ -0,0 +1,151 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <new>
+#include <companion/draw/Frame.h>
+#include <companion/model/result/RecognitionResult.h>
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+
+#include "ResultPublisher.h"
+#include "CompanionWinRT/native/MemoryAccount.h"
+
+using namespace CompanionWinRT::Native;
+
+ResultPublisher::ResultPublisher(const std::wstring& name, uint32_t capacity) : mapping(nullptr), header(nullptr), slots(nullptr)
+{
+    capacity = std::max<uint32_t>(1, capacity);
+    ULONG64 size = getResultRingSize(capacity);
+
+    this->mapping = CreateFileMappingFromApp(INVALID_HANDLE_VALUE, nullptr, PAGE_READWRITE, size, name.c_str());
+    if (this->mapping == nullptr)
+    {
+        return;
+    }
+
+    void* view = MapViewOfFileFromApp(this->mapping, FILE_MAP_READ | FILE_MAP_WRITE, 0, static_cast<SIZE_T>(size));
+    if (view == nullptr)
+    {
+        CloseHandle(this->mapping);
+        this->mapping = nullptr;
+        return;
+    }
+
+    // Initialize the ring (the slots are zeroed by the mapping)
+    this->header = new (view) ResultRingHeader();
+    this->header->capacity = capacity;
+    this->header->slotSize = sizeof(ResultSlot);
+    this->header->version = RESULT_RING_VERSION;
+    this->header->reserved = 0;
+    this->header->published = 0;
+    this->header->truncated = 0;
+    this->slots = reinterpret_cast<ResultSlot*>(reinterpret_cast<uint8_t*>(view) + sizeof(ResultRingHeader));
+
+    // Subscribers check the magic number last
+    std::atomic_thread_fence(std::memory_order_release);
+    this->header->magic = RESULT_RING_MAGIC;
+
+    MemoryAccount::get(MemoryComponent::RESULT_BUFFERS).add(static_cast<int64_t>(size));
+}
+
+ResultPublisher::~ResultPublisher()
+{
+    if (this->header != nullptr)
+    {
+        MemoryAccount::get(MemoryComponent::RESULT_BUFFERS).add(-static_cast<int64_t>(getResultRingSize(this->header->capacity)));
+        UnmapViewOfFile(this->header);
+        this->header = nullptr;
+        this->slots = nullptr;
+    }
+    if (this->mapping != nullptr)
+    {
+        CloseHandle(this->mapping);
+        this->mapping = nullptr;
+    }
+}
+
+bool ResultPublisher::isOpen() const
+{
+    return this->header != nullptr;
+}
+
+void ResultPublisher::publish(const std::vector<Companion::Model::Result::Result*>& results)
+{
+    if (this->header == nullptr)
+    {
+        return;
+    }
+
+    uint64_t number = this->header->published.load(std::memory_order_relaxed);
+    ResultSlot& slot = this->slots[number % this->header->capacity];
+
+    // Mark the slot as being written
+    slot.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    ResultRecord& record = slot.record;
+    record.number = number;
+    record.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+    record.count = 0;
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        Companion::Draw::Frame* frame = dynamic_cast<Companion::Draw::Frame*>(results[i]->getDrawable());
+        if (frame == nullptr)
+        {
+            continue;
+        }
+        if (record.count >= MAX_RECORD_RESULTS)
+        {
+            this->header->truncated++;
+            continue;
+        }
+
+        ResultEntry& entry = record.results[record.count++];
+        Companion::Model::Result::RecognitionResult* recognition = dynamic_cast<Companion::Model::Result::RecognitionResult*>(results[i]);
+        entry.type = static_cast<uint8_t>((recognition != nullptr) ? ResultEntryType::RECOGNITION : ResultEntryType::DETECTION);
+        entry.id = (recognition != nullptr) ? recognition->getId() : -1;
+        entry.score = static_cast<int16_t>(results[i]->getScoring());
+
+        cv::Point corners[] = { frame->getTopLeft(), frame->getTopRight(), frame->getBottomRight(), frame->getBottomLeft() };
+        for (int j = 0; j < 4; j++)
+        {
+            entry.corners[2 * j] = corners[j].x;
+            entry.corners[2 * j + 1] = corners[j].y;
+        }
+    }
+
+    // Complete the record
+    slot.sequence.store(number + 1, std::memory_order_release);
+    this->header->published.store(number + 1, std::memory_order_release);
+}
+
+uint64_t ResultPublisher::getPublished() const
+{
+    return (this->header != nullptr) ? this->header->published.load() : 0;
+}
+
+uint64_t ResultPublisher::getTruncated() const
+{
+    return (this->header != nullptr) ? this->header->truncated.load() : 0;
+}
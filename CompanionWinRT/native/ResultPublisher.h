@@ -0,0 +1,100 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <companion/model/result/Result.h>
+
+#include "CompanionWinRT/native/ResultSchema.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class publishes results to other local processes over a named shared memory ring, see 'ResultRingHeader' for the
+         * layout. Publishing never blocks: once the ring is full the oldest records are overwritten.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class ResultPublisher
+        {
+            public:
+
+                /**
+                 * Create a 'ResultPublisher' object and its shared memory ring.
+                 *
+                 * @param name      name of the shared memory ring
+                 * @param capacity  number of records the ring can buffer
+                 */
+                ResultPublisher(const std::wstring& name, uint32_t capacity);
+
+                /**
+                 * Destruct this instance and release the shared memory ring.
+                 */
+                ~ResultPublisher();
+
+                /**
+                 * Check whether the shared memory ring was created.
+                 *
+                 * @return <code>true</code> if results can be published, <code>false</code> otherwise
+                 */
+                bool isOpen() const;
+
+                /**
+                 * Publish the results of one frame.
+                 *
+                 * @param results   results of the frame
+                 */
+                void publish(const std::vector<Companion::Model::Result::Result*>& results);
+
+                /**
+                 * Return the number of published records.
+                 *
+                 * @return number of published records
+                 */
+                uint64_t getPublished() const;
+
+                /**
+                 * Return the number of results dropped because a frame had more than 'MAX_RECORD_RESULTS' results.
+                 *
+                 * @return number of truncated results
+                 */
+                uint64_t getTruncated() const;
+
+            private:
+
+                /**
+                 * Handle of the shared memory mapping (a Windows 'HANDLE').
+                 */
+                void* mapping;
+
+                /**
+                 * Mapped ring header.
+                 */
+                ResultRingHeader* header;
+
+                /**
+                 * Mapped ring slots.
+                 */
+                ResultSlot* slots;
+        };
+    }
+}
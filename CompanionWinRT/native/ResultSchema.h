@@ -0,0 +1,180 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * Magic number at the start of a result ring ("CRES").
+         */
+        const uint32_t RESULT_RING_MAGIC = 0x53455243;
+
+        /**
+         * Version of the result ring layout.
+         */
+        const uint16_t RESULT_RING_VERSION = 1;
+
+        /**
+         * Maximum number of results per record. Further results of a frame are dropped and counted as truncated.
+         */
+        const uint16_t MAX_RECORD_RESULTS = 32;
+
+        /**
+         * Result types of a result entry.
+         */
+        enum class ResultEntryType : uint8_t
+        {
+            RECOGNITION = 0, ///< Recognition result with a model ID.
+            DETECTION = 1 ///< Detection result without a model ID.
+        };
+
+#pragma pack(push, 1)
+
+        /**
+         * A single result in the compact binary schema.
+         */
+        struct ResultEntry
+        {
+            /**
+             * Result type, see 'ResultEntryType'.
+             */
+            uint8_t type;
+
+            /**
+             * The ID of the recognized model (-1 for detection results).
+             */
+            int32_t id;
+
+            /**
+             * Detection or recognition score (0% - 100%).
+             */
+            int16_t score;
+
+            /**
+             * Frame corners as x, y pairs (upper left, upper right, lower right, lower left).
+             */
+            int32_t corners[8];
+        };
+
+        /**
+         * All results of one processed frame.
+         */
+        struct ResultRecord
+        {
+            /**
+             * Number of the record (counted from 0 since the publisher was created).
+             */
+            uint64_t number;
+
+            /**
+             * Publishing time (milliseconds since 1970-01-01 UTC).
+             */
+            int64_t timestamp;
+
+            /**
+             * Number of valid entries.
+             */
+            uint16_t count;
+
+            /**
+             * Result entries (only the first 'count' entries are valid).
+             */
+            ResultEntry results[MAX_RECORD_RESULTS];
+        };
+
+#pragma pack(pop)
+
+        /**
+         * A slot of the result ring. Record number n is written to slot n % capacity.
+         */
+        struct ResultSlot
+        {
+            /**
+             * Record number + 1 of the completely written record (0 while the record is written).
+             */
+            std::atomic<uint64_t> sequence;
+
+            /**
+             * Record of this slot.
+             */
+            ResultRecord record;
+        };
+
+        /**
+         * Header of the result ring, followed by 'capacity' slots of 'slotSize' bytes each.
+         *
+         * The ring has a single publisher that never waits for subscribers: the oldest records are overwritten once the ring is full.
+         * Subscribers notice overwritten records by their sequence numbers and count them as dropped.
+         */
+        struct ResultRingHeader
+        {
+            /**
+             * Magic number, see 'RESULT_RING_MAGIC'.
+             */
+            uint32_t magic;
+
+            /**
+             * Layout version, see 'RESULT_RING_VERSION'.
+             */
+            uint16_t version;
+
+            /**
+             * Reserved (0).
+             */
+            uint16_t reserved;
+
+            /**
+             * Number of slots.
+             */
+            uint32_t capacity;
+
+            /**
+             * Size of a slot (in bytes).
+             */
+            uint32_t slotSize;
+
+            /**
+             * Number of completely written records.
+             */
+            std::atomic<uint64_t> published;
+
+            /**
+             * Number of results dropped because a frame had more than 'MAX_RECORD_RESULTS' results.
+             */
+            std::atomic<uint64_t> truncated;
+        };
+
+        /**
+         * Return the size of a result ring.
+         *
+         * @param capacity  number of slots
+         * @return size of the header and all slots (in bytes)
+         */
+        inline size_t getResultRingSize(uint32_t capacity)
+        {
+            return sizeof(ResultRingHeader) + static_cast<size_t>(capacity) * sizeof(ResultSlot);
+        }
+    }
+}
@@ -0,0 +1,212 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+
+#include "SceneFeatureCache.h"
+#include "CompanionWinRT/native/MemoryAccount.h"
+
+using namespace CompanionWinRT::Native;
+
+/**
+ * Number of most recent frames whose entries are kept (frames of concurrent configurations interleave).
+ */
+static const size_t FRAME_HISTORY = 2;
+
+SceneFeatureCache::SceneFeatureCache()
+    : enabled(false), hits(0), misses(0)
+{
+}
+
+SceneFeatureCache& SceneFeatureCache::get()
+{
+    static SceneFeatureCache cache;
+    return cache;
+}
+
+void SceneFeatureCache::extract(const void* owner, FeatureVerification& verification, const cv::Mat& frame, const cv::Rect& region, const cv::Mat& image, const cv::Mat& mask,
+                                Features& features)
+{
+    std::string detector = verification.getDetectorKey();
+    if (!this->enabled || detector.empty() || frame.empty())
+    {
+        verification.extract(image, features, mask);
+        return;
+    }
+
+    uint64_t maskHash = hashMask(mask);
+    {
+        std::lock_guard<std::mutex> lock(this->entriesMutex);
+        const Entry* entry = this->find(frame, region, image.size(), detector, maskHash);
+        if (entry != nullptr)
+        {
+            // Descriptors are shared, they are never modified by the verification
+            features.keypoints = entry->features.keypoints;
+            features.descriptors = entry->features.descriptors;
+            features.size = entry->features.size;
+            this->hits++;
+            return;
+        }
+    }
+
+    // Extract outside of the lock, concurrent misses of the same region extract twice
+    verification.extract(image, features, mask);
+    this->misses++;
+
+    std::lock_guard<std::mutex> lock(this->entriesMutex);
+    if (!this->enabled || (this->find(frame, region, image.size(), detector, maskHash) != nullptr))
+    {
+        return;
+    }
+
+    if (std::find_if(this->frames.begin(), this->frames.end(), [&frame](const cv::Mat& kept) { return kept.data == frame.data; }) == this->frames.end())
+    {
+        this->frames.push_front(frame);
+        MemoryAccount::get(MemoryComponent::SCRATCH).add(MemoryAccount::getBytes(frame));
+        if (this->frames.size() > FRAME_HISTORY)
+        {
+            // Drop the entries of the oldest frame
+            const uchar* oldest = this->frames.back().data;
+            MemoryAccount::get(MemoryComponent::SCRATCH).add(-MemoryAccount::getBytes(this->frames.back()));
+            this->frames.pop_back();
+            this->entries.erase(std::remove_if(this->entries.begin(), this->entries.end(), [oldest](const Entry& entry)
+            {
+                if (entry.frame.data != oldest)
+                {
+                    return false;
+                }
+                MemoryAccount::get(MemoryComponent::SCRATCH).add(-entry.features.getBytes());
+                return true;
+            }), this->entries.end());
+        }
+    }
+
+    Entry entry;
+    entry.owner = owner;
+    entry.frame = frame;
+    entry.region = region;
+    entry.size = image.size();
+    entry.detector = detector;
+    entry.maskHash = maskHash;
+    entry.features.keypoints = features.keypoints;
+    entry.features.descriptors = features.descriptors;
+    entry.features.size = features.size;
+    MemoryAccount::get(MemoryComponent::SCRATCH).add(entry.features.getBytes());
+    this->entries.push_back(std::move(entry));
+}
+
+void SceneFeatureCache::setEnabled(bool enabled)
+{
+    this->enabled = enabled;
+    if (!enabled)
+    {
+        this->clear();
+    }
+}
+
+void SceneFeatureCache::clear()
+{
+    std::lock_guard<std::mutex> lock(this->entriesMutex);
+    for (size_t i = 0; i < this->entries.size(); i++)
+    {
+        MemoryAccount::get(MemoryComponent::SCRATCH).add(-this->entries[i].features.getBytes());
+    }
+    for (size_t i = 0; i < this->frames.size(); i++)
+    {
+        MemoryAccount::get(MemoryComponent::SCRATCH).add(-MemoryAccount::getBytes(this->frames[i]));
+    }
+    this->entries.clear();
+    this->frames.clear();
+}
+
+void SceneFeatureCache::clear(const void* owner)
+{
+    std::lock_guard<std::mutex> lock(this->entriesMutex);
+    this->entries.erase(std::remove_if(this->entries.begin(), this->entries.end(), [owner](const Entry& entry)
+    {
+        if (entry.owner != owner)
+        {
+            return false;
+        }
+        MemoryAccount::get(MemoryComponent::SCRATCH).add(-entry.features.getBytes());
+        return true;
+    }), this->entries.end());
+
+    // Frames of other processings still have entries
+    this->frames.erase(std::remove_if(this->frames.begin(), this->frames.end(), [this](const cv::Mat& frame)
+    {
+        if (std::any_of(this->entries.begin(), this->entries.end(), [&frame](const Entry& entry) { return entry.frame.data == frame.data; }))
+        {
+            return false;
+        }
+        MemoryAccount::get(MemoryComponent::SCRATCH).add(-MemoryAccount::getBytes(frame));
+        return true;
+    }), this->frames.end());
+}
+
+SceneCacheStatistics SceneFeatureCache::getStatistics() const
+{
+    SceneCacheStatistics statistics;
+    statistics.hits = this->hits;
+    statistics.misses = this->misses;
+    return statistics;
+}
+
+void SceneFeatureCache::resetStatistics()
+{
+    this->hits = 0;
+    this->misses = 0;
+}
+
+uint64_t SceneFeatureCache::hashMask(const cv::Mat& mask)
+{
+    if (mask.empty())
+    {
+        return 0;
+    }
+
+    // FNV-1a over the mask rows
+    uint64_t hash = 14695981039346656037ULL;
+    size_t size = mask.cols * mask.elemSize();
+    for (int row = 0; row < mask.rows; row++)
+    {
+        const uchar* data = mask.ptr(row);
+        for (size_t i = 0; i < size; i++)
+        {
+            hash = (hash ^ data[i]) * 1099511628211ULL;
+        }
+    }
+
+    return (hash != 0) ? hash : 1;
+}
+
+const SceneFeatureCache::Entry* SceneFeatureCache::find(const cv::Mat& frame, const cv::Rect& region, cv::Size size, const std::string& detector,
+                                                        uint64_t maskHash) const
+{
+    for (size_t i = 0; i < this->entries.size(); i++)
+    {
+        const Entry& entry = this->entries[i];
+        if ((entry.frame.data == frame.data) && (entry.frame.size() == frame.size()) && (entry.region == region) && (entry.size == size)
+            && (entry.maskHash == maskHash) && (entry.detector == detector))
+        {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
@@ -0,0 +1,223 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <opencv2/core/core.hpp>
+
+#include "CompanionWinRT/native/FeatureVerification.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * Hits and misses of the scene feature cache.
+         */
+        struct SceneCacheStatistics
+        {
+            /**
+             * Number of extractions served from the cache.
+             */
+            uint64_t hits;
+
+            /**
+             * Number of extractions that had to be computed.
+             */
+            uint64_t misses;
+        };
+
+        /**
+         * This class caches the scene features of the most recent frames, so processors and stages that extract features of the
+         * same frame region with identical detector settings extract them only once. The cache is process wide.
+         *
+         * An entry is keyed by the frame, the frame region, the size of the extracted image (the processing resolution), the
+         * detector key of the feature verification and the content of the keypoint mask. Entries keep a reference to their frame,
+         * so the frame data can't be reused by another frame while the entry exists. Only the entries of the most recent frames are
+         * kept, a stopped processing drops the entries it extracted itself.
+         *
+         * The cache is disabled by default: it only hits if several processors or stages extract the same region of a frame, for
+         * example candidate regions of a hybrid recognition or extraction stages of a pipeline recognition.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class SceneFeatureCache
+        {
+            public:
+
+                /**
+                 * Return the cache of this process.
+                 *
+                 * @return the scene feature cache
+                 */
+                static SceneFeatureCache& get();
+
+                /**
+                 * Return the features of a frame region, extracting them only if they are not cached yet. Compact descriptors are
+                 * not cached (they depend on the bit selection of the catalog).
+                 *
+                 * @param owner         processing that extracts the features (see 'clear')
+                 * @param verification  feature verification that extracts the features
+                 * @param frame         the processed frame
+                 * @param region        region of the frame the image was taken from
+                 * @param image         gray scale image of the region at the processing resolution
+                 * @param mask          8-bit mask of the image area to search for keypoints (empty for the whole image)
+                 * @param features      features of the image
+                 */
+                void extract(const void* owner, FeatureVerification& verification, const cv::Mat& frame, const cv::Rect& region, const cv::Mat& image, const cv::Mat& mask,
+                             Features& features);
+
+                /**
+                 * Enable or disable the cache. A disabled cache extracts all features and drops its entries.
+                 *
+                 * @param enabled   <code>true</code> to enable the cache, <code>false</code> to disable it
+                 */
+                void setEnabled(bool enabled);
+
+                /**
+                 * Drop all entries (and release their frames).
+                 */
+                void clear();
+
+                /**
+                 * Drop the entries extracted by a processing and release the frames without entries, so the entries of other
+                 * processings are kept.
+                 *
+                 * @param owner processing that extracted the entries
+                 */
+                void clear(const void* owner);
+
+                /**
+                 * Return the hits and misses since the start or the last reset.
+                 *
+                 * @return hits and misses of the cache
+                 */
+                SceneCacheStatistics getStatistics() const;
+
+                /**
+                 * Reset the hits and misses.
+                 */
+                void resetStatistics();
+
+            private:
+
+                /**
+                 * Cached features of a frame region.
+                 */
+                struct Entry
+                {
+                    /**
+                     * Processing that extracted the features.
+                     */
+                    const void* owner;
+
+                    /**
+                     * The frame (keeps the frame data alive).
+                     */
+                    cv::Mat frame;
+
+                    /**
+                     * Region of the frame.
+                     */
+                    cv::Rect region;
+
+                    /**
+                     * Size of the extracted image.
+                     */
+                    cv::Size size;
+
+                    /**
+                     * Detector key of the feature verification.
+                     */
+                    std::string detector;
+
+                    /**
+                     * Hash of the keypoint mask (0 for no mask).
+                     */
+                    uint64_t maskHash;
+
+                    /**
+                     * Extracted features.
+                     */
+                    Features features;
+                };
+
+                /**
+                 * Create an empty 'SceneFeatureCache' object.
+                 */
+                SceneFeatureCache();
+
+                /**
+                 * Return the hash of a keypoint mask.
+                 *
+                 * @param mask  8-bit mask (empty for no mask)
+                 * @return hash of the mask content (0 for no mask)
+                 */
+                static uint64_t hashMask(const cv::Mat& mask);
+
+                /**
+                 * Find an entry. The caller has to hold the entry lock.
+                 *
+                 * @param frame     the processed frame
+                 * @param region    region of the frame
+                 * @param size      size of the extracted image
+                 * @param detector  detector key of the feature verification
+                 * @param maskHash  hash of the keypoint mask
+                 * @return the entry or <code>nullptr</code> if there is no such entry
+                 */
+                const Entry* find(const cv::Mat& frame, const cv::Rect& region, cv::Size size, const std::string& detector, uint64_t maskHash) const;
+
+                /**
+                 * Indicator to use the cache.
+                 */
+                std::atomic<bool> enabled;
+
+                /**
+                 * Number of extractions served from the cache.
+                 */
+                std::atomic<uint64_t> hits;
+
+                /**
+                 * Number of extractions that had to be computed.
+                 */
+                std::atomic<uint64_t> misses;
+
+                /**
+                 * Mutex of the entries.
+                 */
+                mutable std::mutex entriesMutex;
+
+                /**
+                 * Cached entries.
+                 */
+                std::vector<Entry> entries;
+
+                /**
+                 * Frames with entries (most recent first), accounted as scratch memory while they are kept.
+                 */
+                std::deque<cv::Mat> frames;
+        };
+    }
+}
@@ -0,0 +1,482 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <set>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+// All shards of a frame are polled with a single 'select'
+#ifndef FD_SETSIZE
+#define FD_SETSIZE 256
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+
+#include "ShardProcessing.h"
+#include "CompanionWinRT/native/MemoryAccount.h"
+#include "CompanionWinRT/native/PoseResult.h"
+#include "CompanionWinRT/native/RecognitionProcessing.h"
+#include "CompanionWinRT/native/SceneFeatureCache.h"
+#include "CompanionWinRT/native/ShardProtocol.h"
+
+using namespace CompanionWinRT::Native;
+
+/**
+ * Marker of a closed connection.
+ */
+static const uintptr_t NO_CONNECTION = static_cast<uintptr_t>(INVALID_SOCKET);
+
+/**
+ * Time all shards may take to answer the query of a frame (in milliseconds), shards that miss it are disconnected. Also the send
+ * timeout of a query.
+ */
+static const DWORD SHARD_TIMEOUT = 5000;
+
+ShardProcessing::ShardProcessing(FeatureVerification* verification, cv::Size scaling, int maxCandidates)
+    : verification(verification), scaling(scaling), maxCandidates(std::min<int>(MAX_SHARD_CANDIDATES, std::max(1, maxCandidates))), maxObjects(0),
+      shardCounter(0), frameCounter(0), failedQueries(0)
+{
+    WSADATA wsaData;
+    WSAStartup(MAKEWORD(2, 2), &wsaData);
+}
+
+ShardProcessing::~ShardProcessing()
+{
+    this->clearShards();
+    WSACleanup();
+}
+
+bool ShardProcessing::addShard(const std::string& host, int port)
+{
+    Shard shard = { 0, host, port, connect(host, port) };
+    if (shard.connection == NO_CONNECTION)
+    {
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(this->shardsMutex);
+    if (this->shards.size() >= FD_SETSIZE)
+    {
+        disconnect(shard);
+        return false;
+    }
+    shard.id = ++this->shardCounter;
+    this->shards.push_back(shard);
+    return true;
+}
+
+void ShardProcessing::clearShards()
+{
+    std::lock_guard<std::mutex> lock(this->shardsMutex);
+    for (size_t i = 0; i < this->shards.size(); i++)
+    {
+        disconnect(this->shards[i]);
+    }
+    this->shards.clear();
+}
+
+bool ShardProcessing::isQueryable() const
+{
+    return this->verification->getDetectorKey().size() < SHARD_DETECTOR_KEY_SIZE;
+}
+
+int ShardProcessing::getShardCount()
+{
+    std::lock_guard<std::mutex> lock(this->shardsMutex);
+    return static_cast<int>(this->shards.size());
+}
+
+void ShardProcessing::setMaxObjects(int maxObjects)
+{
+    this->maxObjects = std::max(0, maxObjects);
+}
+
+int ShardProcessing::getMaxObjects()
+{
+    return this->maxObjects;
+}
+
+void ShardProcessing::setRegionMask(const cv::Mat& mask)
+{
+    this->regionMask.set(mask);
+}
+
+uint64_t ShardProcessing::getFailedQueries() const
+{
+    return this->failedQueries;
+}
+
+std::vector<Companion::Model::Result::Result*> ShardProcessing::execute(cv::Mat frame)
+{
+    std::vector<Companion::Model::Result::Result*> results;
+    this->work.begin();
+
+    // Scale the frame down to the processing resolution
+    cv::Mat scene = RecognitionProcessing::toGray(frame);
+    cv::Mat mask = this->regionMask.get(frame.size());
+    double factor = std::min(1.0, std::min(static_cast<double>(this->scaling.width) / scene.cols, static_cast<double>(this->scaling.height) / scene.rows));
+    if (factor < 1.0)
+    {
+        cv::resize(scene, scene, cv::Size(), factor, factor, cv::INTER_AREA);
+        if (!mask.empty())
+        {
+            cv::resize(mask, mask, scene.size(), 0.0, 0.0, cv::INTER_NEAREST);
+        }
+    }
+
+    Features sceneFeatures;
+    SceneFeatureCache::get().extract(static_cast<const Companion::Processing::ImageProcessing*>(this), *this->verification, frame, cv::Rect(0, 0, frame.cols, frame.rows),
+                                     scene, mask, sceneFeatures);
+    this->work.addSceneKeypoints(sceneFeatures.keypoints.size());
+    if (sceneFeatures.keypoints.empty())
+    {
+        this->work.finish(results);
+        return results;
+    }
+
+    // Check out the connections, so adding or clearing shards doesn't wait for the socket I/O of this frame
+    std::vector<Shard> frameShards;
+    uint32_t frameNumber;
+    {
+        std::lock_guard<std::mutex> lock(this->shardsMutex);
+        frameNumber = ++this->frameCounter;
+        frameShards = this->shards;
+        for (size_t i = 0; i < this->shards.size(); i++)
+        {
+            this->shards[i].connection = NO_CONNECTION;
+        }
+    }
+
+    std::vector<uint8_t> query;
+    bool encoded = this->encodeQuery(frameNumber, sceneFeatures, query);
+    MemoryCharge scratch(MemoryComponent::SCRATCH, MemoryAccount::getBytes(scene) + sceneFeatures.getBytes() + static_cast<int64_t>(query.size()));
+
+    // Broadcast the query first, so all shards verify their models at the same time
+    std::vector<ReplyState> states(frameShards.size(), ReplyState::FAILED);
+    for (size_t i = 0; i < frameShards.size(); i++)
+    {
+        Shard& shard = frameShards[i];
+        if (!encoded)
+        {
+            // The detector key doesn't fit into the query, the connection itself is fine
+            this->failedQueries++;
+            continue;
+        }
+
+        if (shard.connection == NO_CONNECTION)
+        {
+            shard.connection = connect(shard.host, shard.port);
+        }
+        if ((shard.connection != NO_CONNECTION) && sendAll(shard.connection, query.data(), query.size()))
+        {
+            states[i] = ReplyState::PENDING;
+        }
+        else
+        {
+            disconnect(shard);
+            this->failedQueries++;
+        }
+    }
+
+    // Poll all shards together, so the frame waits for the slowest shard at most until the deadline
+    std::vector<std::vector<uint8_t>> replies(frameShards.size());
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(SHARD_TIMEOUT);
+    while (std::find(states.begin(), states.end(), ReplyState::PENDING) != states.end())
+    {
+        long long remaining = std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now()).count();
+        if (remaining <= 0)
+        {
+            break;
+        }
+
+        fd_set readable;
+        FD_ZERO(&readable);
+        for (size_t i = 0; i < frameShards.size(); i++)
+        {
+            if (states[i] == ReplyState::PENDING)
+            {
+                FD_SET(static_cast<SOCKET>(frameShards[i].connection), &readable);
+            }
+        }
+
+        timeval timeout = { static_cast<long>(remaining / 1000000), static_cast<long>(remaining % 1000000) };
+        if (select(0, &readable, nullptr, nullptr, &timeout) == SOCKET_ERROR)
+        {
+            break;
+        }
+
+        for (size_t i = 0; i < frameShards.size(); i++)
+        {
+            if ((states[i] != ReplyState::PENDING) || !FD_ISSET(static_cast<SOCKET>(frameShards[i].connection), &readable))
+            {
+                continue;
+            }
+
+            states[i] = receive(frameShards[i].connection, frameNumber, replies[i]);
+            if (states[i] == ReplyState::FAILED)
+            {
+                // The connection is out of sync, so the shard is reconnected with the next frame
+                disconnect(frameShards[i]);
+                this->failedQueries++;
+            }
+        }
+    }
+
+    // Gather the candidates of all shards
+    std::vector<ShardCandidate> candidates;
+    for (size_t i = 0; i < frameShards.size(); i++)
+    {
+        if (states[i] == ReplyState::PENDING)
+        {
+            // The shard missed the deadline, a late reply must not be taken for the next frame
+            disconnect(frameShards[i]);
+            this->failedQueries++;
+            continue;
+        }
+        if (states[i] != ReplyState::ANSWERED)
+        {
+            continue;
+        }
+
+        ShardResponseHeader header;
+        std::memcpy(&header, replies[i].data(), sizeof(header));
+        if (header.status != SHARD_STATUS_OK)
+        {
+            // The shard uses another detector, matcher or other verification parameters, its part of the catalog can't be searched
+            this->failedQueries++;
+            continue;
+        }
+
+        size_t offset = candidates.size();
+        candidates.resize(offset + header.count);
+        std::memcpy(candidates.data() + offset, replies[i].data() + sizeof(header), header.count * sizeof(ShardCandidate));
+
+        // The work of the shard's verifications only arrives as totals
+        FrameWork shardWork = {};
+        shardWork.verifiedModels = header.verifiedModels;
+        shardWork.descriptorsMatched = static_cast<int64_t>(header.descriptorsMatched);
+        shardWork.rawMatches = static_cast<int64_t>(header.rawMatches);
+        shardWork.filteredMatches = static_cast<int64_t>(header.filteredMatches);
+        shardWork.ransacIterations = static_cast<int64_t>(header.ransacIterations);
+        shardWork.inliers = static_cast<int64_t>(header.inliers);
+        this->work.addTotals(shardWork);
+    }
+
+    // Return the connections, shards that were cleared in the meantime are disconnected here
+    {
+        std::lock_guard<std::mutex> lock(this->shardsMutex);
+        for (size_t i = 0; i < frameShards.size(); i++)
+        {
+            auto shard = std::find_if(this->shards.begin(), this->shards.end(), [&](const Shard& entry) { return entry.id == frameShards[i].id; });
+            if ((shard != this->shards.end()) && (shard->connection == NO_CONNECTION))
+            {
+                shard->connection = frameShards[i].connection;
+            }
+            else
+            {
+                disconnect(frameShards[i]);
+            }
+        }
+    }
+
+    // Merge by score, ties by model ID, so the results don't depend on the response order
+    std::sort(candidates.begin(), candidates.end(), [](const ShardCandidate& a, const ShardCandidate& b)
+    {
+        if (a.score != b.score)
+        {
+            return a.score > b.score;
+        }
+        return a.id < b.id;
+    });
+
+    std::set<int> mergedIDs;
+    size_t maxObjects = static_cast<size_t>(this->maxObjects);
+    cv::Matx33d scale(1.0 / factor, 0.0, 0.0, 0.0, 1.0 / factor, 0.0, 0.0, 0.0, 1.0);
+    for (size_t i = 0; (i < candidates.size()) && ((maxObjects == 0) || (results.size() < maxObjects)); i++)
+    {
+        const ShardCandidate& candidate = candidates[i];
+        if (!mergedIDs.insert(candidate.id).second)
+        {
+            continue;
+        }
+
+        // Map the candidate back to frame coordinates
+        std::vector<cv::Point2f> corners;
+        for (int j = 0; j < 4; j++)
+        {
+            corners.push_back(cv::Point2f(candidate.corners[j * 2], candidate.corners[j * 2 + 1]) * (1.0 / factor));
+        }
+        cv::Matx33d homography(candidate.homography);
+
+        results.push_back(new PoseResult(candidate.score, candidate.id, corners, scale * homography));
+    }
+
+    this->work.finish(results);
+    return results;
+}
+
+uintptr_t ShardProcessing::connect(const std::string& host, int port)
+{
+    addrinfo hints = {};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    hints.ai_protocol = IPPROTO_TCP;
+    addrinfo* addresses = nullptr;
+    if (getaddrinfo(host.c_str(), std::to_string(port).c_str(), &hints, &addresses) != 0)
+    {
+        return NO_CONNECTION;
+    }
+
+    SOCKET socket = INVALID_SOCKET;
+    for (addrinfo* address = addresses; (address != nullptr) && (socket == INVALID_SOCKET); address = address->ai_next)
+    {
+        socket = ::socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+        if ((socket != INVALID_SOCKET) && (::connect(socket, address->ai_addr, static_cast<int>(address->ai_addrlen)) == SOCKET_ERROR))
+        {
+            closesocket(socket);
+            socket = INVALID_SOCKET;
+        }
+    }
+    freeaddrinfo(addresses);
+    if (socket == INVALID_SOCKET)
+    {
+        return NO_CONNECTION;
+    }
+
+    // Queries are small and latency bound, a hanging shard must not block the processing (replies are polled until the deadline)
+    BOOL noDelay = TRUE;
+    DWORD timeout = SHARD_TIMEOUT;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+    setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeout), sizeof(timeout));
+
+    return static_cast<uintptr_t>(socket);
+}
+
+void ShardProcessing::disconnect(Shard& shard)
+{
+    if (shard.connection != NO_CONNECTION)
+    {
+        closesocket(static_cast<SOCKET>(shard.connection));
+        shard.connection = NO_CONNECTION;
+    }
+}
+
+bool ShardProcessing::sendAll(uintptr_t connection, const uint8_t* data, size_t size)
+{
+    for (size_t position = 0; position < size;)
+    {
+        int count = send(static_cast<SOCKET>(connection), reinterpret_cast<const char*>(data + position), static_cast<int>(size - position), 0);
+        if (count <= 0)
+        {
+            return false;
+        }
+        position += count;
+    }
+
+    return true;
+}
+
+ShardProcessing::ReplyState ShardProcessing::receive(uintptr_t connection, uint32_t frame, std::vector<uint8_t>& reply)
+{
+    // The header tells the size of the whole reply
+    ShardResponseHeader header;
+    size_t expected = sizeof(header);
+    if (reply.size() >= sizeof(header))
+    {
+        std::memcpy(&header, reply.data(), sizeof(header));
+        expected += header.count * sizeof(ShardCandidate);
+    }
+
+    size_t position = reply.size();
+    reply.resize(expected);
+    int count = recv(static_cast<SOCKET>(connection), reinterpret_cast<char*>(reply.data() + position), static_cast<int>(expected - position), 0);
+    if (count <= 0)
+    {
+        return ReplyState::FAILED;
+    }
+    reply.resize(position + count);
+
+    if (reply.size() < sizeof(header))
+    {
+        return ReplyState::PENDING;
+    }
+
+    std::memcpy(&header, reply.data(), sizeof(header));
+    if ((header.magic != SHARD_RESPONSE_MAGIC) || (header.frame != frame) || (header.count > MAX_SHARD_CANDIDATES))
+    {
+        return ReplyState::FAILED;
+    }
+
+    return (reply.size() == sizeof(header) + header.count * sizeof(ShardCandidate)) ? ReplyState::ANSWERED : ReplyState::PENDING;
+}
+
+bool ShardProcessing::encodeQuery(uint32_t frame, const Features& scene, std::vector<uint8_t>& query)
+{
+    ShardQueryHeader header = {};
+    header.magic = SHARD_QUERY_MAGIC;
+    header.frame = frame;
+    header.width = scene.size.width;
+    header.height = scene.size.height;
+    header.keypointCount = static_cast<uint32_t>(scene.keypoints.size());
+    header.descriptorType = scene.descriptors.type();
+    header.descriptorBytes = static_cast<uint32_t>(scene.descriptors.cols * scene.descriptors.elemSize());
+    header.maxCandidates = static_cast<uint16_t>(this->maxCandidates);
+
+    // The shards compare the extraction and verification settings with their own, a truncated key could match another detector
+    std::string detectorKey = this->verification->getDetectorKey();
+    if (detectorKey.size() >= SHARD_DETECTOR_KEY_SIZE)
+    {
+        return false;
+    }
+    VerificationParameters parameters = this->verification->getParameters();
+    detectorKey.copy(header.detectorKey, detectorKey.size());
+    header.matcherType = parameters.matcherType;
+    header.minSideLength = parameters.minSideLength;
+    header.countMatches = parameters.countMatches;
+    header.reprojThreshold = parameters.reprojThreshold;
+    header.ransacMaxIters = parameters.ransacMaxIters;
+    header.findHomographyMethod = parameters.findHomographyMethod;
+    header.modelLevels = parameters.modelLevels;
+    header.houghVoting = parameters.houghVoting ? 1 : 0;
+
+    query.resize(sizeof(header) + header.keypointCount * (sizeof(ShardKeypoint) + header.descriptorBytes));
+    uint8_t* data = query.data();
+    std::memcpy(data, &header, sizeof(header));
+    data += sizeof(header);
+
+    for (size_t i = 0; i < scene.keypoints.size(); i++)
+    {
+        const cv::KeyPoint& keypoint = scene.keypoints[i];
+        ShardKeypoint packed = { keypoint.pt.x, keypoint.pt.y, keypoint.size, keypoint.angle, keypoint.response, keypoint.octave };
+        std::memcpy(data, &packed, sizeof(packed));
+        data += sizeof(packed);
+    }
+
+    for (int row = 0; row < scene.descriptors.rows; row++)
+    {
+        std::memcpy(data, scene.descriptors.ptr(row), header.descriptorBytes);
+        data += header.descriptorBytes;
+    }
+
+    return true;
+}
@@ -0,0 +1,279 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <companion/processing/ImageProcessing.h>
+
+#include "CompanionWinRT/native/FeatureVerification.h"
+#include "CompanionWinRT/native/RegionMask.h"
+#include "CompanionWinRT/native/WorkCounter.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class coordinates a feature matching over a model catalog that is partitioned across local shard processes.
+         *
+         * Scene features are extracted once per frame and broadcast to all shards over TCP (see 'ShardProtocol.h'). Every shard
+         * verifies its part of the catalog and returns its best candidates with their homographies. The candidates of all shards are
+         * merged by their score (ties by model ID), so the result does not depend on the response order of the shards.
+         *
+         * The replies of all shards are gathered together until a deadline per frame. A shard that fails to answer in time is
+         * disconnected and reconnected with the next frame, its part of the catalog is missing in the results of the affected frames.
+         * Every query carries the detector key, the descriptor matcher type and the verification parameters, a shard with other
+         * settings rejects the query instead of verifying its models.
+         *
+         * The socket I/O of a frame runs on connections checked out of the shard list, so shards can be added or cleared without
+         * waiting for a frame.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class ShardProcessing : public Companion::Processing::ImageProcessing
+        {
+            public:
+
+                /**
+                 * Create a 'ShardProcessing' object.
+                 *
+                 * @param verification  feature verification used to extract the scene features (the shards have to use the same
+                 *                      detector type and parameters)
+                 * @param scaling       processing resolution of the frames
+                 * @param maxCandidates maximum number of candidates per shard (at most 'MAX_SHARD_CANDIDATES')
+                 */
+                ShardProcessing(FeatureVerification* verification, cv::Size scaling, int maxCandidates);
+
+                /**
+                 * Disconnect from all shards and destruct this instance.
+                 */
+                virtual ~ShardProcessing();
+
+                /**
+                 * Connect to a shard process.
+                 *
+                 * @param host  host name or address of the shard
+                 * @param port  TCP port of the shard
+                 * @return <code>true</code> if the connection was established, <code>false</code> otherwise (also if no further shard
+                 *         can be polled)
+                 */
+                bool addShard(const std::string& host, int port);
+
+                /**
+                 * Check whether the detector key of the feature verification fits into a shard query. Frames of a longer key are not
+                 * queried (counted as failed queries).
+                 *
+                 * @return <code>true</code> if the detector key can be queried, <code>false</code> otherwise
+                 */
+                bool isQueryable() const;
+
+                /**
+                 * Disconnect from all shards. Connections of a frame in progress are closed once the frame is finished.
+                 */
+                void clearShards();
+
+                /**
+                 * Return the number of shards.
+                 *
+                 * @return number of shards
+                 */
+                int getShardCount();
+
+                /**
+                 * Set the maximum number of objects per frame. The merged candidates with the best scores are kept.
+                 *
+                 * @param maxObjects    maximum number of objects per frame (0 for no limit)
+                 */
+                void setMaxObjects(int maxObjects);
+
+                /**
+                 * Return the maximum number of objects per frame.
+                 *
+                 * @return maximum number of objects per frame (0 for no limit)
+                 */
+                int getMaxObjects();
+
+                /**
+                 * Set the region mask of the frames.
+                 *
+                 * @param mask  8-bit single channel mask (empty to process the whole frame)
+                 */
+                void setRegionMask(const cv::Mat& mask);
+
+                /**
+                 * Return the number of shard queries that were not answered or rejected because of other detector or verification
+                 * settings.
+                 *
+                 * @return number of failed shard queries
+                 */
+                uint64_t getFailedQueries() const;
+
+                /**
+                 * Recognize the models of all shards in the given frame.
+                 *
+                 * @param frame frame to process
+                 * @return recognition results
+                 */
+                virtual std::vector<Companion::Model::Result::Result*> execute(cv::Mat frame) override;
+
+            private:
+
+                /**
+                 * Connection to a shard process.
+                 */
+                struct Shard
+                {
+                    /**
+                     * Unique ID of the shard.
+                     */
+                    uint64_t id;
+
+                    /**
+                     * Host name or address of the shard.
+                     */
+                    std::string host;
+
+                    /**
+                     * TCP port of the shard.
+                     */
+                    int port;
+
+                    /**
+                     * Socket of the connection (invalid socket if disconnected).
+                     */
+                    uintptr_t connection;
+                };
+
+                /**
+                 * State of the reply of a shard to the query of a frame.
+                 */
+                enum class ReplyState
+                {
+                    FAILED,     ///< The shard was not queried or its reply is invalid.
+                    PENDING,    ///< The reply is incomplete.
+                    ANSWERED    ///< The reply is complete.
+                };
+
+                /**
+                 * Connect to a shard process.
+                 *
+                 * @param host  host name or address of the shard
+                 * @param port  TCP port of the shard
+                 * @return socket of the connection (invalid socket on failure)
+                 */
+                static uintptr_t connect(const std::string& host, int port);
+
+                /**
+                 * Close the connection of a shard.
+                 *
+                 * @param shard shard to disconnect
+                 */
+                static void disconnect(Shard& shard);
+
+                /**
+                 * Send the given bytes completely.
+                 *
+                 * @param connection    socket of the connection
+                 * @param data          first byte to send
+                 * @param size          number of bytes to send
+                 * @return <code>true</code> if all bytes were sent, <code>false</code> otherwise
+                 */
+                static bool sendAll(uintptr_t connection, const uint8_t* data, size_t size);
+
+                /**
+                 * Receive the available bytes of the reply of a shard. Only called for a readable connection, so it doesn't block.
+                 *
+                 * @param connection    socket of the connection
+                 * @param frame         frame number of the query
+                 * @param reply         bytes of the reply received so far
+                 * @return state of the reply
+                 */
+                static ReplyState receive(uintptr_t connection, uint32_t frame, std::vector<uint8_t>& reply);
+
+                /**
+                 * Encode a shard query of the given scene features.
+                 *
+                 * @param frame     frame number of the query
+                 * @param scene     scene features
+                 * @param query     encoded query
+                 * @return <code>true</code> if the query was encoded, <code>false</code> if the detector key doesn't fit into the query
+                 */
+                bool encodeQuery(uint32_t frame, const Features& scene, std::vector<uint8_t>& query);
+
+                /**
+                 * Feature verification used to extract the scene features.
+                 */
+                FeatureVerification* verification;
+
+                /**
+                 * Processing resolution of the frames.
+                 */
+                cv::Size scaling;
+
+                /**
+                 * Maximum number of candidates per shard.
+                 */
+                int maxCandidates;
+
+                /**
+                 * Maximum number of objects per frame (0 for no limit).
+                 */
+                std::atomic<int> maxObjects;
+
+                /**
+                 * Region mask of the frames.
+                 */
+                RegionMask regionMask;
+
+                /**
+                 * Connections to all shards.
+                 */
+                std::vector<Shard> shards;
+
+                /**
+                 * Mutex of the shard list, never held during socket I/O.
+                 */
+                std::mutex shardsMutex;
+
+                /**
+                 * Number of added shards, provides the shard IDs.
+                 */
+                uint64_t shardCounter;
+
+                /**
+                 * Number of processed frames.
+                 */
+                uint32_t frameCounter;
+
+                /**
+                 * Number of shard queries that were not answered or rejected.
+                 */
+                std::atomic<uint64_t> failedQueries;
+
+                /**
+                 * Work counters of the current frame.
+                 */
+                WorkCounter work;
+        };
+    }
+}
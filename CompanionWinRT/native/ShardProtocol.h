@@ -0,0 +1,287 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * Magic number at the start of a shard query ("CSHQ").
+         */
+        const uint32_t SHARD_QUERY_MAGIC = 0x51485343;
+
+        /**
+         * Magic number at the start of a shard response ("CSHR").
+         */
+        const uint32_t SHARD_RESPONSE_MAGIC = 0x52485343;
+
+        /**
+         * Maximum number of candidates per shard response.
+         */
+        const uint16_t MAX_SHARD_CANDIDATES = 64;
+
+        /**
+         * Maximum number of scene keypoints per shard query, protects against corrupt count fields.
+         */
+        const uint32_t MAX_SHARD_KEYPOINTS = 1 << 20;
+
+        /**
+         * Maximum size of a single descriptor (in bytes), protects against corrupt size fields.
+         */
+        const uint32_t MAX_SHARD_DESCRIPTOR_BYTES = 1024;
+
+        /**
+         * Size of the detector key of a shard query (in bytes, including the terminating zero). Longer keys can't be queried.
+         */
+        const size_t SHARD_DETECTOR_KEY_SIZE = 64;
+
+        /**
+         * Status of a shard response: the models of the shard were verified.
+         */
+        const uint8_t SHARD_STATUS_OK = 0;
+
+        /**
+         * Status of a shard response: the detector, the descriptor matcher or the verification parameters of the query don't match
+         * the shard, no models were verified.
+         */
+        const uint8_t SHARD_STATUS_MISMATCH = 1;
+
+#pragma pack(push, 1)
+
+        /**
+         * Header of a shard query. Coordinator and shards are local processes, so all fields are sent in host byte order.
+         *
+         * The header is followed by 'keypointCount' keypoints ('ShardKeypoint') and 'keypointCount' descriptor rows of
+         * 'descriptorBytes' bytes each.
+         */
+        struct ShardQueryHeader
+        {
+            /**
+             * Magic number 'SHARD_QUERY_MAGIC'.
+             */
+            uint32_t magic;
+
+            /**
+             * Frame number of the query, repeated in the response.
+             */
+            uint32_t frame;
+
+            /**
+             * Width of the scene the features were extracted from (in pixels).
+             */
+            int32_t width;
+
+            /**
+             * Height of the scene the features were extracted from (in pixels).
+             */
+            int32_t height;
+
+            /**
+             * Number of scene keypoints.
+             */
+            uint32_t keypointCount;
+
+            /**
+             * OpenCV type of the descriptors.
+             */
+            int32_t descriptorType;
+
+            /**
+             * Size of a single descriptor (in bytes).
+             */
+            uint32_t descriptorBytes;
+
+            /**
+             * Maximum number of candidates the shard returns (at most 'MAX_SHARD_CANDIDATES').
+             */
+            uint16_t maxCandidates;
+
+            /**
+             * Detector key of the scene extraction (zero terminated, see 'FeatureVerification::getDetectorKey').
+             */
+            char detectorKey[SHARD_DETECTOR_KEY_SIZE];
+
+            /**
+             * OpenCV type of the descriptor matcher ('cv::DescriptorMatcher::MatcherType').
+             */
+            int32_t matcherType;
+
+            /**
+             * Minimum length of the detected area's sides (in pixels).
+             */
+            int32_t minSideLength;
+
+            /**
+             * How many matches should be found for a good matching result.
+             */
+            int32_t countMatches;
+
+            /**
+             * Maximum allowed reprojection error to treat a point pair as an inlier.
+             */
+            double reprojThreshold;
+
+            /**
+             * Maximum number of RANSAC iterations.
+             */
+            int32_t ransacMaxIters;
+
+            /**
+             * Method used to compute a homography matrix.
+             */
+            int32_t findHomographyMethod;
+
+            /**
+             * Number of model pyramid levels.
+             */
+            int32_t modelLevels;
+
+            /**
+             * Indicator that the geometric pre-verification is enabled (0 or 1).
+             */
+            uint8_t houghVoting;
+        };
+
+        /**
+         * A scene keypoint of a shard query.
+         */
+        struct ShardKeypoint
+        {
+            /**
+             * Keypoint position (in scene pixels).
+             */
+            float x;
+
+            /**
+             * Keypoint position (in scene pixels).
+             */
+            float y;
+
+            /**
+             * Diameter of the keypoint neighborhood.
+             */
+            float size;
+
+            /**
+             * Keypoint orientation (in degrees, -1 if not applicable).
+             */
+            float angle;
+
+            /**
+             * Detector response of the keypoint.
+             */
+            float response;
+
+            /**
+             * Pyramid octave the keypoint was detected at.
+             */
+            int32_t octave;
+        };
+
+        /**
+         * Header of a shard response, followed by 'count' candidates ('ShardCandidate') in descending order of their score. The work
+         * counters sum up the verifications of all models of the shard.
+         */
+        struct ShardResponseHeader
+        {
+            /**
+             * Magic number 'SHARD_RESPONSE_MAGIC'.
+             */
+            uint32_t magic;
+
+            /**
+             * Frame number of the answered query.
+             */
+            uint32_t frame;
+
+            /**
+             * Number of candidates.
+             */
+            uint16_t count;
+
+            /**
+             * Status of the response ('SHARD_STATUS_OK' or 'SHARD_STATUS_MISMATCH').
+             */
+            uint8_t status;
+
+            /**
+             * Number of verified models.
+             */
+            uint32_t verifiedModels;
+
+            /**
+             * Number of model descriptors matched against the scene.
+             */
+            uint64_t descriptorsMatched;
+
+            /**
+             * Number of distinctive matches.
+             */
+            uint64_t rawMatches;
+
+            /**
+             * Number of matches passed to the robust estimation.
+             */
+            uint64_t filteredMatches;
+
+            /**
+             * Estimated number of robust estimation iterations.
+             */
+            uint64_t ransacIterations;
+
+            /**
+             * Number of inliers.
+             */
+            uint64_t inliers;
+        };
+
+        /**
+         * A model verified by a shard.
+         */
+        struct ShardCandidate
+        {
+            /**
+             * The ID of the verified model.
+             */
+            int32_t id;
+
+            /**
+             * Verification score (0% - 100%).
+             */
+            int16_t score;
+
+            /**
+             * Homography from model to scene coordinates (row-major).
+             */
+            double homography[9];
+
+            /**
+             * Model corners in scene coordinates as x, y pairs (upper left, upper right, lower right, lower left).
+             */
+            float corners[8];
+        };
+
+#pragma pack(pop)
+    }
+}
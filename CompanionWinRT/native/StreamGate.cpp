@@ -0,0 +1,66 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <thread>
+
+#include "StreamGate.h"
+
+using namespace CompanionWinRT::Native;
+
+StreamGate::StreamGate()
+    : closed(false), producers(0)
+{
+}
+
+bool StreamGate::enter()
+{
+    // Register first, so 'close' either sees this producer or this producer sees the closed gate
+    this->producers++;
+    if (this->closed)
+    {
+        this->producers--;
+        return false;
+    }
+
+    return true;
+}
+
+void StreamGate::leave()
+{
+    this->producers--;
+}
+
+void StreamGate::close(const std::function<void()>& drain)
+{
+    this->closed = true;
+    while (this->producers > 0)
+    {
+        drain();
+        std::this_thread::yield();
+    }
+}
+
+void StreamGate::open()
+{
+    this->closed = false;
+}
+
+bool StreamGate::isOpen() const
+{
+    return !this->closed;
+}
@@ -0,0 +1,91 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <functional>
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class guards the producers of an image stream against a stopped consumer.
+         *
+         * Adding an image blocks as long as the image buffer of the stream is full. If the processing is stopped meanwhile, nobody
+         * takes images out of the buffer anymore and the producer hangs. Producers enter the gate before they add an image and
+         * leave it afterwards. Closing the gate rejects new producers and drains the buffer until all producers inside have left.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class StreamGate
+        {
+            public:
+
+                /**
+                 * Create an open 'StreamGate' object.
+                 */
+                StreamGate();
+
+                /**
+                 * Enter the gate before an image is added to the stream.
+                 *
+                 * @return <code>true</code> if the image can be added, <code>false</code> if the gate is closed (don't leave then)
+                 */
+                bool enter();
+
+                /**
+                 * Leave the gate after an image was added to the stream.
+                 */
+                void leave();
+
+                /**
+                 * Close the gate and wait until all producers inside have left. The drain function is called repeatedly meanwhile and
+                 * has to take an image out of the stream without blocking, so blocked producers can complete.
+                 *
+                 * @param drain function that takes an image out of the stream
+                 */
+                void close(const std::function<void()>& drain);
+
+                /**
+                 * Open the gate again.
+                 */
+                void open();
+
+                /**
+                 * Check whether the gate is open.
+                 *
+                 * @return <code>true</code> if the gate is open, <code>false</code> otherwise
+                 */
+                bool isOpen() const;
+
+            private:
+
+                /**
+                 * Indicator that the gate is closed.
+                 */
+                std::atomic<bool> closed;
+
+                /**
+                 * Number of producers inside the gate.
+                 */
+                std::atomic<int> producers;
+        };
+    }
+}
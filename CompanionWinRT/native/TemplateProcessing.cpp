@@ -0,0 +1,283 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <opencv2/core/utility.hpp>
+#include <opencv2/imgproc/imgproc.hpp>
+
+#include "TemplateProcessing.h"
+#include "CompanionWinRT/native/MemoryAccount.h"
+#include "CompanionWinRT/native/PoseResult.h"
+#include "CompanionWinRT/native/RecognitionProcessing.h"
+
+using namespace CompanionWinRT::Native;
+
+/**
+ * Tolerance of the coarse search below the threshold, so templates that lose correlation by downscaling are still refined.
+ */
+static const double COARSE_TOLERANCE = 0.1;
+
+/**
+ * Minimum side length of a coarse template (in pixels).
+ */
+static const int MIN_COARSE_SIZE = 4;
+
+/**
+ * Compute the spectrum of an image zero padded to the given transform size.
+ *
+ * @param image     single channel float image
+ * @param size      transform size
+ * @param spectrum  spectrum in packed format
+ */
+static void computeSpectrum(const cv::Mat& image, cv::Size size, cv::Mat& spectrum)
+{
+    if ((image.cols > size.width) || (image.rows > size.height))
+    {
+        // Templates larger than the scene are skipped
+        spectrum.release();
+        return;
+    }
+
+    cv::Mat padded = cv::Mat::zeros(size, CV_32F);
+    image.copyTo(padded(cv::Rect(0, 0, image.cols, image.rows)));
+    cv::dft(padded, spectrum, 0, image.rows);
+}
+
+TemplateProcessing::TemplateProcessing(double threshold, int pyramidLevels)
+    : threshold(std::min(1.0, std::max(0.0, threshold))), pyramidLevels(std::min(4, std::max(0, pyramidLevels)))
+{
+}
+
+TemplateProcessing::~TemplateProcessing()
+{
+    this->clearModels();
+}
+
+bool TemplateProcessing::addModel(int id, const cv::Mat& image)
+{
+    if (image.empty())
+    {
+        return false;
+    }
+
+    std::unique_ptr<Template> model(new Template());
+    model->id = id;
+    model->image = RecognitionProcessing::toGray(image).clone();
+
+    double factor = 1.0 / (1 << this->pyramidLevels);
+    cv::Mat coarse = model->image;
+    if (this->pyramidLevels > 0)
+    {
+        cv::resize(model->image, coarse, cv::Size(), factor, factor, cv::INTER_AREA);
+    }
+    if ((coarse.cols < MIN_COARSE_SIZE) || (coarse.rows < MIN_COARSE_SIZE))
+    {
+        return false;
+    }
+
+    coarse.convertTo(model->coarse, CV_32F);
+    model->coarse -= cv::mean(model->coarse);
+    model->coarseNorm = cv::norm(model->coarse);
+    if (model->coarseNorm <= 0.0)
+    {
+        // A uniform template does not correlate with anything
+        return false;
+    }
+
+    std::lock_guard<ContentionMutex> lock(this->templatesMutex);
+    if (this->spectrumSize.area() > 0)
+    {
+        computeSpectrum(model->coarse, this->spectrumSize, model->spectrum);
+    }
+    account(*model, 1);
+    this->templates.push_back(std::move(model));
+
+    return true;
+}
+
+void TemplateProcessing::removeModel(int id)
+{
+    std::lock_guard<ContentionMutex> lock(this->templatesMutex);
+    this->templates.erase(std::remove_if(this->templates.begin(), this->templates.end(), [id](const std::unique_ptr<Template>& model)
+    {
+        if (model->id != id)
+        {
+            return false;
+        }
+        account(*model, -1);
+        return true;
+    }), this->templates.end());
+}
+
+void TemplateProcessing::clearModels()
+{
+    std::lock_guard<ContentionMutex> lock(this->templatesMutex);
+    for (size_t i = 0; i < this->templates.size(); i++)
+    {
+        account(*this->templates[i], -1);
+    }
+    this->templates.clear();
+}
+
+std::vector<Companion::Model::Result::Result*> TemplateProcessing::execute(cv::Mat frame)
+{
+    std::vector<Companion::Model::Result::Result*> results;
+
+    cv::Mat scene = RecognitionProcessing::toGray(frame);
+    int scale = 1 << this->pyramidLevels;
+    cv::Mat coarseScene = scene;
+    if (this->pyramidLevels > 0)
+    {
+        cv::resize(scene, coarseScene, cv::Size(), 1.0 / scale, 1.0 / scale, cv::INTER_AREA);
+    }
+    coarseScene.convertTo(coarseScene, CV_32F);
+
+    std::lock_guard<ContentionMutex> lock(this->templatesMutex);
+    if (this->templates.empty())
+    {
+        return results;
+    }
+
+    // Template spectra are cached for the transform size of the scene
+    cv::Size size(cv::getOptimalDFTSize(coarseScene.cols), cv::getOptimalDFTSize(coarseScene.rows));
+    if (size != this->spectrumSize)
+    {
+        this->updateSpectra(size);
+    }
+
+    cv::Mat sceneSpectrum;
+    computeSpectrum(coarseScene, size, sceneSpectrum);
+
+    // Window sums for the normalization of the correlation
+    cv::Mat sum, sqsum;
+    cv::integral(coarseScene, sum, sqsum, CV_64F, CV_64F);
+    MemoryCharge scratch(MemoryComponent::SCRATCH, MemoryAccount::getBytes(coarseScene) + MemoryAccount::getBytes(sceneSpectrum)
+                                                   + MemoryAccount::getBytes(sum) + MemoryAccount::getBytes(sqsum));
+
+    std::vector<double> scores(this->templates.size(), -1.0);
+    std::vector<cv::Point> locations(this->templates.size());
+    cv::Rect sceneArea(0, 0, scene.cols, scene.rows);
+
+    cv::parallel_for_(cv::Range(0, static_cast<int>(this->templates.size())), [&](const cv::Range& range)
+    {
+        for (int i = range.start; i < range.end; i++)
+        {
+            const Template* model = this->templates[i].get();
+            int width = model->coarse.cols;
+            int height = model->coarse.rows;
+            if ((width > coarseScene.cols) || (height > coarseScene.rows))
+            {
+                continue;
+            }
+
+            // Coarse search: correlation in the frequency domain
+            cv::Mat product, correlation;
+            cv::mulSpectrums(sceneSpectrum, model->spectrum, product, 0, true);
+            cv::idft(product, correlation, cv::DFT_REAL_OUTPUT | cv::DFT_SCALE);
+
+            double area = static_cast<double>(width * height);
+            double best = -1.0;
+            cv::Point bestLocation;
+            for (int y = 0; y <= coarseScene.rows - height; y++)
+            {
+                for (int x = 0; x <= coarseScene.cols - width; x++)
+                {
+                    double windowSum = sum.at<double>(y + height, x + width) - sum.at<double>(y, x + width) - sum.at<double>(y + height, x) + sum.at<double>(y, x);
+                    double windowSqsum = sqsum.at<double>(y + height, x + width) - sqsum.at<double>(y, x + width) - sqsum.at<double>(y + height, x) + sqsum.at<double>(y, x);
+                    double variance = windowSqsum - (windowSum * windowSum) / area;
+                    if (variance <= 1e-6)
+                    {
+                        continue;
+                    }
+
+                    double ncc = correlation.at<float>(y, x) / (model->coarseNorm * std::sqrt(variance));
+                    if (ncc > best)
+                    {
+                        best = ncc;
+                        bestLocation = cv::Point(x, y);
+                    }
+                }
+            }
+
+            if (best < this->threshold - COARSE_TOLERANCE)
+            {
+                continue;
+            }
+
+            // Fine search: refine the coarse position at full resolution
+            int radius = scale + 1;
+            cv::Rect roi = cv::Rect(bestLocation.x * scale - radius, bestLocation.y * scale - radius,
+                                    model->image.cols + 2 * radius, model->image.rows + 2 * radius) & sceneArea;
+            if ((roi.width < model->image.cols) || (roi.height < model->image.rows))
+            {
+                continue;
+            }
+
+            cv::Mat refinement;
+            double refined;
+            cv::Point refinedLocation;
+            cv::matchTemplate(scene(roi), model->image, refinement, cv::TM_CCOEFF_NORMED);
+            cv::minMaxLoc(refinement, nullptr, &refined, nullptr, &refinedLocation);
+            if (refined >= this->threshold)
+            {
+                scores[i] = refined;
+                locations[i] = roi.tl() + refinedLocation;
+            }
+        }
+    });
+
+    for (size_t i = 0; i < this->templates.size(); i++)
+    {
+        if (scores[i] >= 0.0)
+        {
+            // Templates are only translated
+            const Template* model = this->templates[i].get();
+            cv::Point2f upperLeft(locations[i]);
+            float width = static_cast<float>(model->image.cols);
+            float height = static_cast<float>(model->image.rows);
+            std::vector<cv::Point2f> corners = { upperLeft, upperLeft + cv::Point2f(width, 0.0f), upperLeft + cv::Point2f(width, height), upperLeft + cv::Point2f(0.0f, height) };
+            cv::Matx33d homography(1.0, 0.0, upperLeft.x, 0.0, 1.0, upperLeft.y, 0.0, 0.0, 1.0);
+            results.push_back(new PoseResult(static_cast<int>(scores[i] * 100.0), model->id, corners, homography));
+        }
+    }
+
+    return results;
+}
+
+void TemplateProcessing::account(const Template& model, int sign)
+{
+    MemoryAccount::get(MemoryComponent::MODEL_IMAGES).add(sign * (MemoryAccount::getBytes(model.image) + MemoryAccount::getBytes(model.coarse)));
+    MemoryAccount::get(MemoryComponent::INDEXES).add(sign * MemoryAccount::getBytes(model.spectrum));
+}
+
+void TemplateProcessing::updateSpectra(cv::Size size)
+{
+    for (size_t i = 0; i < this->templates.size(); i++)
+    {
+        int64_t bytes = MemoryAccount::getBytes(this->templates[i]->spectrum);
+        computeSpectrum(this->templates[i]->coarse, size, this->templates[i]->spectrum);
+        MemoryAccount::get(MemoryComponent::INDEXES).add(MemoryAccount::getBytes(this->templates[i]->spectrum) - bytes);
+    }
+    this->spectrumSize = size;
+}
+
+ContentionMutex& TemplateProcessing::getTemplatesMutex()
+{
+    return this->templatesMutex;
+}
@@ -0,0 +1,169 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <companion/processing/ImageProcessing.h>
+
+#include "CompanionWinRT/native/ContentionMutex.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * This class recognizes templates at a fixed scale by normalized cross-correlation.
+         *
+         * The scene is searched coarse to fine: the correlation of all templates is computed on a downscaled scene in the frequency
+         * domain (the template spectra are cached, so each frame needs one forward transform of the scene and one inverse transform
+         * per template) and the best coarse position of each template is refined at full resolution. Templates are processed in
+         * parallel.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class TemplateProcessing : public Companion::Processing::ImageProcessing
+        {
+            public:
+
+                /**
+                 * Create a 'TemplateProcessing' object.
+                 *
+                 * @param threshold     minimum normalized cross-correlation of a recognized template (0 to 1)
+                 * @param pyramidLevels number of times the scene is halved for the coarse search (0 to search at full resolution)
+                 */
+                TemplateProcessing(double threshold, int pyramidLevels);
+
+                /**
+                 * Release all templates.
+                 */
+                virtual ~TemplateProcessing();
+
+                /**
+                 * Add a template.
+                 *
+                 * @param id    the ID of the template
+                 * @param image gray scale template image
+                 * @return <code>true</code> if the template was added successfully, <code>false</code> otherwise
+                 */
+                bool addModel(int id, const cv::Mat& image);
+
+                /**
+                 * Remove the template with the given ID.
+                 *
+                 * @param id    the ID of the template
+                 */
+                void removeModel(int id);
+
+                /**
+                 * Remove all templates.
+                 */
+                void clearModels();
+
+                /**
+                 * Recognize templates in the given frame.
+                 *
+                 * @param frame frame to process
+                 * @return recognition results
+                 */
+                virtual std::vector<Companion::Model::Result::Result*> execute(cv::Mat frame) override;
+
+                /**
+                 * Return the mutex of the templates, which records its wait and hold times.
+                 *
+                 * @return mutex of the templates
+                 */
+                ContentionMutex& getTemplatesMutex();
+
+            private:
+
+                /**
+                 * A template together with its cached coarse spectrum.
+                 */
+                struct Template
+                {
+                    /**
+                     * The ID of this template.
+                     */
+                    int id;
+
+                    /**
+                     * Gray scale template image at full resolution.
+                     */
+                    cv::Mat image;
+
+                    /**
+                     * Zero mean template at the coarse resolution.
+                     */
+                    cv::Mat coarse;
+
+                    /**
+                     * Euclidean norm of the zero mean coarse template.
+                     */
+                    double coarseNorm;
+
+                    /**
+                     * Spectrum of the zero padded coarse template (valid for the cached transform size).
+                     */
+                    cv::Mat spectrum;
+                };
+
+                /**
+                 * Add the memory of a template to the model image and index accounts.
+                 *
+                 * @param model template to account
+                 * @param sign  1 to add the memory of the template, -1 to release it
+                 */
+                static void account(const Template& model, int sign);
+
+                /**
+                 * Compute the spectra of all templates for the given transform size. The caller has to hold the template lock.
+                 *
+                 * @param size  transform size
+                 */
+                void updateSpectra(cv::Size size);
+
+                /**
+                 * Minimum normalized cross-correlation of a recognized template.
+                 */
+                double threshold;
+
+                /**
+                 * Number of times the scene is halved for the coarse search.
+                 */
+                int pyramidLevels;
+
+                /**
+                 * Transform size the template spectra were computed for.
+                 */
+                cv::Size spectrumSize;
+
+                /**
+                 * List of all templates.
+                 */
+                std::vector<std::unique_ptr<Template>> templates;
+
+                /**
+                 * Mutex to guard the templates.
+                 */
+                ContentionMutex templatesMutex;
+        };
+    }
+}
@@ -0,0 +1,166 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "WorkCounter.h"
+#include "CompanionWinRT/native/PoseResult.h"
+
+using namespace CompanionWinRT::Native;
+
+/**
+ * Work aggregated over all frames of all processings.
+ */
+static WorkStatistics statistics = {};
+
+/**
+ * Mutex of the aggregated work.
+ */
+static std::mutex statisticsMutex;
+
+/**
+ * Add the totals of a frame to other totals.
+ *
+ * @param totals    totals to add to
+ * @param work      work of a frame
+ */
+static void addWork(FrameWork& totals, const FrameWork& work)
+{
+    totals.sceneKeypoints += work.sceneKeypoints;
+    totals.descriptorsMatched += work.descriptorsMatched;
+    totals.rawMatches += work.rawMatches;
+    totals.filteredMatches += work.filteredMatches;
+    totals.ransacIterations += work.ransacIterations;
+    totals.inliers += work.inliers;
+    totals.contoursFound += work.contoursFound;
+    totals.contoursFiltered += work.contoursFiltered;
+    totals.hashCandidates += work.hashCandidates;
+    totals.verifiedModels += work.verifiedModels;
+}
+
+WorkResult::WorkResult(std::shared_ptr<const FrameWork> work) : Companion::Model::Result::RecognitionResult(0, -1, nullptr), work(work)
+{
+}
+
+std::shared_ptr<const FrameWork> WorkResult::getWork() const
+{
+    return this->work;
+}
+
+WorkCounter::WorkCounter() : current(std::make_shared<FrameWork>())
+{
+}
+
+void WorkCounter::begin()
+{
+    std::lock_guard<std::mutex> lock(this->currentMutex);
+    this->current = std::make_shared<FrameWork>();
+}
+
+void WorkCounter::addSceneKeypoints(size_t count)
+{
+    std::lock_guard<std::mutex> lock(this->currentMutex);
+    this->current->sceneKeypoints += count;
+}
+
+void WorkCounter::addModel(int id, const Verification& verification)
+{
+    ModelWork model = { id, verification.descriptorsMatched, verification.rawMatches, verification.filteredMatches, verification.ransacIterations,
+                        verification.inliers };
+
+    std::lock_guard<std::mutex> lock(this->currentMutex);
+    FrameWork& work = *this->current;
+    work.descriptorsMatched += model.descriptorsMatched;
+    work.rawMatches += model.rawMatches;
+    work.filteredMatches += model.filteredMatches;
+    work.ransacIterations += model.ransacIterations;
+    work.inliers += model.inliers;
+    work.verifiedModels++;
+    work.models.push_back(model);
+}
+
+void WorkCounter::addTotals(const FrameWork& work)
+{
+    std::lock_guard<std::mutex> lock(this->currentMutex);
+    addWork(*this->current, work);
+}
+
+void WorkCounter::addContours(size_t found, size_t filtered)
+{
+    std::lock_guard<std::mutex> lock(this->currentMutex);
+    this->current->contoursFound += found;
+    this->current->contoursFiltered += filtered;
+}
+
+void WorkCounter::addHashCandidates(size_t count)
+{
+    std::lock_guard<std::mutex> lock(this->currentMutex);
+    this->current->hashCandidates += count;
+}
+
+void WorkCounter::finish(std::vector<Companion::Model::Result::Result*>& results)
+{
+    std::shared_ptr<FrameWork> work;
+    {
+        std::lock_guard<std::mutex> lock(this->currentMutex);
+        work.swap(this->current);
+        this->current = std::make_shared<FrameWork>();
+    }
+
+    // All results of the frame share its work
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        PoseResult* pose = dynamic_cast<PoseResult*>(results[i]);
+        if (pose != nullptr)
+        {
+            pose->setWork(work);
+        }
+    }
+
+    results.push_back(new WorkResult(work));
+
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+    statistics.frames++;
+    addWork(statistics.totals, *work);
+}
+
+std::shared_ptr<const FrameWork> WorkCounter::take(std::vector<Companion::Model::Result::Result*>& results)
+{
+    std::shared_ptr<const FrameWork> work;
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        WorkResult* carrier = dynamic_cast<WorkResult*>(results[i]);
+        if (carrier != nullptr)
+        {
+            work = carrier->getWork();
+            results.erase(results.begin() + i);
+            break;
+        }
+    }
+    return work;
+}
+
+WorkStatistics WorkCounter::getStatistics()
+{
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+    return statistics;
+}
+
+void WorkCounter::resetStatistics()
+{
+    std::lock_guard<std::mutex> lock(statisticsMutex);
+    statistics = WorkStatistics();
+}
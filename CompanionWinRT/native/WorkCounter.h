@@ -0,0 +1,283 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+/// @file
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <companion/model/result/RecognitionResult.h>
+#include <companion/model/result/Result.h>
+
+#include "CompanionWinRT/native/FeatureVerification.h"
+
+namespace CompanionWinRT
+{
+    namespace Native
+    {
+        /**
+         * Work of a single model verification.
+         */
+        struct ModelWork
+        {
+            /**
+             * The ID of the verified model.
+             */
+            int id;
+
+            /**
+             * Number of model descriptors matched against the scene.
+             */
+            int descriptorsMatched;
+
+            /**
+             * Number of distinctive matches.
+             */
+            int rawMatches;
+
+            /**
+             * Number of matches passed to the robust estimation.
+             */
+            int filteredMatches;
+
+            /**
+             * Estimated number of robust estimation iterations.
+             */
+            int ransacIterations;
+
+            /**
+             * Number of inliers of the estimated homography.
+             */
+            int inliers;
+        };
+
+        /**
+         * Algorithm-level work of a single frame.
+         */
+        struct FrameWork
+        {
+            /**
+             * Number of extracted scene keypoints.
+             */
+            int64_t sceneKeypoints;
+
+            /**
+             * Number of model descriptors matched against the scene (all models).
+             */
+            int64_t descriptorsMatched;
+
+            /**
+             * Number of distinctive matches (all models).
+             */
+            int64_t rawMatches;
+
+            /**
+             * Number of matches passed to the robust estimation (all models).
+             */
+            int64_t filteredMatches;
+
+            /**
+             * Estimated number of robust estimation iterations (all models).
+             */
+            int64_t ransacIterations;
+
+            /**
+             * Number of inliers (all models).
+             */
+            int64_t inliers;
+
+            /**
+             * Number of contours (shapes) found by the shape detection.
+             */
+            int64_t contoursFound;
+
+            /**
+             * Number of contours left after filtering by the region mask.
+             */
+            int64_t contoursFiltered;
+
+            /**
+             * Number of hash candidates evaluated.
+             */
+            int64_t hashCandidates;
+
+            /**
+             * Number of verified models.
+             */
+            int64_t verifiedModels;
+
+            /**
+             * Work of every model verified in this process (models verified by shard processes are only part of the totals).
+             */
+            std::vector<ModelWork> models;
+        };
+
+        /**
+         * Work aggregated over all processed frames.
+         */
+        struct WorkStatistics
+        {
+            /**
+             * Number of processed frames.
+             */
+            uint64_t frames;
+
+            /**
+             * Sum of the work of all frames (without per model work).
+             */
+            FrameWork totals;
+        };
+
+        /**
+         * This class carries the work of a frame along with the results of the frame through the result queue of the native
+         * configuration, so the work reaches the result handler also for frames without any result. 'ProcessingSession' takes it
+         * out of the results before they are handed on, the carrier itself is owned like all other results of the frame.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class WorkResult : public Companion::Model::Result::RecognitionResult
+        {
+            public:
+
+                /**
+                 * Create a 'WorkResult' object.
+                 *
+                 * @param work  work of the frame
+                 */
+                WorkResult(std::shared_ptr<const FrameWork> work);
+
+                /**
+                 * Return the work of the frame.
+                 *
+                 * @return work of the frame
+                 */
+                std::shared_ptr<const FrameWork> getWork() const;
+
+            private:
+
+                /**
+                 * Work of the frame.
+                 */
+                std::shared_ptr<const FrameWork> work;
+        };
+
+        /**
+         * This class counts the algorithm-level work of the frames of a processing.
+         *
+         * A processing starts every frame with 'begin', counts its work (also from parallel verifications) and finishes the frame
+         * with its results. The counters of the frame are then attached to all pose results of the frame, appended to the results
+         * as a 'WorkResult' (once per frame, whatever the number of results) and added to the statistics of the process.
+         *
+         * @author Dimitri Kotlovsky, Andreas Sekulski
+         */
+        class WorkCounter
+        {
+            public:
+
+                /**
+                 * Create a 'WorkCounter' object.
+                 */
+                WorkCounter();
+
+                /**
+                 * Start counting the work of a new frame.
+                 */
+                void begin();
+
+                /**
+                 * Count extracted scene keypoints.
+                 *
+                 * @param count number of keypoints
+                 */
+                void addSceneKeypoints(size_t count);
+
+                /**
+                 * Count the work of a model verification.
+                 *
+                 * @param id            the ID of the model
+                 * @param verification  verification outcome with its work counters
+                 */
+                void addModel(int id, const Verification& verification);
+
+                /**
+                 * Count the verification work done elsewhere, for example in a shard process.
+                 *
+                 * @param work  work totals (per model work is ignored)
+                 */
+                void addTotals(const FrameWork& work);
+
+                /**
+                 * Count found and filtered contours.
+                 *
+                 * @param found     number of contours found by the shape detection
+                 * @param filtered  number of contours left after filtering
+                 */
+                void addContours(size_t found, size_t filtered);
+
+                /**
+                 * Count evaluated hash candidates.
+                 *
+                 * @param count number of hash candidates
+                 */
+                void addHashCandidates(size_t count);
+
+                /**
+                 * Finish the frame: attach its work to all pose results, append it to the results as a 'WorkResult' and add it to the
+                 * statistics of the process.
+                 *
+                 * @param results   results of the frame
+                 */
+                void finish(std::vector<Companion::Model::Result::Result*>& results);
+
+                /**
+                 * Take the work of a frame out of its results. The 'WorkResult' is removed from the given results but not deleted,
+                 * the caller keeps a copy of the results that owns it.
+                 *
+                 * @param results   results of a frame
+                 * @return work of the frame (nullptr if the processing doesn't count its work)
+                 */
+                static std::shared_ptr<const FrameWork> take(std::vector<Companion::Model::Result::Result*>& results);
+
+                /**
+                 * Return the work aggregated over all frames of all processings since the start or the last reset.
+                 *
+                 * @return aggregated work
+                 */
+                static WorkStatistics getStatistics();
+
+                /**
+                 * Reset the aggregated work.
+                 */
+                static void resetStatistics();
+
+            private:
+
+                /**
+                 * Work of the current frame.
+                 */
+                std::shared_ptr<FrameWork> current;
+
+                /**
+                 * Mutex of the work of the current frame.
+                 */
+                std::mutex currentMutex;
+        };
+    }
+}
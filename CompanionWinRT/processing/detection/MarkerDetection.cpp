@@ -0,0 +1,62 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MarkerDetection.h"
+#include "CompanionWinRT/utils/CompanionError.h"
+
+using namespace CompanionWinRT;
+
+MarkerDetection::MarkerDetection(ShapeDetection^ detectionAlgo, int markerBits)
+{
+    if (detectionAlgo != nullptr)
+    {
+        this->detectionAlgo = detectionAlgo;
+        this->markerDetectionObj = new Native::MarkerProcessing(this->detectionAlgo->getShapeDetection(), markerBits);
+    }
+    else
+    {
+        int hresult = static_cast<int>(ErrorCode::handle_is_null);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+MarkerDetection::~MarkerDetection()
+{
+    delete this->markerDetectionObj;
+    this->markerDetectionObj = nullptr;
+}
+
+void MarkerDetection::addMarker(uint64 markerID, int modelID)
+{
+    this->markerDetectionObj->addMarker(markerID, modelID);
+}
+
+void MarkerDetection::removeMarker(uint64 markerID)
+{
+    this->markerDetectionObj->removeMarker(markerID);
+}
+
+void MarkerDetection::clearMarkers()
+{
+    this->markerDetectionObj->clearMarkers();
+}
+
+Native::MarkerProcessing* MarkerDetection::getMarkerDetection()
+{
+    return this->markerDetectionObj;
+}
@@ -0,0 +1,113 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <collection.h>
+
+#include "CompanionWinRT/algo/detection/ShapeDetection.h"
+#include "CompanionWinRT/native/MarkerProcessing.h"
+#include "CompanionWinRT/utils/CompanionUtils.h"
+
+using namespace Platform::Collections;
+using namespace Windows::Foundation::Collections;
+
+namespace CompanionWinRT
+{
+    /**
+     * This class provides a WinRT wrapper for a square fiducial marker recognition. It reuses the quad candidates of a shape
+     * detection and decodes their bit grid, which is far cheaper and more robust than feature matching. Markers are mapped to
+     * model IDs, so recognized markers are reported as regular recognition results.
+     *
+     * A marker consists of a black border of one cell and an inner grid of markerBits x markerBits cells. Black cells are ones,
+     * white cells are zeros and the marker ID is the inner grid read row by row (upper left cell as the most significant bit)
+     * in the upright orientation of the marker.
+     *
+     * Note:
+     * Native code in interfaces and public inheritance are not possible in a Windows Runtime context (with very few exceptions).
+     * We can not mirror the plausible interface / abstract class 'ImageProcessing' for this wrapper.
+     *
+     * @author Dimitri Kotlovsky, Andreas Sekulski
+     */
+    public ref class MarkerDetection sealed
+    {
+    public:
+
+        /**
+         * Create a 'MarkerDetection' wrapper for markers with 4 x 4 inner cells.
+         *
+         * @param detectionAlgo detection algorithm that provides the quad candidates
+         */
+        MarkerDetection(ShapeDetection^ detectionAlgo) : MarkerDetection(detectionAlgo, 4)
+        {};
+
+        /**
+         * Create a 'MarkerDetection' wrapper.
+         *
+         * @param detectionAlgo detection algorithm that provides the quad candidates
+         * @param markerBits    number of inner cells per marker side (3 to 8)
+         */
+        MarkerDetection(ShapeDetection^ detectionAlgo, int markerBits);
+
+        /**
+         * Map a marker to a model. Results of this marker are reported with the given model ID.
+         *
+         * @param markerID  ID of the marker (inner bit grid in the upright orientation)
+         * @param modelID   ID of the model
+         */
+        void addMarker(uint64 markerID, int modelID);
+
+        /**
+         * Remove the mapping of the given marker.
+         *
+         * @param markerID  ID of the marker
+         */
+        void removeMarker(uint64 markerID);
+
+        /**
+         * Remove all marker mappings.
+         */
+        void clearMarkers();
+
+        /**
+         * Destruct this instance.
+         */
+        virtual ~MarkerDetection();
+
+    private:
+
+        /**
+         * The native 'MarkerProcessing' object of this instance.
+         */
+        Native::MarkerProcessing* markerDetectionObj;
+
+        /**
+         * A handle to the detection algorithm that provides the quad candidates.
+         */
+        ShapeDetection^ detectionAlgo;
+
+    internal:
+
+        /**
+         * Internal method to provide the native 'MarkerProcessing' object.
+         *
+         * @return pointer to the native 'MarkerProcessing' object
+         */
+        Native::MarkerProcessing* getMarkerDetection();
+    };
+}
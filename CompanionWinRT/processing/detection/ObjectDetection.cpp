@@ -17,7 +17,7 @@
  */
 
 #include "ObjectDetection.h"
-#include "CompanionWinRT\utils\CompanionError.h"
+#include "CompanionWinRT/utils/CompanionError.h"
 
 using namespace CompanionWinRT;
 
@@ -26,7 +26,7 @@ ObjectDetection::ObjectDetection(ShapeDetection^ detectionAlgo)
     if (detectionAlgo != nullptr)
     {
         this->detectionAlgo = detectionAlgo;
-        this->objectDetectionObj = new Companion::Processing::Detection::ObjectDetection(this->detectionAlgo->getShapeDetection());
+        this->objectDetectionObj = new Native::DetectionProcessing(this->detectionAlgo->getShapeDetection());
     }
     else
     {
@@ -41,7 +41,7 @@ ObjectDetection::~ObjectDetection()
     this->objectDetectionObj = nullptr;
 }
 
-Companion::Processing::Detection::ObjectDetection* ObjectDetection::getObjectDetection()
+Native::DetectionProcessing* ObjectDetection::getObjectDetection()
 {
     return this->objectDetectionObj;
 }
@@ -19,10 +19,11 @@
 #pragma once
 
 #include <collection.h>
-#include <companion\processing\detection\ObjectDetection.h>
+#include <companion/processing/detection/ObjectDetection.h>
 
-#include "CompanionWinRT\algo\detection\ShapeDetection.h"
-#include "CompanionWinRT\utils\CompanionUtils.h"
+#include "CompanionWinRT/algo/detection/ShapeDetection.h"
+#include "CompanionWinRT/native/DetectionProcessing.h"
+#include "CompanionWinRT/utils/CompanionUtils.h"
 
 using namespace Platform::Collections;
 using namespace Windows::Foundation::Collections;
@@ -67,9 +68,9 @@ namespace CompanionWinRT
     private:
 
         /**
-         * The native 'ObjectDetection' object of this instance.
+         * The native processing of this instance, which runs the 'ObjectDetection' on the processed region of the camera view.
          */
-        Companion::Processing::Detection::ObjectDetection* objectDetectionObj;
+        Native::DetectionProcessing* objectDetectionObj;
 
         /**
          * A handle to the desired detection algorithm.
@@ -86,10 +87,10 @@ namespace CompanionWinRT
     internal:
 
         /**
-         * Internal method to provide the native 'ObjectDetection' object.
+         * Internal method to provide the native processing object.
          *
-         * @return pointer to the native 'ObjectDetection' object
+         * @return pointer to the native processing object
          */
-        Companion::Processing::Detection::ObjectDetection* getObjectDetection();
+        Native::DetectionProcessing* getObjectDetection();
     };
 }
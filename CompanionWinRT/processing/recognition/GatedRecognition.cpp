@@ -0,0 +1,115 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "GatedRecognition.h"
+#include "CompanionWinRT/utils/CompanionError.h"
+
+using namespace CompanionWinRT;
+
+GatedRecognition::GatedRecognition(ShapeDetection^ shapeDetection, FeatureMatching^ matchingAlgo, int margin)
+{
+    if ((shapeDetection != nullptr) && (matchingAlgo != nullptr))
+    {
+        this->shapeDetection = shapeDetection;
+        this->matchingAlgo = matchingAlgo;
+        this->gatedRecognitionObj = new Native::GatedProcessing(this->shapeDetection->getShapeDetection(), this->matchingAlgo->getFeatureVerification(), margin);
+    }
+    else
+    {
+        int hresult = static_cast<int>(ErrorCode::handle_is_null);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+GatedRecognition::~GatedRecognition()
+{
+    delete this->gatedRecognitionObj;
+    this->gatedRecognitionObj = nullptr;
+}
+
+void GatedRecognition::addModel(FeatureMatchingModel^ model)
+{
+    this->addModel(model, "");
+}
+
+void GatedRecognition::addModel(FeatureMatchingModel^ model, Platform::String^ tag)
+{
+    this->models->Append(model);
+    if (!this->gatedRecognitionObj->addModel(model->getFeatureMatchingModel()->getID(), model->getImage(), Utils::ps2ss(tag)))
+    {
+        int hresult = static_cast<int>(ErrorCode::model_not_added);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+IVector<FeatureMatchingModel^>^ GatedRecognition::getModels()
+{
+    return this->models;
+}
+
+void GatedRecognition::removeModel(int modelID)
+{
+    for (int i = 0; i < this->models->Size; i++)
+    {
+        if (this->models->GetAt(i)->getFeatureMatchingModel()->getID() == modelID)
+        {
+            this->gatedRecognitionObj->removeModel(modelID);
+            this->models->RemoveAt(i);
+        }
+    }
+}
+
+void GatedRecognition::clearModels()
+{
+    this->gatedRecognitionObj->clearModels();
+    this->models->Clear();
+}
+
+void GatedRecognition::setActiveTags(IVector<Platform::String^>^ tags)
+{
+    this->gatedRecognitionObj->setActiveTags(Utils::getTags(tags));
+}
+
+void GatedRecognition::selectDescriptorBits(int bits, bool reRank)
+{
+    if (!this->gatedRecognitionObj->selectDescriptorBits(bits, reRank))
+    {
+        int hresult = static_cast<int>(ErrorCode::settings_locked);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+void GatedRecognition::setMaxObjects(int maxObjects)
+{
+    this->gatedRecognitionObj->setMaxObjects(maxObjects);
+}
+
+int GatedRecognition::getMaxObjects()
+{
+    return this->gatedRecognitionObj->getMaxObjects();
+}
+
+void GatedRecognition::setDeterministic(bool deterministic)
+{
+    this->gatedRecognitionObj->setDeterministic(deterministic);
+}
+
+Native::GatedProcessing* GatedRecognition::getGatedRecognition()
+{
+    return this->gatedRecognitionObj;
+}
@@ -0,0 +1,180 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <collection.h>
+
+#include "CompanionWinRT/algo/detection/ShapeDetection.h"
+#include "CompanionWinRT/algo/recognition/matching/FeatureMatching.h"
+#include "CompanionWinRT/model/processing/FeatureMatchingModel.h"
+#include "CompanionWinRT/native/GatedProcessing.h"
+#include "CompanionWinRT/utils/CompanionUtils.h"
+
+using namespace Platform::Collections;
+using namespace Windows::Foundation::Collections;
+
+namespace CompanionWinRT
+{
+    /**
+     * This class provides a WinRT wrapper for a detection gated feature matching. Shapes are detected first and features are only
+     * extracted and matched inside the detected shapes. Frames without any detected shape are not matched at all.
+     *
+     * In contrast to the 'HybridRecognition' no hashing is involved, so every active model is verified against the detected shapes.
+     *
+     * Note:
+     * Native code in interfaces and public inheritance are not possible in a Windows Runtime context (with very few exceptions).
+     * We can not mirror the plausible interface / abstract class 'ImageProcessing' for this wrapper.
+     *
+     * @author Dimitri Kotlovsky, Andreas Sekulski
+     */
+    public ref class GatedRecognition sealed
+    {
+        public:
+
+            /**
+             * Create a 'GatedRecognition' wrapper with a margin of 10 pixels around the detected shapes.
+             *
+             * @param shapeDetection    shape detection that provides the candidate shapes
+             * @param matchingAlgo      matching algorithm to use, for example feature matching
+             */
+            GatedRecognition(ShapeDetection^ shapeDetection, FeatureMatching^ matchingAlgo) : GatedRecognition(shapeDetection, matchingAlgo, 10)
+            {};
+
+            /**
+             * Create a 'GatedRecognition' wrapper.
+             *
+             * @param shapeDetection    shape detection that provides the candidate shapes
+             * @param matchingAlgo      matching algorithm to use, for example feature matching
+             * @param margin            margin around the detected shapes (in pixels), so keypoints at the shape borders are found as well
+             */
+            GatedRecognition(ShapeDetection^ shapeDetection, FeatureMatching^ matchingAlgo, int margin);
+
+            /**
+             * Add a feature matching model to this gated recognition.
+             *
+             * @param model a feature matching model for this gated recognition
+             */
+            void addModel(FeatureMatchingModel^ model);
+
+            /**
+             * Add a feature matching model with a tag (group) to this gated recognition.
+             *
+             * @param model a feature matching model for this gated recognition
+             * @param tag   tag of the model, see 'setActiveTags'
+             */
+            void addModel(FeatureMatchingModel^ model, Platform::String^ tag);
+
+            /**
+             * Select the active model tags. Only models with an active tag are matched. Models don't have to be added again when the
+             * selection changes.
+             *
+             * @param tags  active tags (nullptr or an empty vector activates all models)
+             */
+            void setActiveTags(IVector<Platform::String^>^ tags);
+
+            /**
+             * Return a vector of all feature mathing models.
+             *
+             * @return all feature mathing models
+             */
+            IVector<FeatureMatchingModel^>^ getModels();
+
+            /**
+             * Remove the given model from gated recognition. This function can only be used safetly while Companion is not processing.
+             *
+             * @param modelID   ID of the model
+             */
+            void removeModel(int modelID);
+
+            /**
+             * Clear all image processing models.
+             */
+            void clearModels();
+
+            /**
+             * Set the maximum number of objects per frame. Models are verified in the order of their likelihood (recently
+             * recognized models first) and verification stops once this many objects were recognized.
+             *
+             * @param maxObjects    maximum number of objects per frame (0 for no limit)
+             */
+            void setMaxObjects(int maxObjects);
+
+            /**
+             * Return the maximum number of objects per frame.
+             *
+             * @return maximum number of objects per frame (0 for no limit)
+             */
+            int getMaxObjects();
+
+            /**
+             * Enable or disable the deterministic mode. In deterministic mode models are verified in registration order and parallel
+             * verifications are merged in a fixed order. The same frames then yield identical results at any thread count
+             * (set with OpenCV's 'cv::setNumThreads').
+             *
+             * @param deterministic <code>true</code> to enable the deterministic mode, <code>false</code> to disable it
+             */
+            void setDeterministic(bool deterministic);
+
+            /**
+             * Select the most informative and least correlated descriptor bits over all models added so far and search matches with
+             * compact descriptors made of these bits, see 'MatchRecognition::selectDescriptorBits' ('settings_locked' once only the
+             * compact descriptors are kept).
+             *
+             * @param bits      number of bits to select (0 to match with the full descriptors again)
+             * @param reRank    <code>true</code> to re-rank the compact candidate matches with the full descriptors
+             */
+            void selectDescriptorBits(int bits, bool reRank);
+
+            /**
+             * Destruct this instance.
+             */
+            virtual ~GatedRecognition();
+
+        private:
+
+            /**
+             * The native 'GatedProcessing' object of this instance.
+             */
+            Native::GatedProcessing* gatedRecognitionObj;
+
+            /**
+             * A handle to the shape detection.
+             */
+            ShapeDetection^ shapeDetection;
+
+            /**
+             * A handle to the desired matching algorithm.
+             */
+            FeatureMatching^ matchingAlgo;
+
+            /**
+             * A collection of all feature matching models.
+             */
+            Vector<FeatureMatchingModel^>^ models = ref new Vector<FeatureMatchingModel^>();
+
+        internal:
+
+            /**
+             * Internal method to provide the native 'GatedProcessing' object.
+             *
+             * @return pointer to the native 'GatedProcessing' object
+             */
+            Native::GatedProcessing* getGatedRecognition();
+    };
+}
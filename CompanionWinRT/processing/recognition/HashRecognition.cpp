@@ -17,7 +17,7 @@
  */
 
 #include "HashRecognition.h"
-#include "CompanionWinRT\utils\CompanionError.h"
+#include "CompanionWinRT/utils/CompanionError.h"
 
 using namespace CompanionWinRT;
 
@@ -28,6 +28,7 @@ HashRecognition::HashRecognition(ShapeDetection^ shapeDetection, LSH^ hashingAlg
         this->shapeDetection = shapeDetection;
         this->hashingAlgo = hashingAlgo;
         this->hashRecognitionObj = new Companion::Processing::Recognition::HashRecognition(cv::Size(modelSize.width, modelSize.height), this->shapeDetection->getShapeDetection(), this->hashingAlgo->getLSH());
+        this->hashProcessingObj = new Native::HashProcessing(this->hashRecognitionObj);
     }
     else
     {
@@ -39,17 +40,24 @@ HashRecognition::HashRecognition(ShapeDetection^ shapeDetection, LSH^ hashingAlg
 HashRecognition::~HashRecognition()
 {
     this->models.clear();
+    delete this->hashProcessingObj;
+    this->hashProcessingObj = nullptr;
     delete this->hashRecognitionObj;
     this->hashRecognitionObj = nullptr;
 }
 
 void HashRecognition::addModel(Platform::String^ imagePath, int id)
+{
+    this->addModel(imagePath, id, "");
+}
+
+void HashRecognition::addModel(Platform::String^ imagePath, int id, Platform::String^ tag)
 {
     if (imagePath != nullptr)
     {
         cv::Mat model = cv::imread(Utils::ps2ss(imagePath), cv::IMREAD_GRAYSCALE);
         this->models.push_back(model);
-        this->hashRecognitionObj->addModel(id, model);
+        this->hashProcessingObj->addModel(id, model, Utils::ps2ss(tag));
     }
     else
     {
@@ -62,3 +70,13 @@ Companion::Processing::Recognition::HashRecognition* HashRecognition::getHashRec
 {
     return this->hashRecognitionObj;
 }
+
+void HashRecognition::setActiveTags(IVector<Platform::String^>^ tags)
+{
+    this->hashProcessingObj->setActiveTags(Utils::getTags(tags));
+}
+
+Native::HashProcessing* HashRecognition::getHashProcessing()
+{
+    return this->hashProcessingObj;
+}
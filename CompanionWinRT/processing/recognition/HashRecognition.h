@@ -19,11 +19,12 @@
 #pragma once
 
 #include <collection.h>
-#include <companion\processing\recognition\HashRecognition.h>
+#include <companion/processing/recognition/HashRecognition.h>
 
-#include "CompanionWinRT\algo\detection\ShapeDetection.h"
-#include "CompanionWinRT\algo\recognition\hashing\LSH.h"
-#include "CompanionWinRT\utils\CompanionUtils.h"
+#include "CompanionWinRT/algo/detection/ShapeDetection.h"
+#include "CompanionWinRT/algo/recognition/hashing/LSH.h"
+#include "CompanionWinRT/native/HashProcessing.h"
+#include "CompanionWinRT/utils/CompanionUtils.h"
 
 using namespace Platform::Collections;
 using namespace Windows::Foundation::Collections;
@@ -86,6 +87,23 @@ namespace CompanionWinRT
          */
         void addModel(Platform::String^ imagePath, int id);
 
+        /**
+         * Add an image hash model with a tag (group) to this hash recognition.
+         *
+         * @param imagePath path of the image that is going to be the image hash model
+         * @param id        the ID of the image hash model
+         * @param tag       tag of the image hash model, see 'setActiveTags'
+         */
+        void addModel(Platform::String^ imagePath, int id, Platform::String^ tag);
+
+        /**
+         * Select the active model tags. Only results of models with an active tag are reported. Models don't have to be added
+         * again when the selection changes.
+         *
+         * @param tags  active tags (nullptr or an empty vector activates all models)
+         */
+        void setActiveTags(IVector<Platform::String^>^ tags);
+
         /**
          * Destruct this instance.
          */
@@ -98,6 +116,11 @@ namespace CompanionWinRT
          */
         Companion::Processing::Recognition::HashRecognition* hashRecognitionObj;
 
+        /**
+         * The native 'HashProcessing' object of this instance that filters the results by the active tags.
+         */
+        Native::HashProcessing* hashProcessingObj;
+
         /**
          * A handle to the shape detection algorithm.
          */
@@ -128,5 +151,12 @@ namespace CompanionWinRT
          * @return pointer to the native 'HashRecognition' object
          */
         Companion::Processing::Recognition::HashRecognition* getHashRecognition();
+
+        /**
+         * Internal method to provide the native 'HashProcessing' object.
+         *
+         * @return pointer to the native 'HashProcessing' object
+         */
+        Native::HashProcessing* getHashProcessing();
     };
 }
@@ -17,17 +17,25 @@
  */
 
 #include "HybridRecognition.h"
-#include "CompanionWinRT\utils\CompanionError.h"
+#include "CompanionWinRT/utils/CompanionError.h"
 
 using namespace CompanionWinRT;
 
-HybridRecognition::HybridRecognition(HashRecognition^ hashRecognition, FeatureMatching^ matchingAlgo, int resize)
+HybridRecognition::HybridRecognition(HashRecognition^ hashRecognition, FeatureMatching^ matchingAlgo, int resize, bool nativeProcessing)
+    : hybridRecognitionObj(nullptr), companionRecognitionObj(nullptr)
 {
     if ((hashRecognition != nullptr) && (matchingAlgo != nullptr))
     {
         this->hashRecognition = hashRecognition;
         this->matchingAlgo = matchingAlgo;
-        this->hybridRecognitionObj = new Companion::Processing::Recognition::HybridRecognition(this->hashRecognition->getHashRecognition(), this->matchingAlgo->getFeatureMatching(), resize);
+        if (nativeProcessing)
+        {
+            this->hybridRecognitionObj = new Native::HybridProcessing(this->hashRecognition->getHashRecognition(), this->matchingAlgo->getFeatureVerification(), resize);
+        }
+        else
+        {
+            this->companionRecognitionObj = new Companion::Processing::Recognition::HybridRecognition(this->hashRecognition->getHashRecognition(), this->matchingAlgo->getFeatureMatching(), resize);
+        }
     }
     else
     {
@@ -41,15 +49,35 @@ HybridRecognition::~HybridRecognition()
     this->models.clear();
     delete this->hybridRecognitionObj;
     this->hybridRecognitionObj = nullptr;
+    delete this->companionRecognitionObj;
+    this->companionRecognitionObj = nullptr;
 }
 
 void HybridRecognition::addModel(Platform::String^ imagePath, int id)
 {
+    this->addModel(imagePath, id, "");
+}
+
+void HybridRecognition::addModel(Platform::String^ imagePath, int id, Platform::String^ tag)
+{
+    std::string modelTag = Utils::ps2ss(tag);
+    if (!modelTag.empty())
+    {
+        this->requireNativeProcessing();
+    }
+
     if (imagePath != nullptr)
     {
         cv::Mat model = cv::imread(Utils::ps2ss(imagePath), cv::IMREAD_GRAYSCALE);
         this->models.push_back(model);
-        this->hybridRecognitionObj->addModel(model, id);
+        if (this->hybridRecognitionObj != nullptr)
+        {
+            this->hybridRecognitionObj->addModel(id, model, modelTag);
+        }
+        else
+        {
+            this->companionRecognitionObj->addModel(model, id);
+        }
     }
     else
     {
@@ -58,7 +86,58 @@ void HybridRecognition::addModel(Platform::String^ imagePath, int id)
     }
 }
 
-Companion::Processing::Recognition::HybridRecognition* HybridRecognition::getHybridRecognition()
+void HybridRecognition::setActiveTags(IVector<Platform::String^>^ tags)
+{
+    this->requireNativeProcessing();
+    this->hybridRecognitionObj->setActiveTags(Utils::getTags(tags));
+}
+
+void HybridRecognition::selectDescriptorBits(int bits, bool reRank)
+{
+    this->requireNativeProcessing();
+    if (!this->hybridRecognitionObj->selectDescriptorBits(bits, reRank))
+    {
+        int hresult = static_cast<int>(ErrorCode::settings_locked);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+void HybridRecognition::setMaxObjects(int maxObjects)
+{
+    this->requireNativeProcessing();
+    this->hybridRecognitionObj->setMaxObjects(maxObjects);
+}
+
+int HybridRecognition::getMaxObjects()
+{
+    return (this->hybridRecognitionObj != nullptr) ? this->hybridRecognitionObj->getMaxObjects() : 0;
+}
+
+void HybridRecognition::setDeterministic(bool deterministic)
+{
+    this->requireNativeProcessing();
+    this->hybridRecognitionObj->setDeterministic(deterministic);
+}
+
+void HybridRecognition::requireNativeProcessing()
+{
+    if (this->hybridRecognitionObj == nullptr)
+    {
+        int hresult = static_cast<int>(ErrorCode::native_processing_required);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+Companion::Processing::ImageProcessing* HybridRecognition::getHybridRecognition()
+{
+    if (this->hybridRecognitionObj != nullptr)
+    {
+        return this->hybridRecognitionObj;
+    }
+    return this->companionRecognitionObj;
+}
+
+Native::HybridProcessing* HybridRecognition::getHybridProcessing()
 {
     return this->hybridRecognitionObj;
 }
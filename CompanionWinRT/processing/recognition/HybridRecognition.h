@@ -19,11 +19,12 @@
 #pragma once
 
 #include <collection.h>
-#include <companion\processing\recognition\HybridRecognition.h>
+#include <companion/processing/recognition/HybridRecognition.h>
 
-#include "CompanionWinRT\algo\recognition\matching\FeatureMatching.h"
-#include "CompanionWinRT\processing\recognition\HashRecognition.h"
-#include "CompanionWinRT\utils\CompanionUtils.h"
+#include "CompanionWinRT/algo/recognition/matching/FeatureMatching.h"
+#include "CompanionWinRT/native/HybridProcessing.h"
+#include "CompanionWinRT/processing/recognition/HashRecognition.h"
+#include "CompanionWinRT/utils/CompanionUtils.h"
 
 using namespace Platform::Collections;
 using namespace Windows::Foundation::Collections;
@@ -33,6 +34,11 @@ namespace CompanionWinRT
     /**
      * This class provides a WinRT wrapper for the 'HybridRecognition' functionality of the Companion framework.
      *
+     * By default the recognition runs Companion's 'HybridRecognition'. With the native processing of the wrapper, hash candidates
+     * are verified by the wrapper's feature verification and the IRA setting of the matching algorithm is ignored. Tags, object
+     * limits, compact descriptors, the deterministic mode and region masks require the native processing
+     * ('native_processing_required' otherwise).
+     *
      * Note 1:
      * This is a minimum construction -- it has to be extended to provide the same flexability as the Companion native code.
      *
@@ -76,7 +82,19 @@ namespace CompanionWinRT
          * @param matchingAlgo      matching algorithm to use, for example feature matching
          * @param resize            resize image factor from 1 to 100 (in percent). 100 is equal to 100% of the original scale
          */
-        HybridRecognition(HashRecognition^ hashRecognition, FeatureMatching^ matchingAlgo, int resize);
+        HybridRecognition(HashRecognition^ hashRecognition, FeatureMatching^ matchingAlgo, int resize) : HybridRecognition(hashRecognition, matchingAlgo, resize, false)
+        {};
+
+        /**
+         * Create a 'HybridRecognition' wrapper.
+         *
+         * @param hashRecognition   hash recognition handle
+         * @param matchingAlgo      matching algorithm to use, for example feature matching
+         * @param resize            resize image factor from 1 to 100 (in percent). 100 is equal to 100% of the original scale
+         * @param nativeProcessing  <code>true</code> to run the native processing of the wrapper, <code>false</code> to run
+         *                          Companion's 'HybridRecognition'
+         */
+        HybridRecognition(HashRecognition^ hashRecognition, FeatureMatching^ matchingAlgo, int resize, bool nativeProcessing);
 
         /**
          * Add an image model to this hybrid recognition.
@@ -86,6 +104,60 @@ namespace CompanionWinRT
          */
         void addModel(Platform::String^ imagePath, int id);
 
+        /**
+         * Add an image model with a tag (group) to this hybrid recognition.
+         *
+         * @param imagePath path of the image that is going to be the image model
+         * @param id        the ID of the image model
+         * @param tag       tag of the image model, see 'setActiveTags'
+         */
+        void addModel(Platform::String^ imagePath, int id, Platform::String^ tag);
+
+        /**
+         * Select the active model tags. Only hash candidates of models with an active tag are verified. Models don't have to be
+         * added again when the selection changes.
+         *
+         * @param tags  active tags (nullptr or an empty vector activates all models)
+         */
+        void setActiveTags(IVector<Platform::String^>^ tags);
+
+        /**
+         * Set the maximum number of objects per frame. Hash candidates are verified in the order of their likelihood (recently
+         * recognized models first, then by hash score) and verification stops once this many objects were recognized.
+         *
+         * @param maxObjects    maximum number of objects per frame (0 for no limit)
+         */
+        void setMaxObjects(int maxObjects);
+
+        /**
+         * Return the maximum number of objects per frame.
+         *
+         * @return maximum number of objects per frame (0 for no limit)
+         */
+        int getMaxObjects();
+
+        /**
+         * Enable or disable the deterministic mode. In deterministic mode models are verified in registration order and parallel
+         * verifications are merged in a fixed order. The same frames then yield identical results at any thread count
+         * (set with OpenCV's 'cv::setNumThreads').
+         *
+         * @param deterministic <code>true</code> to enable the deterministic mode, <code>false</code> to disable it
+         */
+        void setDeterministic(bool deterministic);
+
+        /**
+         * Select the most informative and least correlated descriptor bits over all models added so far (for example 128 or 256 of
+         * the 512 BRISK bits) and search matches with compact descriptors made of these bits. This reduces memory and Hamming cost
+         * by the ratio of full to selected bits. Models added later use the same bit selection.
+         *
+         * This only applies to binary descriptors (BRISK, ORB). Without re-ranking only the compact model descriptors are kept,
+         * so the selection can't be changed afterwards ('settings_locked').
+         *
+         * @param bits      number of bits to select (0 to match with the full descriptors again)
+         * @param reRank    <code>true</code> to re-rank the compact candidate matches with the full descriptors
+         */
+        void selectDescriptorBits(int bits, bool reRank);
+
         /**
          * Destruct this instance.
          */
@@ -94,9 +166,19 @@ namespace CompanionWinRT
     private:
 
         /**
-         * The native 'HybridRecognition' object of this instance.
+         * Throw 'native_processing_required' if this instance runs Companion's 'HybridRecognition'.
+         */
+        void requireNativeProcessing();
+
+        /**
+         * The native 'HybridProcessing' object of this instance (nullptr if Companion's 'HybridRecognition' is used).
          */
-        Companion::Processing::Recognition::HybridRecognition* hybridRecognitionObj;
+        Native::HybridProcessing* hybridRecognitionObj;
+
+        /**
+         * The Companion 'HybridRecognition' object of this instance (nullptr if the native processing is used).
+         */
+        Companion::Processing::Recognition::HybridRecognition* companionRecognitionObj;
 
         /**
          * A handle to the hash recognition.
@@ -123,10 +205,17 @@ namespace CompanionWinRT
     internal:
 
         /**
-         * Internal method to provide the native 'HybridRecognition' object.
+         * Internal method to provide the processing of this instance.
+         *
+         * @return pointer to the native 'HybridProcessing' object or to the Companion 'HybridRecognition' object
+         */
+        Companion::Processing::ImageProcessing* getHybridRecognition();
+
+        /**
+         * Internal method to provide the native 'HybridProcessing' object.
          *
-         * @return pointer to the native 'HybridRecognition' object
+         * @return pointer to the native 'HybridProcessing' object (nullptr if Companion's 'HybridRecognition' is used)
          */
-        Companion::Processing::Recognition::HybridRecognition* getHybridRecognition();
+        Native::HybridProcessing* getHybridProcessing();
     };
 }
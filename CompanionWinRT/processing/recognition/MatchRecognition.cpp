@@ -17,16 +17,24 @@
  */
 
 #include "MatchRecognition.h"
-#include "CompanionWinRT\utils\CompanionError.h"
+#include "CompanionWinRT/utils/CompanionError.h"
 
 using namespace CompanionWinRT;
 
-MatchRecognition::MatchRecognition(FeatureMatching^ matchingAlgo, Scaling scaling)
+MatchRecognition::MatchRecognition(FeatureMatching^ matchingAlgo, Scaling scaling, bool nativeProcessing)
+    : matchRecognitionObj(nullptr), companionRecognitionObj(nullptr)
 {
     if (matchingAlgo != nullptr)
     {
         this->matchingAlgo = matchingAlgo;
-        this->matchRecognitionObj = new Companion::Processing::Recognition::MatchRecognition(this->matchingAlgo->getFeatureMatching(), Utils::getScaling(scaling));
+        if (nativeProcessing)
+        {
+            this->matchRecognitionObj = new Native::MatchProcessing(this->matchingAlgo->getFeatureVerification(), Utils::getScalingSize(scaling));
+        }
+        else
+        {
+            this->companionRecognitionObj = new Companion::Processing::Recognition::MatchRecognition(this->matchingAlgo->getFeatureMatching(), Utils::getScaling(scaling));
+        }
     }
     else
     {
@@ -39,12 +47,28 @@ MatchRecognition::~MatchRecognition()
 {
     delete this->matchRecognitionObj;
     this->matchRecognitionObj = nullptr;
+    delete this->companionRecognitionObj;
+    this->companionRecognitionObj = nullptr;
 }
 
 void MatchRecognition::addModel(FeatureMatchingModel^ model)
 {
+    this->addModel(model, "");
+}
+
+void MatchRecognition::addModel(FeatureMatchingModel^ model, Platform::String^ tag)
+{
+    std::string modelTag = Utils::ps2ss(tag);
+    if (!modelTag.empty())
+    {
+        this->requireNativeProcessing();
+    }
+
     this->models->Append(model);
-    if (!this->matchRecognitionObj->addModel(model->getFeatureMatchingModel()))
+    bool added = (this->matchRecognitionObj != nullptr)
+        ? this->matchRecognitionObj->addModel(model->getFeatureMatchingModel()->getID(), model->getImage(), modelTag)
+        : this->companionRecognitionObj->addModel(model->getFeatureMatchingModel());
+    if (!added)
     {
         int hresult = static_cast<int>(ErrorCode::model_not_added);
         throw ref new Platform::Exception(hresult);
@@ -62,7 +86,14 @@ void MatchRecognition::removeModel(int modelID)
     {
         if (this->models->GetAt(i)->getFeatureMatchingModel()->getID() == modelID)
         {
-            this->matchRecognitionObj->removeModel(modelID);
+            if (this->matchRecognitionObj != nullptr)
+            {
+                this->matchRecognitionObj->removeModel(modelID);
+            }
+            else
+            {
+                this->companionRecognitionObj->removeModel(modelID);
+            }
             this->models->RemoveAt(i);
         }
     }
@@ -70,11 +101,69 @@ void MatchRecognition::removeModel(int modelID)
 
 void MatchRecognition::clearModels()
 {
-    this->matchRecognitionObj->clearModels();
+    if (this->matchRecognitionObj != nullptr)
+    {
+        this->matchRecognitionObj->clearModels();
+    }
+    else
+    {
+        this->companionRecognitionObj->clearModels();
+    }
     this->models->Clear();
 }
 
-Companion::Processing::Recognition::MatchRecognition* MatchRecognition::getMatchRecognition()
+void MatchRecognition::setActiveTags(IVector<Platform::String^>^ tags)
+{
+    this->requireNativeProcessing();
+    this->matchRecognitionObj->setActiveTags(Utils::getTags(tags));
+}
+
+void MatchRecognition::selectDescriptorBits(int bits, bool reRank)
+{
+    this->requireNativeProcessing();
+    if (!this->matchRecognitionObj->selectDescriptorBits(bits, reRank))
+    {
+        int hresult = static_cast<int>(ErrorCode::settings_locked);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+void MatchRecognition::setMaxObjects(int maxObjects)
+{
+    this->requireNativeProcessing();
+    this->matchRecognitionObj->setMaxObjects(maxObjects);
+}
+
+int MatchRecognition::getMaxObjects()
+{
+    return (this->matchRecognitionObj != nullptr) ? this->matchRecognitionObj->getMaxObjects() : 0;
+}
+
+void MatchRecognition::setDeterministic(bool deterministic)
+{
+    this->requireNativeProcessing();
+    this->matchRecognitionObj->setDeterministic(deterministic);
+}
+
+void MatchRecognition::requireNativeProcessing()
+{
+    if (this->matchRecognitionObj == nullptr)
+    {
+        int hresult = static_cast<int>(ErrorCode::native_processing_required);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+Companion::Processing::ImageProcessing* MatchRecognition::getMatchRecognition()
+{
+    if (this->matchRecognitionObj != nullptr)
+    {
+        return this->matchRecognitionObj;
+    }
+    return this->companionRecognitionObj;
+}
+
+Native::MatchProcessing* MatchRecognition::getMatchProcessing()
 {
     return this->matchRecognitionObj;
 }
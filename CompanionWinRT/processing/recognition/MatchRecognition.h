@@ -19,11 +19,12 @@
 #pragma once
 
 #include <collection.h>
-#include <companion\processing\recognition\MatchRecognition.h>
+#include <companion/processing/recognition/MatchRecognition.h>
 
-#include "CompanionWinRT\algo\recognition\matching\FeatureMatching.h"
-#include "CompanionWinRT\model\processing\FeatureMatchingModel.h"
-#include "CompanionWinRT\utils\CompanionUtils.h"
+#include "CompanionWinRT/algo/recognition/matching/FeatureMatching.h"
+#include "CompanionWinRT/model/processing/FeatureMatchingModel.h"
+#include "CompanionWinRT/native/MatchProcessing.h"
+#include "CompanionWinRT/utils/CompanionUtils.h"
 
 using namespace Platform::Collections;
 using namespace Windows::Foundation::Collections;
@@ -33,6 +34,11 @@ namespace CompanionWinRT
     /**
      * This class provides a WinRT wrapper for the 'MatchRecognition' functionality of the Companion framework.
      *
+     * By default the recognition runs Companion's 'MatchRecognition'. With the native processing of the wrapper, models are
+     * verified in the order of their recognition history by the wrapper's feature verification (ratio test and robust homography
+     * estimation) and the IRA setting of the matching algorithm is ignored. Tags, object limits, compact descriptors, the
+     * deterministic mode and region masks require the native processing ('native_processing_required' otherwise).
+     *
      * Note 1:
      * This is a minimum construction -- it has to be extended to provide the same flexability as the Companion native code.
      *
@@ -74,7 +80,18 @@ namespace CompanionWinRT
              * @param matchingAlgo  matching algorithm to use, for example feature matching
              * @param scaling       scaling resolution for image processing
              */
-            MatchRecognition(FeatureMatching^ matchingAlgo, Scaling scaling);
+            MatchRecognition(FeatureMatching^ matchingAlgo, Scaling scaling) : MatchRecognition(matchingAlgo, scaling, false)
+            {};
+
+            /**
+             * Create a 'MatchRecognition' wrapper with the provided matching algorithm.
+             *
+             * @param matchingAlgo      matching algorithm to use, for example feature matching
+             * @param scaling           scaling resolution for image processing
+             * @param nativeProcessing  <code>true</code> to run the native processing of the wrapper, <code>false</code> to run
+             *                          Companion's 'MatchRecognition'
+             */
+            MatchRecognition(FeatureMatching^ matchingAlgo, Scaling scaling, bool nativeProcessing);
 
             /**
              * Add a feature matching model to this match recognition.
@@ -83,6 +100,22 @@ namespace CompanionWinRT
              */
             void addModel(FeatureMatchingModel^ model);
 
+            /**
+             * Add a feature matching model with a tag (group) to this match recognition.
+             *
+             * @param model a feature matching model for this match recognition
+             * @param tag   tag of the model, see 'setActiveTags'
+             */
+            void addModel(FeatureMatchingModel^ model, Platform::String^ tag);
+
+            /**
+             * Select the active model tags. Only models with an active tag are matched, so the processing cost scales with the
+             * active subset instead of all models. Models don't have to be added again when the selection changes.
+             *
+             * @param tags  active tags (nullptr or an empty vector activates all models)
+             */
+            void setActiveTags(IVector<Platform::String^>^ tags);
+
             /**
              * Return a vector of all feature mathing models.
              *
@@ -102,6 +135,43 @@ namespace CompanionWinRT
              */
             void clearModels();
 
+            /**
+             * Set the maximum number of objects per frame. Models are verified in the order of their likelihood (recently
+             * recognized models first) and verification stops once this many objects were recognized.
+             *
+             * @param maxObjects    maximum number of objects per frame (0 for no limit)
+             */
+            void setMaxObjects(int maxObjects);
+
+            /**
+             * Return the maximum number of objects per frame.
+             *
+             * @return maximum number of objects per frame (0 for no limit)
+             */
+            int getMaxObjects();
+
+            /**
+             * Enable or disable the deterministic mode. In deterministic mode models are verified in registration order and parallel
+             * verifications are merged in a fixed order. The same frames then yield identical results at any thread count
+             * (set with OpenCV's 'cv::setNumThreads').
+             *
+             * @param deterministic <code>true</code> to enable the deterministic mode, <code>false</code> to disable it
+             */
+            void setDeterministic(bool deterministic);
+
+            /**
+             * Select the most informative and least correlated descriptor bits over all models added so far (for example 128 or 256 of
+             * the 512 BRISK bits) and search matches with compact descriptors made of these bits. This reduces memory and Hamming cost
+             * by the ratio of full to selected bits. Models added later use the same bit selection.
+             *
+             * This only applies to binary descriptors (BRISK, ORB). Without re-ranking only the compact model descriptors are kept,
+             * so the selection can't be changed afterwards ('settings_locked').
+             *
+             * @param bits      number of bits to select (0 to match with the full descriptors again)
+             * @param reRank    <code>true</code> to re-rank the compact candidate matches with the full descriptors
+             */
+            void selectDescriptorBits(int bits, bool reRank);
+
             /**
              * Destruct this instance.
              */
@@ -110,9 +180,19 @@ namespace CompanionWinRT
         private:
 
             /**
-             * The native 'MatchRecognition' object of this instance.
+             * Throw 'native_processing_required' if this instance runs Companion's 'MatchRecognition'.
              */
-            Companion::Processing::Recognition::MatchRecognition* matchRecognitionObj;
+            void requireNativeProcessing();
+
+            /**
+             * The native 'MatchProcessing' object of this instance (nullptr if Companion's 'MatchRecognition' is used).
+             */
+            Native::MatchProcessing* matchRecognitionObj;
+
+            /**
+             * The Companion 'MatchRecognition' object of this instance (nullptr if the native processing is used).
+             */
+            Companion::Processing::Recognition::MatchRecognition* companionRecognitionObj;
 
             /**
              * A handle to the desired matching algorithm.
@@ -134,10 +214,17 @@ namespace CompanionWinRT
         internal:
 
             /**
-             * Internal method to provide the native 'MatchRecognition' object.
+             * Internal method to provide the processing of this instance.
+             *
+             * @return pointer to the native 'MatchProcessing' object or to the Companion 'MatchRecognition' object
+             */
+            Companion::Processing::ImageProcessing* getMatchRecognition();
+
+            /**
+             * Internal method to provide the native 'MatchProcessing' object.
              *
-             * @return pointer to the native 'MatchRecognition' object
+             * @return pointer to the native 'MatchProcessing' object (nullptr if Companion's 'MatchRecognition' is used)
              */
-            Companion::Processing::Recognition::MatchRecognition* getMatchRecognition();
+            Native::MatchProcessing* getMatchProcessing();
     };
 }
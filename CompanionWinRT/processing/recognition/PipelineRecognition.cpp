@@ -0,0 +1,153 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "PipelineRecognition.h"
+#include "CompanionWinRT/utils/CompanionError.h"
+
+using namespace CompanionWinRT;
+
+PipelineRecognition::PipelineRecognition(FeatureMatching^ matchingAlgo, Scaling scaling)
+{
+    if (matchingAlgo != nullptr)
+    {
+        this->matchingAlgo = matchingAlgo;
+        this->pipelineRecognitionObj = new Native::GraphProcessing(this->matchingAlgo->getFeatureVerification(), Utils::getScalingSize(scaling));
+    }
+    else
+    {
+        int hresult = static_cast<int>(ErrorCode::handle_is_null);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+PipelineRecognition::~PipelineRecognition()
+{
+    delete this->pipelineRecognitionObj;
+    this->pipelineRecognitionObj = nullptr;
+}
+
+int PipelineRecognition::addMotionGate(float64 threshold, const Platform::Array<int>^ inputs)
+{
+    return checkNode(this->pipelineRecognitionObj->addMotionGate(threshold, getInputs(inputs)));
+}
+
+int PipelineRecognition::addShapeGate(ShapeDetection^ shapeDetection, int margin, const Platform::Array<int>^ inputs)
+{
+    if (shapeDetection == nullptr)
+    {
+        int hresult = static_cast<int>(ErrorCode::handle_is_null);
+        throw ref new Platform::Exception(hresult);
+    }
+
+    int node = checkNode(this->pipelineRecognitionObj->addShapeGate(shapeDetection->getShapeDetection(), margin, getInputs(inputs)));
+    this->shapeDetections->Append(shapeDetection);
+    return node;
+}
+
+int PipelineRecognition::addHashing(HashRecognition^ hashRecognition, const Platform::Array<int>^ inputs)
+{
+    if (hashRecognition == nullptr)
+    {
+        int hresult = static_cast<int>(ErrorCode::handle_is_null);
+        throw ref new Platform::Exception(hresult);
+    }
+
+    int node = checkNode(this->pipelineRecognitionObj->addHashing(hashRecognition->getHashRecognition(), getInputs(inputs)));
+    this->hashRecognitions->Append(hashRecognition);
+    return node;
+}
+
+int PipelineRecognition::addExtraction(const Platform::Array<int>^ inputs)
+{
+    return checkNode(this->pipelineRecognitionObj->addExtraction(getInputs(inputs)));
+}
+
+int PipelineRecognition::addVerification(const Platform::Array<int>^ inputs)
+{
+    return checkNode(this->pipelineRecognitionObj->addVerification(getInputs(inputs)));
+}
+
+int PipelineRecognition::getNodeCount()
+{
+    return this->pipelineRecognitionObj->getNodeCount();
+}
+
+void PipelineRecognition::addModel(FeatureMatchingModel^ model)
+{
+    this->addModel(model, "");
+}
+
+void PipelineRecognition::addModel(FeatureMatchingModel^ model, Platform::String^ tag)
+{
+    this->models->Append(model);
+    if (!this->pipelineRecognitionObj->addModel(model->getFeatureMatchingModel()->getID(), model->getImage(), Utils::ps2ss(tag)))
+    {
+        int hresult = static_cast<int>(ErrorCode::model_not_added);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+void PipelineRecognition::setActiveTags(IVector<Platform::String^>^ tags)
+{
+    this->pipelineRecognitionObj->setActiveTags(Utils::getTags(tags));
+}
+
+IVector<FeatureMatchingModel^>^ PipelineRecognition::getModels()
+{
+    return this->models;
+}
+
+void PipelineRecognition::setMaxObjects(int maxObjects)
+{
+    this->pipelineRecognitionObj->setMaxObjects(maxObjects);
+}
+
+int PipelineRecognition::getMaxObjects()
+{
+    return this->pipelineRecognitionObj->getMaxObjects();
+}
+
+void PipelineRecognition::setDeterministic(bool deterministic)
+{
+    this->pipelineRecognitionObj->setDeterministic(deterministic);
+}
+
+std::vector<int> PipelineRecognition::getInputs(const Platform::Array<int>^ inputs)
+{
+    std::vector<int> nodes;
+    if (inputs != nullptr)
+    {
+        nodes.assign(inputs->begin(), inputs->end());
+    }
+    return nodes;
+}
+
+int PipelineRecognition::checkNode(int node)
+{
+    if (node < 0)
+    {
+        int hresult = static_cast<int>(ErrorCode::invalid_pipeline_node);
+        throw ref new Platform::Exception(hresult);
+    }
+    return node;
+}
+
+Native::GraphProcessing* PipelineRecognition::getPipelineRecognition()
+{
+    return this->pipelineRecognitionObj;
+}
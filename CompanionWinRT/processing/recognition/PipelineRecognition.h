@@ -0,0 +1,229 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <collection.h>
+
+#include "CompanionWinRT/algo/detection/ShapeDetection.h"
+#include "CompanionWinRT/algo/recognition/matching/FeatureMatching.h"
+#include "CompanionWinRT/model/processing/FeatureMatchingModel.h"
+#include "CompanionWinRT/native/GraphProcessing.h"
+#include "CompanionWinRT/processing/recognition/HashRecognition.h"
+#include "CompanionWinRT/utils/CompanionUtils.h"
+
+using namespace Platform::Collections;
+using namespace Windows::Foundation::Collections;
+
+namespace CompanionWinRT
+{
+    /**
+     * This class provides a WinRT wrapper for a configurable graph of processing stages. The recognitions of this wrapper hard-wire
+     * their stage order, a pipeline assembles the same stages freely, for example:
+     *
+     * - Match recognition: extraction (0) -> verification
+     * - Gated recognition: shape gate (0) -> extraction -> verification
+     * - Hybrid recognition: hashing (0) -> extraction -> verification
+     * - Hybrid recognition of moving scenes only: motion gate (0) -> hashing -> extraction -> verification
+     *
+     * Node 0 is the preprocessing (gray conversion, scaling and region mask), all other nodes depend on it. Every 'add' function
+     * returns the ID of the new node, which can be used as input of nodes added later. Nodes without dependencies between each
+     * other are executed in parallel and the results of all verification nodes are merged.
+     *
+     * Note:
+     * Native code in interfaces and public inheritance are not possible in a Windows Runtime context (with very few exceptions).
+     * We can not mirror the plausible interface / abstract class 'ImageProcessing' for this wrapper.
+     *
+     * @author Dimitri Kotlovsky, Andreas Sekulski
+     */
+    public ref class PipelineRecognition sealed
+    {
+        public:
+
+            /**
+             * Create a 'PipelineRecognition' wrapper that only contains the preprocessing node.
+             *
+             * @param matchingAlgo  matching algorithm used by extraction and verification nodes
+             * @param scaling       scaling resolution for image processing
+             */
+            PipelineRecognition(FeatureMatching^ matchingAlgo, Scaling scaling);
+
+            /**
+             * Add a motion gate. Dependent nodes are skipped while the mean absolute gray value difference to the last frame that
+             * passed the gate stays below the threshold, and the last results are repeated.
+             *
+             * @param threshold mean absolute gray value difference (0 - 255)
+             * @param inputs    IDs of the input nodes (gates only, nullptr for none)
+             * @return ID of the new node
+             */
+            int addMotionGate(float64 threshold, const Platform::Array<int>^ inputs);
+
+            /**
+             * Add a shape gate. Dependent extractions only search inside the detected shapes, and dependent nodes are skipped if no
+             * shape is detected.
+             *
+             * @param shapeDetection    shape detection that provides the candidate shapes
+             * @param margin            margin around the detected shapes (in pixels)
+             * @param inputs            IDs of the input nodes (gates only, nullptr for none)
+             * @return ID of the new node
+             */
+            int addShapeGate(ShapeDetection^ shapeDetection, int margin, const Platform::Array<int>^ inputs);
+
+            /**
+             * Add a hashing. Dependent extractions only search inside the candidate regions, dependent verifications only verify the
+             * candidate models. Add hashings before the models, models are added to the hash recognition of all hashing nodes.
+             *
+             * @param hashRecognition   hash recognition that provides the candidates
+             * @param inputs            IDs of the input nodes (gates only, nullptr for none)
+             * @return ID of the new node
+             */
+            int addHashing(HashRecognition^ hashRecognition, const Platform::Array<int>^ inputs);
+
+            /**
+             * Add a feature extraction.
+             *
+             * @param inputs    IDs of the input nodes (gates and at most one hashing, nullptr for none)
+             * @return ID of the new node
+             */
+            int addExtraction(const Platform::Array<int>^ inputs);
+
+            /**
+             * Add a verification. The results of all verifications are merged (best score per model).
+             *
+             * @param inputs    IDs of the input nodes (exactly one extraction and any gates)
+             * @return ID of the new node
+             */
+            int addVerification(const Platform::Array<int>^ inputs);
+
+            /**
+             * Return the number of nodes (including the preprocessing node).
+             *
+             * @return number of nodes
+             */
+            int getNodeCount();
+
+            /**
+             * Add a feature matching model to this pipeline recognition.
+             *
+             * @param model a feature matching model for this pipeline recognition
+             */
+            void addModel(FeatureMatchingModel^ model);
+
+            /**
+             * Add a feature matching model with a tag (group) to this pipeline recognition.
+             *
+             * @param model a feature matching model for this pipeline recognition
+             * @param tag   tag of the model, see 'setActiveTags'
+             */
+            void addModel(FeatureMatchingModel^ model, Platform::String^ tag);
+
+            /**
+             * Select the active model tags. Only models with an active tag are matched. Models don't have to be added again when the
+             * selection changes.
+             *
+             * @param tags  active tags (nullptr or an empty vector activates all models)
+             */
+            void setActiveTags(IVector<Platform::String^>^ tags);
+
+            /**
+             * Return a vector of all feature mathing models.
+             *
+             * @return all feature mathing models
+             */
+            IVector<FeatureMatchingModel^>^ getModels();
+
+            /**
+             * Set the maximum number of objects per frame. Models are verified in the order of their likelihood (recently
+             * recognized models first) and verification stops once this many objects were recognized.
+             *
+             * @param maxObjects    maximum number of objects per frame (0 for no limit)
+             */
+            void setMaxObjects(int maxObjects);
+
+            /**
+             * Return the maximum number of objects per frame.
+             *
+             * @return maximum number of objects per frame (0 for no limit)
+             */
+            int getMaxObjects();
+
+            /**
+             * Enable or disable the deterministic mode, see 'GatedRecognition::setDeterministic'.
+             *
+             * @param deterministic <code>true</code> to enable the deterministic mode, <code>false</code> to disable it
+             */
+            void setDeterministic(bool deterministic);
+
+            /**
+             * Destruct this instance.
+             */
+            virtual ~PipelineRecognition();
+
+        private:
+
+            /**
+             * Convert the IDs of input nodes.
+             *
+             * @param inputs    IDs of the input nodes (nullptr for none)
+             * @return IDs of the input nodes
+             */
+            static std::vector<int> getInputs(const Platform::Array<int>^ inputs);
+
+            /**
+             * Check the ID of a new node.
+             *
+             * @param node  ID of the new node (-1 if the node was not added)
+             * @return ID of the new node
+             */
+            static int checkNode(int node);
+
+            /**
+             * The native 'GraphProcessing' object of this instance.
+             */
+            Native::GraphProcessing* pipelineRecognitionObj;
+
+            /**
+             * A handle to the desired matching algorithm.
+             */
+            FeatureMatching^ matchingAlgo;
+
+            /**
+             * Handles to the shape detections of all shape gates.
+             */
+            Vector<ShapeDetection^>^ shapeDetections = ref new Vector<ShapeDetection^>();
+
+            /**
+             * Handles to the hash recognitions of all hashings.
+             */
+            Vector<HashRecognition^>^ hashRecognitions = ref new Vector<HashRecognition^>();
+
+            /**
+             * A collection of all feature matching models.
+             */
+            Vector<FeatureMatchingModel^>^ models = ref new Vector<FeatureMatchingModel^>();
+
+        internal:
+
+            /**
+             * Internal method to provide the native 'GraphProcessing' object.
+             *
+             * @return pointer to the native 'GraphProcessing' object
+             */
+            Native::GraphProcessing* getPipelineRecognition();
+    };
+}
@@ -0,0 +1,87 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "ShardedRecognition.h"
+#include "CompanionWinRT/utils/CompanionError.h"
+
+using namespace CompanionWinRT;
+
+ShardedRecognition::ShardedRecognition(FeatureMatching^ matchingAlgo, Scaling scaling, int maxCandidates)
+{
+    if (matchingAlgo != nullptr)
+    {
+        this->matchingAlgo = matchingAlgo;
+        this->shardedRecognitionObj = new Native::ShardProcessing(this->matchingAlgo->getFeatureVerification(), Utils::getScalingSize(scaling), maxCandidates);
+    }
+    else
+    {
+        int hresult = static_cast<int>(ErrorCode::handle_is_null);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+ShardedRecognition::~ShardedRecognition()
+{
+    delete this->shardedRecognitionObj;
+    this->shardedRecognitionObj = nullptr;
+}
+
+void ShardedRecognition::addShard(Platform::String^ host, int port)
+{
+    if (!this->shardedRecognitionObj->isQueryable())
+    {
+        int hresult = static_cast<int>(ErrorCode::detector_key_too_long);
+        throw ref new Platform::Exception(hresult);
+    }
+
+    if (!this->shardedRecognitionObj->addShard(Utils::ps2ss(host), port))
+    {
+        int hresult = static_cast<int>(ErrorCode::shard_not_connected);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+void ShardedRecognition::clearShards()
+{
+    this->shardedRecognitionObj->clearShards();
+}
+
+int ShardedRecognition::getShardCount()
+{
+    return this->shardedRecognitionObj->getShardCount();
+}
+
+void ShardedRecognition::setMaxObjects(int maxObjects)
+{
+    this->shardedRecognitionObj->setMaxObjects(maxObjects);
+}
+
+int ShardedRecognition::getMaxObjects()
+{
+    return this->shardedRecognitionObj->getMaxObjects();
+}
+
+uint64 ShardedRecognition::getFailedQueries()
+{
+    return this->shardedRecognitionObj->getFailedQueries();
+}
+
+Native::ShardProcessing* ShardedRecognition::getShardedRecognition()
+{
+    return this->shardedRecognitionObj;
+}
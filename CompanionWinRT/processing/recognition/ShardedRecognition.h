@@ -0,0 +1,133 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include "CompanionWinRT/algo/recognition/matching/FeatureMatching.h"
+#include "CompanionWinRT/native/ShardProcessing.h"
+#include "CompanionWinRT/utils/CompanionUtils.h"
+
+namespace CompanionWinRT
+{
+    /**
+     * This class provides a WinRT wrapper for a feature matching over a model catalog that is partitioned across local shard
+     * processes. Scene features are extracted once per frame and sent to all shards, the shards verify their models and the best
+     * candidates of all shards are merged into the results.
+     *
+     * Models are not added to this recognition but loaded by the shard processes, see the 'ShardWorker' folder. The feature
+     * matching has to use the same detector type, descriptor matcher and parameters as the shards, shards with other settings
+     * reject the queries (counted as failed queries).
+     *
+     * Note:
+     * Native code in interfaces and public inheritance are not possible in a Windows Runtime context (with very few exceptions).
+     * We can not mirror the plausible interface / abstract class 'ImageProcessing' for this wrapper.
+     *
+     * @author Dimitri Kotlovsky, Andreas Sekulski
+     */
+    public ref class ShardedRecognition sealed
+    {
+        public:
+
+            /**
+             * Create a 'ShardedRecognition' wrapper with up to 8 candidates per shard.
+             *
+             * @param matchingAlgo  matching algorithm used to extract the scene features
+             * @param scaling       scaling resolution for image processing
+             */
+            ShardedRecognition(FeatureMatching^ matchingAlgo, Scaling scaling) : ShardedRecognition(matchingAlgo, scaling, 8)
+            {};
+
+            /**
+             * Create a 'ShardedRecognition' wrapper.
+             *
+             * @param matchingAlgo  matching algorithm used to extract the scene features
+             * @param scaling       scaling resolution for image processing
+             * @param maxCandidates maximum number of candidates per shard (1 - 64)
+             */
+            ShardedRecognition(FeatureMatching^ matchingAlgo, Scaling scaling, int maxCandidates);
+
+            /**
+             * Connect to a shard process. Shards that fail during the processing are reconnected with the next frame. Throws
+             * 'detector_key_too_long' if the detector settings of the feature matching can't be sent to the shards.
+             *
+             * @param host  host name or address of the shard
+             * @param port  TCP port of the shard
+             */
+            void addShard(Platform::String^ host, int port);
+
+            /**
+             * Disconnect from all shards. Connections of a frame in progress are closed once the frame is finished.
+             */
+            void clearShards();
+
+            /**
+             * Return the number of shards.
+             *
+             * @return number of shards
+             */
+            int getShardCount();
+
+            /**
+             * Set the maximum number of objects per frame. The merged candidates with the best scores are kept.
+             *
+             * @param maxObjects    maximum number of objects per frame (0 for no limit)
+             */
+            void setMaxObjects(int maxObjects);
+
+            /**
+             * Return the maximum number of objects per frame.
+             *
+             * @return maximum number of objects per frame (0 for no limit)
+             */
+            int getMaxObjects();
+
+            /**
+             * Return the number of shard queries that were not answered or rejected. The models of a shard are missing in the results of a
+             * frame with a failed query.
+             *
+             * @return number of failed shard queries
+             */
+            uint64 getFailedQueries();
+
+            /**
+             * Destruct this instance.
+             */
+            virtual ~ShardedRecognition();
+
+        private:
+
+            /**
+             * The native 'ShardProcessing' object of this instance.
+             */
+            Native::ShardProcessing* shardedRecognitionObj;
+
+            /**
+             * A handle to the matching algorithm.
+             */
+            FeatureMatching^ matchingAlgo;
+
+        internal:
+
+            /**
+             * Internal method to provide the native 'ShardProcessing' object.
+             *
+             * @return pointer to the native 'ShardProcessing' object
+             */
+            Native::ShardProcessing* getShardedRecognition();
+    };
+}
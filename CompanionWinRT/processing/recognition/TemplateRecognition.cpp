@@ -0,0 +1,71 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "TemplateRecognition.h"
+#include "CompanionWinRT/utils/CompanionError.h"
+
+using namespace CompanionWinRT;
+
+TemplateRecognition::TemplateRecognition(float64 threshold, int pyramidLevels)
+{
+    this->templateRecognitionObj = new Native::TemplateProcessing(threshold, pyramidLevels);
+}
+
+TemplateRecognition::~TemplateRecognition()
+{
+    delete this->templateRecognitionObj;
+    this->templateRecognitionObj = nullptr;
+}
+
+void TemplateRecognition::addModel(FeatureMatchingModel^ model)
+{
+    this->models->Append(model);
+    if (!this->templateRecognitionObj->addModel(model->getFeatureMatchingModel()->getID(), model->getImage()))
+    {
+        int hresult = static_cast<int>(ErrorCode::model_not_added);
+        throw ref new Platform::Exception(hresult);
+    }
+}
+
+IVector<FeatureMatchingModel^>^ TemplateRecognition::getModels()
+{
+    return this->models;
+}
+
+void TemplateRecognition::removeModel(int modelID)
+{
+    for (int i = 0; i < this->models->Size; i++)
+    {
+        if (this->models->GetAt(i)->getFeatureMatchingModel()->getID() == modelID)
+        {
+            this->templateRecognitionObj->removeModel(modelID);
+            this->models->RemoveAt(i);
+        }
+    }
+}
+
+void TemplateRecognition::clearModels()
+{
+    this->templateRecognitionObj->clearModels();
+    this->models->Clear();
+}
+
+Native::TemplateProcessing* TemplateRecognition::getTemplateRecognition()
+{
+    return this->templateRecognitionObj;
+}
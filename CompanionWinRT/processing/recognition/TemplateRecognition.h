@@ -0,0 +1,112 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <collection.h>
+
+#include "CompanionWinRT/model/processing/FeatureMatchingModel.h"
+#include "CompanionWinRT/native/TemplateProcessing.h"
+#include "CompanionWinRT/utils/CompanionUtils.h"
+
+using namespace Platform::Collections;
+using namespace Windows::Foundation::Collections;
+
+namespace CompanionWinRT
+{
+    /**
+     * This class provides a WinRT wrapper for a template matching by normalized cross-correlation. It suits fixed camera setups
+     * where the objects appear at a nearly constant scale (the scale of the model images) and small catalogs.
+     *
+     * Note:
+     * Native code in interfaces and public inheritance are not possible in a Windows Runtime context (with very few exceptions).
+     * We can not mirror the plausible interface / abstract class 'ImageProcessing' for this wrapper.
+     *
+     * @author Dimitri Kotlovsky, Andreas Sekulski
+     */
+    public ref class TemplateRecognition sealed
+    {
+        public:
+
+            /**
+             * Create a 'TemplateRecognition' wrapper with a threshold of 0.8 and two pyramid levels.
+             */
+            TemplateRecognition() : TemplateRecognition(0.8, 2)
+            {};
+
+            /**
+             * Create a 'TemplateRecognition' wrapper.
+             *
+             * @param threshold     minimum normalized cross-correlation of a recognized model (0 to 1)
+             * @param pyramidLevels number of times the scene is halved for the coarse search (0 to 4, 0 to search at full resolution)
+             */
+            TemplateRecognition(float64 threshold, int pyramidLevels);
+
+            /**
+             * Add a feature matching model to this template recognition. The model image is used as template at its original scale.
+             *
+             * @param model a feature matching model for this template recognition
+             */
+            void addModel(FeatureMatchingModel^ model);
+
+            /**
+             * Return a vector of all feature mathing models.
+             *
+             * @return all feature mathing models
+             */
+            IVector<FeatureMatchingModel^>^ getModels();
+
+            /**
+             * Remove the given model from template recognition.
+             *
+             * @param modelID   ID of the model
+             */
+            void removeModel(int modelID);
+
+            /**
+             * Clear all image processing models.
+             */
+            void clearModels();
+
+            /**
+             * Destruct this instance.
+             */
+            virtual ~TemplateRecognition();
+
+        private:
+
+            /**
+             * The native 'TemplateProcessing' object of this instance.
+             */
+            Native::TemplateProcessing* templateRecognitionObj;
+
+            /**
+             * A collection of all feature matching models.
+             */
+            Vector<FeatureMatchingModel^>^ models = ref new Vector<FeatureMatchingModel^>();
+
+        internal:
+
+            /**
+             * Internal method to provide the native 'TemplateProcessing' object.
+             *
+             * @return pointer to the native 'TemplateProcessing' object
+             */
+            Native::TemplateProcessing* getTemplateRecognition();
+    };
+}
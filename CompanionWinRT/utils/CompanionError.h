@@ -54,7 +54,15 @@ namespace CompanionWinRT
         // additional error codes
         model_not_added, ///< Could not add model.
         handle_is_null, ///< Provided handle is null (nullptr)
-        model_path_not_set ///< Provided handle to model path is null (nullptr)
+        model_path_not_set, ///< Provided handle to model path is null (nullptr)
+        publisher_not_created, ///< Could not create the shared memory ring of the result publisher
+        export_failed, ///< Could not write the export file
+        shard_not_connected, ///< Could not connect to a shard process
+        invalid_pipeline_node, ///< The inputs of a pipeline node are invalid
+        settings_locked, ///< Settings can't be changed once models are added or only compact descriptors are kept
+        upright_not_supported, ///< The feature detector doesn't support the upright mode
+        native_processing_required, ///< The setting is only supported by the native processing of the wrapper
+        detector_key_too_long ///< The detector key doesn't fit into a shard query
     };
 
     /**
@@ -121,6 +129,30 @@ namespace CompanionWinRT
                     case ErrorCode::handle_is_null:
                         error = "The provided handle is null (nullptr).";
                         break;
+                    case ErrorCode::publisher_not_created:
+                        error = "Could not create the result publisher.";
+                        break;
+                    case ErrorCode::export_failed:
+                        error = "Could not write the export file.";
+                        break;
+                    case ErrorCode::shard_not_connected:
+                        error = "Could not connect to the shard process.";
+                        break;
+                    case ErrorCode::invalid_pipeline_node:
+                        error = "The inputs of the pipeline node are invalid.";
+                        break;
+                    case ErrorCode::settings_locked:
+                        error = "The settings can't be changed anymore.";
+                        break;
+                    case ErrorCode::upright_not_supported:
+                        error = "The feature detector doesn't support the upright mode.";
+                        break;
+                    case ErrorCode::native_processing_required:
+                        error = "The setting requires the native processing of the wrapper.";
+                        break;
+                    case ErrorCode::detector_key_too_long:
+                        error = "The detector key doesn't fit into a shard query.";
+                        break;
                 }
 
                 return error;
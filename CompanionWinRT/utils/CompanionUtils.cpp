@@ -98,6 +98,56 @@ Companion::SCALING Utils::getScaling(CompanionWinRT::Scaling scaling)
     return compScaling;
 }
 
+cv::Size Utils::getScalingSize(CompanionWinRT::Scaling scaling)
+{
+    cv::Size size(2048, 1152);
+
+    switch (scaling)
+    {
+        case CompanionWinRT::Scaling::SCALE_2048x1152:
+            size = cv::Size(2048, 1152);
+            break;
+        case CompanionWinRT::Scaling::SCALE_1920x1080:
+            size = cv::Size(1920, 1080);
+            break;
+        case CompanionWinRT::Scaling::SCALE_1600x900:
+            size = cv::Size(1600, 900);
+            break;
+        case CompanionWinRT::Scaling::SCALE_1408x792:
+            size = cv::Size(1408, 792);
+            break;
+        case CompanionWinRT::Scaling::SCALE_1344x756:
+            size = cv::Size(1344, 756);
+            break;
+        case CompanionWinRT::Scaling::SCALE_1280x720:
+            size = cv::Size(1280, 720);
+            break;
+        case CompanionWinRT::Scaling::SCALE_1152x648:
+            size = cv::Size(1152, 648);
+            break;
+        case CompanionWinRT::Scaling::SCALE_1024x576:
+            size = cv::Size(1024, 576);
+            break;
+        case CompanionWinRT::Scaling::SCALE_960x540:
+            size = cv::Size(960, 540);
+            break;
+        case CompanionWinRT::Scaling::SCALE_896x504:
+            size = cv::Size(896, 504);
+            break;
+        case CompanionWinRT::Scaling::SCALE_800x450:
+            size = cv::Size(800, 450);
+            break;
+        case CompanionWinRT::Scaling::SCALE_768x432:
+            size = cv::Size(768, 432);
+            break;
+        case CompanionWinRT::Scaling::SCALE_640x360:
+            size = cv::Size(640, 360);
+            break;
+    }
+
+    return size;
+}
+
 Platform::String^ Utils::ss2ps(const std::string& str)
 {
     std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
@@ -109,3 +159,18 @@ std::string Utils::ps2ss(Platform::String^ str)
     std::wstring_convert<std::codecvt_utf8<wchar_t>, wchar_t> converter;
     return converter.to_bytes(str->Data());
 }
+
+std::set<std::string> Utils::getTags(Windows::Foundation::Collections::IVector<Platform::String^>^ tags)
+{
+    std::set<std::string> tagSet;
+
+    if (tags != nullptr)
+    {
+        for (unsigned int i = 0; i < tags->Size; i++)
+        {
+            tagSet.insert(Utils::ps2ss(tags->GetAt(i)));
+        }
+    }
+
+    return tagSet;
+}
@@ -19,6 +19,8 @@
 /// @file
 #pragma once
 
+#include <set>
+#include <string>
 #include <companion/util/Util.h>
 
 namespace CompanionWinRT
@@ -89,6 +91,14 @@ namespace CompanionWinRT
          */
         Companion::SCALING getScaling(Scaling scaling);
 
+        /**
+         * Return the resolution of the given WinRT scaling value.
+         *
+         * @param scaling   WinRT scaling value
+         * @return resolution in pixels
+         */
+        cv::Size getScalingSize(Scaling scaling);
+
         /**
          * Convert std::string to Platform::String.
          *
@@ -104,5 +114,13 @@ namespace CompanionWinRT
          * @return native c++ compatible std::string
          */
         std::string ps2ss(Platform::String^ str);
+
+        /**
+         * Convert a vector of Platform::String tags to a set of std::string tags.
+         *
+         * @param tags  the tags to be converted (may be nullptr)
+         * @return native c++ compatible set of tags
+         */
+        std::set<std::string> getTags(Windows::Foundation::Collections::IVector<Platform::String^>^ tags);
     }
 }
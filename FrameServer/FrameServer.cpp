@@ -0,0 +1,238 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+
+/**
+ * Local test server that replays image files as an MJPEG or raw frame stream for 'NetworkStream'.
+ *
+ * Usage: FrameServer <port> <mjpeg|raw> <fps> <image> [<image> ...]
+ *
+ * Image arguments may contain wildcards in the file name (for example images\*.jpg), they are expanded by the server.
+ *
+ * The images are sent in a loop to one client at a time. Raw frames are sent as encoded payloads (width and height 0).
+ */
+
+/**
+ * Boundary of the multipart MJPEG stream.
+ */
+static const std::string BOUNDARY = "companionframe";
+
+/**
+ * Send all bytes.
+ *
+ * @param client    client socket
+ * @param data      bytes to send
+ * @param size      number of bytes
+ * @return <code>true</code> if all bytes were sent, <code>false</code> if the client disconnected
+ */
+static bool sendAll(SOCKET client, const char* data, size_t size)
+{
+    while (size > 0)
+    {
+        int count = send(client, data, static_cast<int>(size), 0);
+        if (count == SOCKET_ERROR)
+        {
+            return false;
+        }
+        data += count;
+        size -= count;
+    }
+    return true;
+}
+
+/**
+ * Append an unsigned 32-bit big endian integer.
+ *
+ * @param header    header to append to
+ * @param value     the integer
+ */
+static void appendBigEndian(std::string& header, uint32_t value)
+{
+    header.push_back(static_cast<char>((value >> 24) & 0xFF));
+    header.push_back(static_cast<char>((value >> 16) & 0xFF));
+    header.push_back(static_cast<char>((value >> 8) & 0xFF));
+    header.push_back(static_cast<char>(value & 0xFF));
+}
+
+/**
+ * Replay the images to a client until it disconnects.
+ *
+ * @param client    client socket
+ * @param mjpeg     <code>true</code> for MJPEG, <code>false</code> for raw frames
+ * @param fps       frames per second
+ * @param images    encoded images
+ */
+static void serve(SOCKET client, bool mjpeg, int fps, const std::vector<std::string>& images)
+{
+    if (mjpeg)
+    {
+        // Skip the request and answer with a multipart response
+        char request[4096];
+        recv(client, request, sizeof(request), 0);
+        std::string response = "HTTP/1.1 200 OK\r\nContent-Type: multipart/x-mixed-replace; boundary=" + BOUNDARY + "\r\nConnection: close\r\n\r\n";
+        if (!sendAll(client, response.c_str(), response.size()))
+        {
+            return;
+        }
+    }
+
+    std::chrono::milliseconds interval(1000 / std::max(1, fps));
+    for (size_t frame = 0; ; frame++)
+    {
+        const std::string& image = images[frame % images.size()];
+        std::string header;
+        if (mjpeg)
+        {
+            header = "--" + BOUNDARY + "\r\nContent-Type: image/jpeg\r\nContent-Length: " + std::to_string(image.size()) + "\r\n\r\n";
+        }
+        else
+        {
+            appendBigEndian(header, static_cast<uint32_t>(image.size()));
+            appendBigEndian(header, 0);
+            appendBigEndian(header, 0);
+            appendBigEndian(header, 0);
+        }
+
+        if (!sendAll(client, header.data(), header.size()) || !sendAll(client, image.data(), image.size())
+            || (mjpeg && !sendAll(client, "\r\n", 2)))
+        {
+            return;
+        }
+        std::this_thread::sleep_for(interval);
+    }
+}
+
+/**
+ * Expand a file pattern with wildcards in the file name, since neither cmd.exe nor the C runtime expand them.
+ *
+ * @param pattern   file path, optionally with wildcards
+ * @return matching file paths in alphabetical order (the pattern itself if it has no wildcards or nothing matches)
+ */
+static std::vector<std::string> expandPattern(const std::string& pattern)
+{
+    if (pattern.find_first_of("*?") == std::string::npos)
+    {
+        return { pattern };
+    }
+
+    size_t separator = pattern.find_last_of("\\/");
+    std::string directory = (separator == std::string::npos) ? std::string() : pattern.substr(0, separator + 1);
+
+    std::vector<std::string> paths;
+    WIN32_FIND_DATAA data;
+    HANDLE find = FindFirstFileA(pattern.c_str(), &data);
+    if (find != INVALID_HANDLE_VALUE)
+    {
+        do
+        {
+            if ((data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) == 0)
+            {
+                paths.push_back(directory + data.cFileName);
+            }
+        }
+        while (FindNextFileA(find, &data));
+        FindClose(find);
+    }
+
+    std::sort(paths.begin(), paths.end());
+    if (paths.empty())
+    {
+        paths.push_back(pattern);
+    }
+    return paths;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 5)
+    {
+        std::cerr << "Usage: FrameServer <port> <mjpeg|raw> <fps> <image> [<image> ...]" << std::endl;
+        return 1;
+    }
+
+    int port = std::stoi(argv[1]);
+    bool mjpeg = (std::string(argv[2]) == "mjpeg");
+    int fps = std::stoi(argv[3]);
+
+    std::vector<std::string> paths;
+    for (int i = 4; i < argc; i++)
+    {
+        std::vector<std::string> matches = expandPattern(argv[i]);
+        paths.insert(paths.end(), matches.begin(), matches.end());
+    }
+
+    std::vector<std::string> images;
+    for (size_t i = 0; i < paths.size(); i++)
+    {
+        std::ifstream file(paths[i], std::ios::binary);
+        if (!file)
+        {
+            std::cerr << "Could not read '" << paths[i] << "'." << std::endl;
+            return 1;
+        }
+        images.push_back(std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()));
+    }
+
+    WSADATA wsaData;
+    WSAStartup(MAKEWORD(2, 2), &wsaData);
+
+    SOCKET server = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<u_short>(port));
+    if ((server == INVALID_SOCKET) || (bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR)
+        || (listen(server, 1) == SOCKET_ERROR))
+    {
+        std::cerr << "Could not listen on port " << port << "." << std::endl;
+        WSACleanup();
+        return 1;
+    }
+
+    std::cout << "Serving " << images.size() << " images on 127.0.0.1:" << port << " (" << (mjpeg ? "MJPEG" : "raw") << ", " << fps << " fps)" << std::endl;
+    while (true)
+    {
+        SOCKET client = accept(server, nullptr, nullptr);
+        if (client == INVALID_SOCKET)
+        {
+            break;
+        }
+        std::cout << "Client connected." << std::endl;
+        serve(client, mjpeg, fps, images);
+        closesocket(client);
+        std::cout << "Client disconnected." << std::endl;
+    }
+
+    closesocket(server);
+    WSACleanup();
+    return 0;
+}
@@ -0,0 +1,128 @@
+#
+# CompanionWinRT is a Windows Runtime wrapper for Companion.
+# Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+#
+# This program is free software: you can redistribute it and/or modify
+# it under the terms of the GNU General Public License as published by
+# the Free Software Foundation, either version 3 of the License, or
+# (at your option) any later version.
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program.  If not, see <http://www.gnu.org/licenses/>.
+#
+
+
+# Profile-guided optimization workflow of the pipeline benchmark:
+#
+#   cmake [-DBUILD_DIR=<dir>] [-DFRAMES=<frames>] -P PipelineBenchmark/PGO.cmake
+#
+# 1. Build the regular Release configuration (baseline).
+# 2. Build the instrumented configuration and train it by replaying the bundled sample sequence.
+# 3. Rebuild the same tree with the recorded profile (and link time optimization).
+# 4. Run the benchmark with both builds and report the throughput delta against the baseline.
+cmake_minimum_required(VERSION 3.13)
+
+get_filename_component(SOURCE_DIR "${CMAKE_CURRENT_LIST_DIR}" ABSOLUTE)
+get_filename_component(SAMPLE_DIR "${SOURCE_DIR}/../samples/CompanionUWPSample/Assets" ABSOLUTE)
+if(NOT BUILD_DIR)
+    set(BUILD_DIR "${CMAKE_CURRENT_BINARY_DIR}/pgo")
+endif()
+if(NOT FRAMES)
+    set(FRAMES 500)
+endif()
+
+file(GLOB SCENES "${SAMPLE_DIR}/images/*.jpg")
+list(SORT SCENES)
+set(MODEL "${SAMPLE_DIR}/poster_left.jpg")
+if(NOT SCENES)
+    message(FATAL_ERROR "No sample sequence found in '${SAMPLE_DIR}/images'.")
+endif()
+
+# Configure and build one configuration of the benchmark
+function(build_benchmark dir)
+    execute_process(COMMAND "${CMAKE_COMMAND}" -S "${SOURCE_DIR}" -B "${dir}" -DCMAKE_BUILD_TYPE=Release ${ARGN} RESULT_VARIABLE result)
+    if(result)
+        message(FATAL_ERROR "Configuring '${dir}' failed.")
+    endif()
+    execute_process(COMMAND "${CMAKE_COMMAND}" --build "${dir}" --config Release --clean-first RESULT_VARIABLE result)
+    if(result)
+        message(FATAL_ERROR "Building '${dir}' failed.")
+    endif()
+endfunction()
+
+# Run the benchmark of a build and return its output
+function(run_benchmark dir frames output)
+    file(GLOB_RECURSE executable "${dir}/PipelineBenchmark" "${dir}/PipelineBenchmark.exe")
+    list(GET executable 0 executable)
+    execute_process(COMMAND "${executable}" ${ARGN} ${frames} "${MODEL}" ${SCENES} OUTPUT_VARIABLE text RESULT_VARIABLE result)
+    message("${text}")
+    if(result)
+        message(FATAL_ERROR "The benchmark of '${dir}' failed.")
+    endif()
+    set(${output} "${text}" PARENT_SCOPE)
+endfunction()
+
+# Return the throughput of a pipeline from the benchmark output
+function(get_rate text pipeline rate)
+    string(REGEX MATCH "${pipeline} pipeline: [0-9]+ frames in [0-9.]+ s \\(([0-9.]+) frames per second\\)" match "${text}")
+    set(${rate} "${CMAKE_MATCH_1}" PARENT_SCOPE)
+endfunction()
+
+message(STATUS "Building the Release baseline")
+build_benchmark("${BUILD_DIR}/release")
+
+# The instrumented and the optimized build share one tree, so the profiles match the object files
+message(STATUS "Building the instrumented configuration")
+file(REMOVE_RECURSE "${BUILD_DIR}/optimized/profile")
+build_benchmark("${BUILD_DIR}/optimized" -DPIPELINE_PGO=GENERATE "-DPIPELINE_PGO_DIR=${BUILD_DIR}/optimized/profile")
+
+# The profiles of all runs are accumulated, so the training covers the native matching and robust estimation, the Hough voting,
+# the bit selection and the conversions of the image buffer (color, gray and converted pipeline)
+list(LENGTH SCENES sceneCount)
+message(STATUS "Training on ${sceneCount} sample frames")
+run_benchmark("${BUILD_DIR}/optimized" ${sceneCount} training)
+message(STATUS "Training on ${sceneCount} sample frames with Hough voting and compact descriptors")
+run_benchmark("${BUILD_DIR}/optimized" ${sceneCount} training --hough --bits 256)
+
+file(GLOB rawProfiles "${BUILD_DIR}/optimized/profile/*.profraw")
+if(rawProfiles)
+    find_program(LLVM_PROFDATA NAMES llvm-profdata)
+    if(NOT LLVM_PROFDATA)
+        message(FATAL_ERROR "llvm-profdata is needed to merge the Clang profiles.")
+    endif()
+    execute_process(COMMAND "${LLVM_PROFDATA}" merge "-output=${BUILD_DIR}/optimized/profile/default.profdata" ${rawProfiles})
+endif()
+
+message(STATUS "Building the profile-guided configuration")
+build_benchmark("${BUILD_DIR}/optimized" -DPIPELINE_PGO=USE "-DPIPELINE_PGO_DIR=${BUILD_DIR}/optimized/profile")
+
+message(STATUS "Running the Release baseline")
+run_benchmark("${BUILD_DIR}/release" ${FRAMES} baseline)
+message(STATUS "Running the profile-guided build")
+run_benchmark("${BUILD_DIR}/optimized" ${FRAMES} optimized)
+
+# The benchmark prints the rates with two decimals, CMake computes in integers (hundredths of a frame and tenths of a percent)
+foreach(pipeline "Color" "Gray" "Converted")
+    get_rate("${baseline}" ${pipeline} baselineRate)
+    get_rate("${optimized}" ${pipeline} optimizedRate)
+    string(REPLACE "." "" baselineValue "${baselineRate}")
+    string(REPLACE "." "" optimizedValue "${optimizedRate}")
+    string(REGEX REPLACE "^0+" "" baselineValue "${baselineValue}")
+    string(REGEX REPLACE "^0+" "" optimizedValue "${optimizedValue}")
+    if(baselineValue AND optimizedValue)
+        math(EXPR delta "(${optimizedValue} - ${baselineValue}) * 1000 / ${baselineValue}")
+        set(sign "+")
+        if(delta LESS 0)
+            set(sign "-")
+            math(EXPR delta "-(${delta})")
+        endif()
+        math(EXPR deltaWhole "${delta} / 10")
+        math(EXPR deltaTenths "${delta} % 10")
+        message(STATUS "${pipeline} pipeline: ${baselineRate} -> ${optimizedRate} frames per second (${sign}${deltaWhole}.${deltaTenths}% against Release)")
+    endif()
+endforeach()
@@ -0,0 +1,696 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/calib3d.hpp>
+#include <opencv2/core/utility.hpp>
+#include <opencv2/features2d.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+#include "CompanionWinRT/native/FeatureVerification.h"
+#include "CompanionWinRT/native/ImageBuffer.h"
+#include "CompanionWinRT/native/MatchProcessing.h"
+#include "CompanionWinRT/native/PoseResult.h"
+#include "CompanionWinRT/native/ProcessingSession.h"
+#include "CompanionWinRT/native/StreamGate.h"
+#include "CompanionWinRT/native/WorkCounter.h"
+
+using namespace CompanionWinRT::Native;
+
+/**
+ * End-to-end benchmark of the color and the gray pipeline. The same scenes are processed by the native processing of the wrapper
+ * ('ImageBuffer', 'MatchProcessing' and 'ProcessingSession', as 'ImageStream', 'MatchRecognition' and 'Configuration' assemble
+ * them) with a gray result image ('ColorFormat::GRAY'):
+ *
+ *   - color pipeline: color frames that are converted once for the result handler
+ *   - gray pipeline: gray frames in the gray mode of the image buffer, which need no conversion at all
+ *   - converted pipeline: color frames in the gray mode of the image buffer, which are converted once when they are added
+ *
+ * Usage: PipelineBenchmark [--hough] [--bits <bits>] [--compare-threads <threads>] [--check-formats] <frames> <model image> <scene image> [<scene image> ...]
+ *
+ * '--hough' enables the Hough voting pre-verification, '--bits' matches with compact descriptors of the given number of bits (the
+ * candidates are re-ranked with the full descriptors). The gray pipeline runs once more with the opposite pre-verification setting,
+ * so the inlier ratio of the robust estimation and the time is reported with and without the Hough voting.
+ *
+ * '--compare-threads' checks the deterministic mode instead: the gray frames are recognized once with a single OpenCV thread and once
+ * with the given number of threads (0 for all cores), and the results of every frame (IDs, scores and sub-pixel corners) are compared.
+ *
+ * '--check-formats' checks the result images of a gray image buffer instead: color frames are added in gray mode and every result
+ * image has to arrive in the requested color format (RGB, BGRA and gray).
+ *
+ * Reports throughput and latency percentiles of adding a frame and of the result handler (copy of the result image, like the copy
+ * across the ABI) for both pipelines.
+ */
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * Number of images in the image buffer.
+ */
+static const int IMAGE_BUFFER = 4;
+
+/**
+ * Number of models in the catalog.
+ */
+static const int MODEL_COUNT = 8;
+
+/**
+ * A pipeline that makes no progress for this time is stopped (in milliseconds).
+ */
+static const long long STALL_TIMEOUT = 5000;
+
+/**
+ * Latency samples of one operation.
+ */
+class Latencies
+{
+    public:
+
+        /**
+         * Add a sample.
+         *
+         * @param start start of the operation
+         */
+        void add(Clock::time_point start)
+        {
+            double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->samples.push_back(milliseconds);
+        }
+
+        /**
+         * Print the number of samples and the latency percentiles.
+         *
+         * @param name  name of the operation
+         */
+        void print(const std::string& name)
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            std::sort(this->samples.begin(), this->samples.end());
+            std::cout << std::left << std::setw(24) << name << std::right << std::setw(10) << this->samples.size() << std::fixed << std::setprecision(3)
+                      << std::setw(12) << this->percentile(0.5) << std::setw(12) << this->percentile(0.99)
+                      << std::setw(12) << (this->samples.empty() ? 0.0 : this->samples.back()) << std::endl;
+        }
+
+    private:
+
+        /**
+         * Return a percentile of the sorted samples.
+         *
+         * @param rank  rank of the percentile (0 - 1)
+         * @return the percentile (in milliseconds)
+         */
+        double percentile(double rank) const
+        {
+            return this->samples.empty() ? 0.0 : this->samples[static_cast<size_t>(rank * (this->samples.size() - 1))];
+        }
+
+        /**
+         * Mutex of the samples.
+         */
+        std::mutex mutex;
+
+        /**
+         * Latency samples (in milliseconds).
+         */
+        std::vector<double> samples;
+};
+
+/**
+ * Frame format of a pipeline.
+ */
+enum class Pipeline
+{
+    COLOR, ///< Color frames in a color image buffer.
+    GRAY, ///< Gray frames in a gray image buffer.
+    CONVERTED ///< Color frames in a gray image buffer.
+};
+
+/**
+ * Verification settings of all pipelines.
+ */
+struct Settings
+{
+    /**
+     * Indicator to enable the Hough voting pre-verification.
+     */
+    bool houghVoting = false;
+
+    /**
+     * Number of bits of the compact descriptors (0 to match with the full descriptors).
+     */
+    int bits = 0;
+
+    /**
+     * Number of OpenCV threads that are compared with a single thread (-1 to benchmark the pipelines instead).
+     */
+    int compareThreads = -1;
+
+    /**
+     * Indicator to check the result color formats of a gray image buffer instead of benchmarking the pipelines.
+     */
+    bool checkFormats = false;
+};
+
+/**
+ * Recognition result of a frame that is compared between thread counts.
+ */
+struct FrameResult
+{
+    /**
+     * The ID of the model.
+     */
+    int id;
+
+    /**
+     * Recognition score (0% - 100%).
+     */
+    int score;
+
+    /**
+     * Sub-pixel model corners in the frame.
+     */
+    std::vector<cv::Point2f> corners;
+
+    /**
+     * Compare two results exactly.
+     *
+     * @param other result to compare with
+     * @return <code>true</code> if ID, score and corners are identical, <code>false</code> otherwise
+     */
+    bool operator==(const FrameResult& other) const
+    {
+        return (this->id == other.id) && (this->score == other.score) && (this->corners == other.corners);
+    }
+};
+
+/**
+ * Measurements of one pipeline.
+ */
+struct Measurement
+{
+    /**
+     * Number of processed frames.
+     */
+    long long frames = 0;
+
+    /**
+     * Time from the first added frame to the last result (in seconds).
+     */
+    double seconds = 0.0;
+
+    /**
+     * Latencies of adding a frame.
+     */
+    Latencies add;
+
+    /**
+     * Latencies of the result handler.
+     */
+    Latencies handler;
+
+    /**
+     * Work of all processed frames.
+     */
+    WorkStatistics work;
+
+    /**
+     * Counters of the geometric pre-verification.
+     */
+    PreVerificationStatistics preVerification;
+};
+
+/**
+ * Add the catalog to the native processing and apply the verification settings.
+ *
+ * @param recognition   native processing
+ * @param verification  feature verification of the processing
+ * @param settings      verification settings
+ * @param modelImage    gray model image
+ */
+static void addModels(MatchProcessing& recognition, FeatureVerification& verification, const Settings& settings, const cv::Mat& modelImage)
+{
+    for (int id = 0; id < MODEL_COUNT; id++)
+    {
+        recognition.addModel(id, modelImage, "");
+    }
+    verification.setHoughVoting(settings.houghVoting);
+    if (settings.bits > 0)
+    {
+        recognition.selectDescriptorBits(settings.bits, true);
+    }
+}
+
+/**
+ * Process the scenes with the native core.
+ *
+ * @param pipeline      frame format of the pipeline
+ * @param settings      verification settings
+ * @param frames        number of frames to process
+ * @param modelImage    gray model image
+ * @param scenePaths    paths of the scene images
+ * @param measurement   measurements of the pipeline
+ * @return <code>true</code> if all frames were processed, <code>false</code> if the pipeline stalled
+ */
+static bool runPipeline(Pipeline pipeline, const Settings& settings, long long frames, const cv::Mat& modelImage, const std::vector<std::string>& scenePaths,
+                        Measurement& measurement)
+{
+    // Scenes are decoded like a camera delivers them in the respective pipeline
+    std::vector<cv::Mat> scenes;
+    for (size_t i = 0; i < scenePaths.size(); i++)
+    {
+        scenes.push_back(cv::imread(scenePaths[i], (pipeline == Pipeline::GRAY) ? cv::IMREAD_GRAYSCALE : cv::IMREAD_COLOR));
+    }
+
+    // Native processing as it is assembled by the default 'FeatureMatching' and 'MatchRecognition' wrappers
+    cv::Ptr<cv::BRISK> detector = cv::BRISK::create(60);
+    cv::Ptr<cv::DescriptorMatcher> matcher = cv::DescriptorMatcher::create(cv::DescriptorMatcher::BRUTEFORCE_HAMMING);
+    FeatureVerification verification(detector, "BRISK/60/4", matcher, cv::DescriptorMatcher::BRUTEFORCE_HAMMING, 10, 40, 3.0, 500, cv::RANSAC);
+    MatchProcessing recognition(&verification, cv::Size(640, 360));
+    addModels(recognition, verification, settings, modelImage);
+
+    ImageBuffer stream(IMAGE_BUFFER);
+    stream.setGrayscale(pipeline != Pipeline::COLOR);
+    StreamGate gate;
+    std::atomic<long long> processed(0);
+    Clock::time_point last = Clock::now();
+    std::mutex lastMutex;
+
+    // The session passes gray result images (converted once in the color pipeline), the handler copies them like the wrapper
+    // copies them across the ABI
+    ProcessingSession session;
+    session.setProcessing(&recognition);
+    session.setSource(&stream, &gate);
+    session.setImageBuffer(IMAGE_BUFFER);
+    session.setResultHandler([&](std::vector<Companion::Model::Result::Result*>& results, cv::Mat& image,
+                                 const std::shared_ptr<const FrameWork>& work)
+    {
+        Clock::time_point start = Clock::now();
+        std::vector<uchar> data(image.datastart, image.dataend);
+        measurement.handler.add(start);
+        image.release();
+
+        std::lock_guard<std::mutex> lock(lastMutex);
+        last = Clock::now();
+        processed++;
+    }, Companion::ColorFormat::BGR, true);
+
+    WorkCounter::resetStatistics();
+    Clock::time_point start = Clock::now();
+    std::thread runner([&session]()
+    {
+        session.run();
+    });
+    std::thread producer([&]()
+    {
+        for (long long frame = 0; frame < frames; frame++)
+        {
+            const cv::Mat& scene = scenes[frame % scenes.size()];
+            Clock::time_point addStart = Clock::now();
+            if (!gate.enter())
+            {
+                return;
+            }
+            stream.addImage(scene.cols, scene.rows, scene.type(), scene.data);
+            gate.leave();
+            measurement.add.add(addStart);
+        }
+    });
+
+    // Wait for all frames (frames the native core skips don't reach the handler)
+    bool complete = false;
+    while (!complete)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::lock_guard<std::mutex> lock(lastMutex);
+        complete = (processed >= frames);
+        if (!complete && (std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - last).count() > STALL_TIMEOUT))
+        {
+            break;
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(lastMutex);
+        measurement.seconds = std::chrono::duration<double>(last - start).count();
+        measurement.frames = processed;
+    }
+
+    session.stop();
+    producer.join();
+    runner.join();
+    measurement.work = WorkCounter::getStatistics();
+    measurement.preVerification = verification.getPreVerificationStatistics();
+    return complete;
+}
+
+/**
+ * Recognize the gray scenes frame by frame in deterministic mode.
+ *
+ * @param settings      verification settings
+ * @param threads       number of OpenCV threads
+ * @param frames        number of frames to recognize
+ * @param modelImage    gray model image
+ * @param scenes        gray scene images
+ * @return results of every frame
+ */
+static std::vector<std::vector<FrameResult>> recognizeFrames(const Settings& settings, int threads, long long frames, const cv::Mat& modelImage,
+                                                             const std::vector<cv::Mat>& scenes)
+{
+    cv::Ptr<cv::BRISK> detector = cv::BRISK::create(60);
+    cv::Ptr<cv::DescriptorMatcher> matcher = cv::DescriptorMatcher::create(cv::DescriptorMatcher::BRUTEFORCE_HAMMING);
+    FeatureVerification verification(detector, "BRISK/60/4", matcher, cv::DescriptorMatcher::BRUTEFORCE_HAMMING, 10, 40, 3.0, 500, cv::RANSAC);
+    MatchProcessing recognition(&verification, cv::Size(640, 360));
+    addModels(recognition, verification, settings, modelImage);
+    recognition.setDeterministic(true);
+
+    cv::setNumThreads(threads);
+    std::vector<std::vector<FrameResult>> frameResults(static_cast<size_t>(frames));
+    for (long long frame = 0; frame < frames; frame++)
+    {
+        std::vector<Companion::Model::Result::Result*> results = recognition.execute(scenes[frame % scenes.size()].clone());
+        for (size_t i = 0; i < results.size(); i++)
+        {
+            std::unique_ptr<Companion::Model::Result::Result> result(results[i]);
+            PoseResult* pose = dynamic_cast<PoseResult*>(result.get());
+            if (pose != nullptr)
+            {
+                frameResults[frame].push_back(FrameResult{ pose->getId(), pose->getScoring(), pose->getCorners() });
+            }
+        }
+    }
+    return frameResults;
+}
+
+/**
+ * Compare the results of a single OpenCV thread with the results of multiple threads.
+ *
+ * @param settings      verification settings
+ * @param frames        number of frames to recognize
+ * @param modelImage    gray model image
+ * @param scenePaths    paths of the scene images
+ * @return <code>true</code> if all frames yield identical results, <code>false</code> otherwise
+ */
+static bool compareThreads(const Settings& settings, long long frames, const cv::Mat& modelImage, const std::vector<std::string>& scenePaths)
+{
+    std::vector<cv::Mat> scenes;
+    for (size_t i = 0; i < scenePaths.size(); i++)
+    {
+        scenes.push_back(cv::imread(scenePaths[i], cv::IMREAD_GRAYSCALE));
+    }
+
+    int defaultThreads = cv::getNumThreads();
+    int threads = (settings.compareThreads > 0) ? settings.compareThreads : cv::getNumberOfCPUs();
+    std::vector<std::vector<FrameResult>> single = recognizeFrames(settings, 1, frames, modelImage, scenes);
+    std::vector<std::vector<FrameResult>> multiple = recognizeFrames(settings, threads, frames, modelImage, scenes);
+    cv::setNumThreads(defaultThreads);
+
+    long long differences = 0;
+    long long recognized = 0;
+    for (size_t frame = 0; frame < single.size(); frame++)
+    {
+        recognized += static_cast<long long>(single[frame].size());
+        if (single[frame] == multiple[frame])
+        {
+            continue;
+        }
+
+        if (differences == 0)
+        {
+            std::cerr << "Frame " << frame << ": " << single[frame].size() << " results with 1 thread, " << multiple[frame].size()
+                      << " results with " << threads << " threads." << std::endl;
+            for (size_t i = 0; i < std::max(single[frame].size(), multiple[frame].size()); i++)
+            {
+                std::cerr << "  ";
+                if (i < single[frame].size())
+                {
+                    std::cerr << "model " << single[frame][i].id << " (" << single[frame][i].score << "%)";
+                }
+                std::cerr << " | ";
+                if (i < multiple[frame].size())
+                {
+                    std::cerr << "model " << multiple[frame][i].id << " (" << multiple[frame][i].score << "%)";
+                }
+                std::cerr << std::endl;
+            }
+        }
+        differences++;
+    }
+
+    std::cout << frames << " frames with 1 and " << threads << " threads: " << recognized << " results, " << differences
+              << " frames differ" << std::endl;
+    return (differences == 0);
+}
+
+/**
+ * Add color frames to a gray image buffer and check that the result images arrive in the requested color format.
+ *
+ * @param settings      verification settings
+ * @param frames        number of frames per color format
+ * @param modelImage    gray model image
+ * @param scenePaths    paths of the scene images
+ * @return <code>true</code> if all result images have the channels of their color format, <code>false</code> otherwise
+ */
+static bool checkFormats(const Settings& settings, long long frames, const cv::Mat& modelImage, const std::vector<std::string>& scenePaths)
+{
+    std::vector<cv::Mat> scenes;
+    for (size_t i = 0; i < scenePaths.size(); i++)
+    {
+        scenes.push_back(cv::imread(scenePaths[i], cv::IMREAD_COLOR));
+    }
+
+    cv::Ptr<cv::BRISK> detector = cv::BRISK::create(60);
+    cv::Ptr<cv::DescriptorMatcher> matcher = cv::DescriptorMatcher::create(cv::DescriptorMatcher::BRUTEFORCE_HAMMING);
+    FeatureVerification verification(detector, "BRISK/60/4", matcher, cv::DescriptorMatcher::BRUTEFORCE_HAMMING, 10, 40, 3.0, 500, cv::RANSAC);
+    MatchProcessing recognition(&verification, cv::Size(640, 360));
+    addModels(recognition, verification, settings, modelImage);
+
+    // Color formats as 'Configuration' passes them to the session, with the channels of their result images
+    const struct
+    {
+        const char* name;
+        Companion::ColorFormat colorFormat;
+        bool grayscale;
+        int channels;
+    } formats[] = { { "RGB", Companion::ColorFormat::RGB, false, 3 }, { "BGRA", Companion::ColorFormat::BGRA, false, 4 },
+                    { "GRAY", Companion::ColorFormat::BGR, true, 1 } };
+
+    bool passed = true;
+    for (const auto& format : formats)
+    {
+        ImageBuffer stream(IMAGE_BUFFER);
+        stream.setGrayscale(true);
+        StreamGate gate;
+        std::atomic<long long> processed(0);
+        std::atomic<long long> wrong(0);
+
+        ProcessingSession session;
+        session.setProcessing(&recognition);
+        session.setSource(&stream, &gate);
+        session.setImageBuffer(IMAGE_BUFFER);
+        session.setResultHandler([&](std::vector<Companion::Model::Result::Result*>& results, cv::Mat& image,
+                                     const std::shared_ptr<const FrameWork>& work)
+        {
+            if (image.channels() != format.channels)
+            {
+                wrong++;
+            }
+            image.release();
+            processed++;
+        }, format.colorFormat, format.grayscale);
+
+        std::thread runner([&session]()
+        {
+            session.run();
+        });
+        for (long long frame = 0; frame < frames; frame++)
+        {
+            const cv::Mat& scene = scenes[frame % scenes.size()];
+            if (gate.enter())
+            {
+                stream.addImage(scene.cols, scene.rows, scene.type(), scene.data);
+                gate.leave();
+            }
+        }
+
+        // Wait for all frames (frames the native core skips don't reach the handler)
+        long long last = 0;
+        Clock::time_point progress = Clock::now();
+        while ((processed < frames) && (std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - progress).count() <= STALL_TIMEOUT))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            if (processed > last)
+            {
+                last = processed;
+                progress = Clock::now();
+            }
+        }
+        session.stop();
+        runner.join();
+
+        std::cout << format.name << ": " << processed << " result images, " << wrong << " without " << format.channels << " channels" << std::endl;
+        passed = passed && (processed > 0) && (wrong == 0);
+    }
+
+    return passed;
+}
+
+/**
+ * Print the verification work of a pipeline.
+ *
+ * @param name          name of the pre-verification setting
+ * @param measurement   measurements of the pipeline
+ */
+static void printVerification(const std::string& name, const Measurement& measurement)
+{
+    const FrameWork& totals = measurement.work.totals;
+    double rate = (measurement.seconds > 0.0) ? measurement.frames / measurement.seconds : 0.0;
+    double ratio = (totals.filteredMatches > 0) ? static_cast<double>(totals.inliers) / totals.filteredMatches : 0.0;
+    double rawRatio = (totals.rawMatches > 0) ? static_cast<double>(totals.inliers) / totals.rawMatches : 0.0;
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(3) << std::setw(12) << rawRatio << std::setw(12) << ratio
+              << std::setw(12) << totals.ransacIterations << std::setw(12) << measurement.preVerification.rejectedModels << std::setw(12)
+              << measurement.preVerification.time << std::setprecision(2) << std::setw(12) << rate << std::endl;
+}
+
+/**
+ * Print the measurements of a pipeline.
+ *
+ * @param name          name of the pipeline
+ * @param measurement   measurements of the pipeline
+ */
+static void print(const std::string& name, Measurement& measurement)
+{
+    double rate = (measurement.seconds > 0.0) ? measurement.frames / measurement.seconds : 0.0;
+    std::cout << name << ": " << measurement.frames << " frames in " << std::fixed << std::setprecision(2) << measurement.seconds << " s ("
+              << rate << " frames per second)" << std::endl;
+    measurement.add.print("  addImage");
+    measurement.handler.print("  result handler");
+}
+
+int main(int argc, char* argv[])
+{
+    Settings settings;
+    int argument = 1;
+    for (; (argument < argc) && (std::string(argv[argument]).compare(0, 2, "--") == 0); argument++)
+    {
+        std::string option = argv[argument];
+        if (option == "--hough")
+        {
+            settings.houghVoting = true;
+        }
+        else if ((option == "--bits") && (argument + 1 < argc))
+        {
+            settings.bits = std::max(0, std::stoi(argv[++argument]));
+        }
+        else if ((option == "--compare-threads") && (argument + 1 < argc))
+        {
+            settings.compareThreads = std::max(0, std::stoi(argv[++argument]));
+        }
+        else if (option == "--check-formats")
+        {
+            settings.checkFormats = true;
+        }
+        else
+        {
+            std::cerr << "Unknown option '" << option << "'." << std::endl;
+            return 1;
+        }
+    }
+
+    if (argc - argument < 3)
+    {
+        std::cerr << "Usage: PipelineBenchmark [--hough] [--bits <bits>] [--compare-threads <threads>] [--check-formats] <frames> <model image> <scene image> [<scene image> ...]" << std::endl;
+        return 1;
+    }
+
+    long long frames = std::max(1LL, std::stoll(argv[argument]));
+    cv::Mat modelImage = cv::imread(argv[argument + 1], cv::IMREAD_GRAYSCALE);
+    if (modelImage.empty())
+    {
+        std::cerr << "Could not read '" << argv[argument + 1] << "'." << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> scenePaths;
+    for (int i = argument + 2; i < argc; i++)
+    {
+        if (cv::imread(argv[i], cv::IMREAD_COLOR).empty())
+        {
+            std::cerr << "Could not read '" << argv[i] << "'." << std::endl;
+            return 1;
+        }
+        scenePaths.push_back(argv[i]);
+    }
+
+    if (settings.compareThreads >= 0)
+    {
+        return compareThreads(settings, frames, modelImage, scenePaths) ? 0 : 3;
+    }
+    if (settings.checkFormats)
+    {
+        return checkFormats(settings, frames, modelImage, scenePaths) ? 0 : 3;
+    }
+
+    Measurement color;
+    Measurement gray;
+    Measurement converted;
+    bool complete = runPipeline(Pipeline::COLOR, settings, frames, modelImage, scenePaths, color);
+    complete = runPipeline(Pipeline::GRAY, settings, frames, modelImage, scenePaths, gray) && complete;
+    complete = runPipeline(Pipeline::CONVERTED, settings, frames, modelImage, scenePaths, converted) && complete;
+
+    // The same gray frames with the opposite pre-verification setting
+    Settings toggled = settings;
+    toggled.houghVoting = !settings.houghVoting;
+    Measurement grayToggled;
+    complete = runPipeline(Pipeline::GRAY, toggled, frames, modelImage, scenePaths, grayToggled) && complete;
+
+    std::cout << std::left << std::setw(24) << "Operation" << std::right << std::setw(10) << "Count" << std::setw(12) << "p50 [ms]"
+              << std::setw(12) << "p99 [ms]" << std::setw(12) << "max [ms]" << std::endl;
+    print("Color pipeline", color);
+    print("Gray pipeline", gray);
+    print("Converted pipeline", converted);
+    if ((color.seconds > 0.0) && (gray.seconds > 0.0))
+    {
+        double speedup = (gray.frames / gray.seconds) / (color.frames / color.seconds);
+        std::cout << "Gray speedup:   " << std::setprecision(3) << speedup << "x" << std::endl;
+    }
+
+    // Inlier ratios of all matches and of the matches passed to the robust estimation
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(24) << "Pre-verification" << std::right << std::setw(12) << "raw ratio" << std::setw(12) << "RANSAC ratio"
+              << std::setw(12) << "iterations" << std::setw(12) << "rejected" << std::setw(12) << "time [ms]" << std::setw(12) << "frames/s" << std::endl;
+    printVerification("  none", settings.houghVoting ? grayToggled : gray);
+    printVerification("  Hough voting", settings.houghVoting ? gray : grayToggled);
+
+    if (!complete)
+    {
+        std::cerr << "A pipeline stalled before all frames were processed." << std::endl;
+        return 2;
+    }
+    return 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <cstring>
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+
+#include "ResultSubscriber.h"
+
+using namespace CompanionWinRT;
+
+ResultSubscriber::ResultSubscriber(const std::wstring& name) : mapping(nullptr), header(nullptr), slots(nullptr), next(0), dropped(0)
+{
+    this->mapping = OpenFileMappingW(FILE_MAP_READ, FALSE, name.c_str());
+    if (this->mapping == nullptr)
+    {
+        return;
+    }
+
+    // Map the header first to learn the ring size
+    Native::ResultRingHeader* ring = static_cast<Native::ResultRingHeader*>(MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, sizeof(Native::ResultRingHeader)));
+    bool valid = (ring != nullptr) && (ring->magic == Native::RESULT_RING_MAGIC) && (ring->version == Native::RESULT_RING_VERSION)
+                 && (ring->slotSize == sizeof(Native::ResultSlot));
+    uint32_t capacity = valid ? ring->capacity : 0;
+    if (ring != nullptr)
+    {
+        UnmapViewOfFile(ring);
+    }
+    if (!valid)
+    {
+        CloseHandle(this->mapping);
+        this->mapping = nullptr;
+        return;
+    }
+
+    void* view = MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, Native::getResultRingSize(capacity));
+    if (view == nullptr)
+    {
+        CloseHandle(this->mapping);
+        this->mapping = nullptr;
+        return;
+    }
+
+    this->header = static_cast<Native::ResultRingHeader*>(view);
+    this->slots = reinterpret_cast<Native::ResultSlot*>(static_cast<uint8_t*>(view) + sizeof(Native::ResultRingHeader));
+    this->next = this->header->published.load(std::memory_order_acquire);
+}
+
+ResultSubscriber::~ResultSubscriber()
+{
+    if (this->header != nullptr)
+    {
+        UnmapViewOfFile(this->header);
+        this->header = nullptr;
+        this->slots = nullptr;
+    }
+    if (this->mapping != nullptr)
+    {
+        CloseHandle(this->mapping);
+        this->mapping = nullptr;
+    }
+}
+
+bool ResultSubscriber::isOpen() const
+{
+    return this->header != nullptr;
+}
+
+bool ResultSubscriber::read(Native::ResultRecord& record)
+{
+    if (this->header == nullptr)
+    {
+        return false;
+    }
+
+    uint32_t capacity = this->header->capacity;
+    while (true)
+    {
+        uint64_t published = this->header->published.load(std::memory_order_acquire);
+        if (this->next >= published)
+        {
+            return false;
+        }
+
+        // Skip records that were already overwritten
+        if (published - this->next > capacity)
+        {
+            this->dropped += published - capacity - this->next;
+            this->next = published - capacity;
+        }
+
+        const Native::ResultSlot& slot = this->slots[this->next % capacity];
+        uint64_t before = slot.sequence.load(std::memory_order_acquire);
+        if (before == this->next + 1)
+        {
+            std::memcpy(&record, &slot.record, sizeof(Native::ResultRecord));
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (slot.sequence.load(std::memory_order_relaxed) == before)
+            {
+                this->next++;
+                return true;
+            }
+        }
+
+        // The record was overwritten while it was read
+        this->dropped++;
+        this->next++;
+    }
+}
+
+uint64_t ResultSubscriber::getDropped() const
+{
+    return this->dropped;
+}
+
+uint64_t ResultSubscriber::getTruncated() const
+{
+    return (this->header != nullptr) ? this->header->truncated.load() : 0;
+}
@@ -0,0 +1,107 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <string>
+
+#include "CompanionWinRT/native/ResultSchema.h"
+
+namespace CompanionWinRT
+{
+    /**
+     * This class reads the results published by a 'Configuration' with an enabled result publisher from another local process.
+     *
+     * The subscriber reads the shared memory ring without affecting the publisher. Records that were overwritten before they could
+     * be read are skipped and counted as dropped.
+     *
+     * @author Dimitri Kotlovsky, Andreas Sekulski
+     */
+    class ResultSubscriber
+    {
+        public:
+
+            /**
+             * Create a 'ResultSubscriber' object. Only records published after the subscriber was opened are read.
+             *
+             * @param name  name of the shared memory ring (the app container's named object path for rings of a packaged app)
+             */
+            ResultSubscriber(const std::wstring& name);
+
+            /**
+             * Destruct this instance.
+             */
+            ~ResultSubscriber();
+
+            /**
+             * Check whether the shared memory ring was opened.
+             *
+             * @return <code>true</code> if results can be read, <code>false</code> otherwise
+             */
+            bool isOpen() const;
+
+            /**
+             * Read the next record without waiting.
+             *
+             * @param record    the next record
+             * @return <code>true</code> if a record was read, <code>false</code> if no new record is available
+             */
+            bool read(Native::ResultRecord& record);
+
+            /**
+             * Return the number of records that were overwritten before they could be read.
+             *
+             * @return number of dropped records
+             */
+            uint64_t getDropped() const;
+
+            /**
+             * Return the number of results the publisher dropped because a frame had too many results.
+             *
+             * @return number of truncated results
+             */
+            uint64_t getTruncated() const;
+
+        private:
+
+            /**
+             * Handle of the shared memory mapping (a Windows 'HANDLE').
+             */
+            void* mapping;
+
+            /**
+             * Mapped ring header.
+             */
+            Native::ResultRingHeader* header;
+
+            /**
+             * Mapped ring slots.
+             */
+            Native::ResultSlot* slots;
+
+            /**
+             * Number of the next record to read.
+             */
+            uint64_t next;
+
+            /**
+             * Number of dropped records.
+             */
+            uint64_t dropped;
+    };
+}
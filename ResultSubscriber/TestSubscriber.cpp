@@ -0,0 +1,64 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "ResultSubscriber.h"
+
+/**
+ * Local test subscriber that prints all published results.
+ *
+ * Usage: TestSubscriber <ring name>
+ */
+int wmain(int argc, wchar_t* argv[])
+{
+    if (argc < 2)
+    {
+        std::wcerr << L"Usage: TestSubscriber <ring name>" << std::endl;
+        return 1;
+    }
+
+    CompanionWinRT::ResultSubscriber subscriber(argv[1]);
+    if (!subscriber.isOpen())
+    {
+        std::wcerr << L"Could not open the result ring '" << argv[1] << L"'." << std::endl;
+        return 1;
+    }
+
+    CompanionWinRT::Native::ResultRecord record;
+    while (true)
+    {
+        if (!subscriber.read(record))
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            continue;
+        }
+
+        std::cout << "Record " << record.number << " (" << record.timestamp << " ms): " << record.count << " results, "
+                  << subscriber.getDropped() << " dropped records, " << subscriber.getTruncated() << " truncated results" << std::endl;
+        for (uint16_t i = 0; i < record.count; i++)
+        {
+            const CompanionWinRT::Native::ResultEntry& entry = record.results[i];
+            std::cout << "  ID " << entry.id << ", score " << entry.score << ", upper left (" << entry.corners[0] << ", " << entry.corners[1] << ")" << std::endl;
+        }
+    }
+
+    return 0;
+}
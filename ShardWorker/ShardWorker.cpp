@@ -0,0 +1,466 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <opencv2/calib3d/calib3d.hpp>
+#include <opencv2/core/utility.hpp>
+#include <opencv2/features2d/features2d.hpp>
+#include <opencv2/imgcodecs/imgcodecs.hpp>
+
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+
+#include "CompanionWinRT/native/FeatureVerification.h"
+#include "CompanionWinRT/native/ShardProtocol.h"
+
+using namespace CompanionWinRT::Native;
+
+/**
+ * Local shard process of a 'ShardedRecognition'. It loads its part of a model catalog and verifies the models against the scene
+ * features of every query.
+ *
+ * Usage: ShardWorker <port> <shard> <shards> <brisk|orb> <thresh|nfeatures> <catalog> [options]
+ *
+ * Options:
+ *   --levels <model> <scene>                               pyramid levels (see 'FeatureMatching::setPyramidLevels')
+ *   --upright                                              upright mode (ORB only)
+ *   --hough                                                Hough voting pre-verification
+ *   --matcher <FlannBased|BruteForce|BruteForce-L1|BruteForce-Hamming|BruteForce-Hamming(2)|BruteForce-SL2>
+ *                                                          descriptor matcher (default BruteForce-Hamming)
+ *   --verification <minSide> <matches> <reproj> <iters> <ransac|lmeds|rho>
+ *                                                          verification parameters (default 10 40 3.0 500 ransac)
+ *
+ * The catalog is a text file with one model per line ("<id> <image path>"). Shard i of n loads every line with index % n == i, so
+ * all shards can be started with the same catalog. The detector, matcher and verification settings have to match the
+ * 'FeatureMatching' of the coordinator, queries with other settings are answered with 'SHARD_STATUS_MISMATCH'. Every client is served on its own thread.
+ */
+
+/**
+ * A model of this shard.
+ */
+struct ShardModel
+{
+    /**
+     * The ID of the model.
+     */
+    int id;
+
+    /**
+     * Model features.
+     */
+    Features features;
+};
+
+/**
+ * Send all bytes.
+ *
+ * @param client    client socket
+ * @param data      bytes to send
+ * @param size      number of bytes
+ * @return <code>true</code> if all bytes were sent, <code>false</code> if the client disconnected
+ */
+static bool sendAll(SOCKET client, const char* data, size_t size)
+{
+    while (size > 0)
+    {
+        int count = send(client, data, static_cast<int>(size), 0);
+        if (count == SOCKET_ERROR)
+        {
+            return false;
+        }
+        data += count;
+        size -= count;
+    }
+    return true;
+}
+
+/**
+ * Read exactly the given number of bytes.
+ *
+ * @param client    client socket
+ * @param data      destination of the bytes
+ * @param size      number of bytes
+ * @return <code>true</code> if all bytes were read, <code>false</code> if the client disconnected
+ */
+static bool readExact(SOCKET client, char* data, size_t size)
+{
+    while (size > 0)
+    {
+        int count = recv(client, data, static_cast<int>(size), 0);
+        if (count <= 0)
+        {
+            return false;
+        }
+        data += count;
+        size -= count;
+    }
+    return true;
+}
+
+/**
+ * Verify all models of this shard against the scene and return the best candidates.
+ *
+ * @param verification  feature verification of this shard
+ * @param models        models of this shard
+ * @param scene         scene features of the query
+ * @param maxCandidates maximum number of candidates
+ * @param response      response header that receives the work counters of all verifications
+ * @return best candidates in descending order of their score (ties by model ID)
+ */
+static std::vector<ShardCandidate> verify(FeatureVerification& verification, const std::vector<ShardModel>& models, const Features& scene, size_t maxCandidates,
+                                          ShardResponseHeader& response)
+{
+    std::vector<Verification> verifications(models.size());
+    std::vector<char> found(models.size(), 0);
+    cv::parallel_for_(cv::Range(0, static_cast<int>(models.size())), [&](const cv::Range& range)
+    {
+        for (int i = range.start; i < range.end; i++)
+        {
+            found[i] = verification.verify(models[i].features, scene, verifications[i]) ? 1 : 0;
+        }
+    });
+
+    std::vector<ShardCandidate> candidates;
+    for (size_t i = 0; i < models.size(); i++)
+    {
+        response.verifiedModels++;
+        response.descriptorsMatched += verifications[i].descriptorsMatched;
+        response.rawMatches += verifications[i].rawMatches;
+        response.filteredMatches += verifications[i].filteredMatches;
+        response.ransacIterations += verifications[i].ransacIterations;
+        response.inliers += verifications[i].inliers;
+
+        if (!found[i])
+        {
+            continue;
+        }
+
+        ShardCandidate candidate = {};
+        candidate.id = models[i].id;
+        candidate.score = static_cast<int16_t>(verifications[i].score);
+        cv::Matx33d homography(verifications[i].homography);
+        std::copy(homography.val, homography.val + 9, candidate.homography);
+        for (size_t j = 0; (j < verifications[i].corners.size()) && (j < 4); j++)
+        {
+            candidate.corners[j * 2] = verifications[i].corners[j].x;
+            candidate.corners[j * 2 + 1] = verifications[i].corners[j].y;
+        }
+        candidates.push_back(candidate);
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const ShardCandidate& a, const ShardCandidate& b)
+    {
+        if (a.score != b.score)
+        {
+            return a.score > b.score;
+        }
+        return a.id < b.id;
+    });
+    if (candidates.size() > maxCandidates)
+    {
+        candidates.resize(maxCandidates);
+    }
+
+    return candidates;
+}
+
+/**
+ * Check whether a query was extracted and should be matched and verified with the settings of this shard.
+ *
+ * @param header        query header
+ * @param verification  feature verification of this shard
+ * @return <code>true</code> if the settings match, <code>false</code> otherwise
+ */
+static bool isMatching(const ShardQueryHeader& header, const FeatureVerification& verification)
+{
+    std::string detectorKey(header.detectorKey, strnlen(header.detectorKey, SHARD_DETECTOR_KEY_SIZE));
+    VerificationParameters parameters = verification.getParameters();
+    return (detectorKey == verification.getDetectorKey()) && (header.matcherType == parameters.matcherType) && (header.minSideLength == parameters.minSideLength)
+        && (header.countMatches == parameters.countMatches) && (header.reprojThreshold == parameters.reprojThreshold)
+        && (header.ransacMaxIters == parameters.ransacMaxIters) && (header.findHomographyMethod == parameters.findHomographyMethod)
+        && (header.modelLevels == parameters.modelLevels) && ((header.houghVoting != 0) == parameters.houghVoting);
+}
+
+/**
+ * Answer the queries of a client until it disconnects.
+ *
+ * @param client        client socket
+ * @param verification  feature verification of this shard
+ * @param models        models of this shard
+ */
+static void serve(SOCKET client, FeatureVerification* verification, const std::vector<ShardModel>* models)
+{
+    BOOL noDelay = TRUE;
+    setsockopt(client, IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+
+    int modelType = models->empty() ? -1 : (*models)[0].features.descriptors.type();
+    size_t modelBytes = models->empty() ? 0 : (*models)[0].features.descriptors.cols * (*models)[0].features.descriptors.elemSize();
+
+    ShardQueryHeader header;
+    while (readExact(client, reinterpret_cast<char*>(&header), sizeof(header)))
+    {
+        if ((header.magic != SHARD_QUERY_MAGIC) || (header.keypointCount > MAX_SHARD_KEYPOINTS) || (header.descriptorBytes > MAX_SHARD_DESCRIPTOR_BYTES))
+        {
+            std::cerr << "Invalid query, disconnecting the client." << std::endl;
+            break;
+        }
+
+        std::vector<ShardKeypoint> keypoints(header.keypointCount);
+        std::vector<uint8_t> descriptors(static_cast<size_t>(header.keypointCount) * header.descriptorBytes);
+        if (!readExact(client, reinterpret_cast<char*>(keypoints.data()), keypoints.size() * sizeof(ShardKeypoint))
+            || !readExact(client, reinterpret_cast<char*>(descriptors.data()), descriptors.size()))
+        {
+            break;
+        }
+
+        // Scenes of another detector or verification settings can't be matched against the models of this shard
+        ShardResponseHeader response = {};
+        response.magic = SHARD_RESPONSE_MAGIC;
+        response.frame = header.frame;
+        response.status = SHARD_STATUS_OK;
+        std::vector<ShardCandidate> candidates;
+        if (!isMatching(header, *verification) || (!models->empty() && (header.keypointCount > 0)
+            && ((header.descriptorType != modelType) || (header.descriptorBytes != modelBytes))))
+        {
+            std::cerr << "Query " << header.frame << " doesn't match the detector or verification settings of this shard." << std::endl;
+            response.status = SHARD_STATUS_MISMATCH;
+        }
+        else if ((header.keypointCount > 0) && !models->empty())
+        {
+            Features scene;
+            scene.size = cv::Size(header.width, header.height);
+            for (size_t i = 0; i < keypoints.size(); i++)
+            {
+                const ShardKeypoint& keypoint = keypoints[i];
+                scene.keypoints.push_back(cv::KeyPoint(keypoint.x, keypoint.y, keypoint.size, keypoint.angle, keypoint.response, keypoint.octave));
+            }
+            cv::Mat(static_cast<int>(header.keypointCount), static_cast<int>(modelBytes / CV_ELEM_SIZE(modelType)), modelType, descriptors.data()).copyTo(scene.descriptors);
+
+            candidates = verify(*verification, *models, scene, std::min<size_t>(header.maxCandidates, MAX_SHARD_CANDIDATES), response);
+        }
+
+        response.count = static_cast<uint16_t>(candidates.size());
+        if (!sendAll(client, reinterpret_cast<const char*>(&response), sizeof(response))
+            || !sendAll(client, reinterpret_cast<const char*>(candidates.data()), candidates.size() * sizeof(ShardCandidate)))
+        {
+            break;
+        }
+    }
+
+    closesocket(client);
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 7)
+    {
+        std::cerr << "Usage: ShardWorker <port> <shard> <shards> <brisk|orb> <thresh|nfeatures> <catalog> [--levels <model> <scene>] [--upright] [--hough]"
+                  << " [--matcher <FlannBased|BruteForce|BruteForce-L1|BruteForce-Hamming|BruteForce-Hamming(2)|BruteForce-SL2>] [--verification <minSide> <matches> <reproj> <iters> <ransac|lmeds|rho>]" << std::endl;
+        return 1;
+    }
+
+    int port = std::stoi(argv[1]);
+    int shard = std::stoi(argv[2]);
+    int shards = std::stoi(argv[3]);
+    std::string detectorType = argv[4];
+    int parameter = std::stoi(argv[5]);
+    if ((shards < 1) || (shard < 0) || (shard >= shards))
+    {
+        std::cerr << "The shard has to be in the range 0 - " << (shards - 1) << "." << std::endl;
+        return 1;
+    }
+
+    // Defaults of 'FeatureMatching', the options mirror its settings
+    int modelLevels = 0;
+    int sceneLevels = 0;
+    bool upright = false;
+    bool houghVoting = false;
+    int matcherType = cv::DescriptorMatcher::BRUTEFORCE_HAMMING;
+    int minSideLength = 10;
+    int countMatches = 40;
+    double reprojThreshold = 3.0;
+    int ransacMaxIters = 500;
+    int findHomographyMethod = cv::RANSAC;
+    for (int i = 7; i < argc; i++)
+    {
+        std::string option = argv[i];
+        if ((option == "--levels") && (i + 2 < argc))
+        {
+            modelLevels = std::stoi(argv[++i]);
+            sceneLevels = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (option == "--upright")
+        {
+            upright = true;
+        }
+        else if (option == "--hough")
+        {
+            houghVoting = true;
+        }
+        else if ((option == "--matcher") && (i + 1 < argc))
+        {
+            // Names of 'cv::DescriptorMatcher::create', sent as 'DescriptorMatcherType' by the coordinator
+            std::string matcher = argv[++i];
+            const std::pair<const char*, int> matchers[] = { { "FlannBased", cv::DescriptorMatcher::FLANNBASED },
+                                                             { "BruteForce", cv::DescriptorMatcher::BRUTEFORCE },
+                                                             { "BruteForce-L1", cv::DescriptorMatcher::BRUTEFORCE_L1 },
+                                                             { "BruteForce-Hamming", cv::DescriptorMatcher::BRUTEFORCE_HAMMING },
+                                                             { "BruteForce-Hamming(2)", cv::DescriptorMatcher::BRUTEFORCE_HAMMINGLUT },
+                                                             { "BruteForce-SL2", cv::DescriptorMatcher::BRUTEFORCE_SL2 } };
+            auto entry = std::find_if(std::begin(matchers), std::end(matchers), [&](const std::pair<const char*, int>& known) { return matcher == known.first; });
+            if (entry == std::end(matchers))
+            {
+                std::cerr << "Unknown descriptor matcher '" << matcher << "'." << std::endl;
+                return 1;
+            }
+            matcherType = entry->second;
+        }
+        else if ((option == "--verification") && (i + 5 < argc))
+        {
+            minSideLength = std::stoi(argv[++i]);
+            countMatches = std::stoi(argv[++i]);
+            reprojThreshold = std::stod(argv[++i]);
+            ransacMaxIters = std::stoi(argv[++i]);
+            std::string method = argv[++i];
+            findHomographyMethod = (method == "lmeds") ? cv::LMEDS : ((method == "rho") ? cv::RHO : cv::RANSAC);
+        }
+        else
+        {
+            std::cerr << "Unknown option '" << option << "'." << std::endl;
+            return 1;
+        }
+    }
+
+    // Same detector, detector key and pyramid as 'FeatureMatching' (and its 'setPyramidLevels')
+    cv::Ptr<cv::Feature2D> detector;
+    std::string detectorKey;
+    if (detectorType == "brisk")
+    {
+        detector = (sceneLevels > 0) ? cv::BRISK::create(parameter, sceneLevels - 1) : cv::BRISK::create(parameter);
+        detectorKey = "BRISK/" + std::to_string(parameter) + "/" + std::to_string((sceneLevels > 0) ? sceneLevels : 4);
+    }
+    else if (detectorType == "orb")
+    {
+        detector = (sceneLevels > 0) ? cv::ORB::create(parameter, 1.2f, sceneLevels) : cv::ORB::create(parameter);
+        detectorKey = "ORB/" + std::to_string(parameter) + "/" + std::to_string((sceneLevels > 0) ? sceneLevels : 8);
+    }
+    else
+    {
+        std::cerr << "Unknown detector '" << detectorType << "' (brisk or orb)." << std::endl;
+        return 1;
+    }
+    if (upright && (detectorType != "orb"))
+    {
+        std::cerr << "The upright mode needs the ORB detector." << std::endl;
+        return 1;
+    }
+
+    FeatureVerification verification(detector, detectorKey, cv::DescriptorMatcher::create(matcherType), matcherType, minSideLength, countMatches,
+                                     reprojThreshold, ransacMaxIters, findHomographyMethod);
+    if (sceneLevels > 0)
+    {
+        verification.setPyramid(detector, detectorKey, modelLevels, (detectorType == "brisk") ? std::sqrt(2.0) : 1.2);
+    }
+    verification.setUpright(upright);
+    verification.setHoughVoting(houghVoting);
+    if (verification.getDetectorKey().size() >= SHARD_DETECTOR_KEY_SIZE)
+    {
+        std::cerr << "The detector key '" << verification.getDetectorKey() << "' doesn't fit into a shard query." << std::endl;
+        return 1;
+    }
+
+    // Load this shard's part of the catalog
+    std::ifstream catalog(argv[6]);
+    if (!catalog)
+    {
+        std::cerr << "Could not read '" << argv[6] << "'." << std::endl;
+        return 1;
+    }
+
+    std::vector<ShardModel> models;
+    std::string line;
+    for (int index = 0; std::getline(catalog, line); index++)
+    {
+        if ((index % shards) != shard)
+        {
+            continue;
+        }
+
+        std::istringstream entry(line);
+        ShardModel model;
+        std::string path;
+        if (!(entry >> model.id) || !std::getline(entry >> std::ws, path))
+        {
+            continue;
+        }
+
+        cv::Mat image = cv::imread(path, cv::IMREAD_GRAYSCALE);
+        if (image.empty())
+        {
+            std::cerr << "Could not read '" << path << "'." << std::endl;
+            return 1;
+        }
+        verification.extractModel(image, model.features);
+        models.push_back(model);
+    }
+
+    WSADATA wsaData;
+    WSAStartup(MAKEWORD(2, 2), &wsaData);
+
+    SOCKET server = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    address.sin_port = htons(static_cast<u_short>(port));
+    if ((server == INVALID_SOCKET) || (bind(server, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == SOCKET_ERROR)
+        || (listen(server, SOMAXCONN) == SOCKET_ERROR))
+    {
+        std::cerr << "Could not listen on port " << port << "." << std::endl;
+        WSACleanup();
+        return 1;
+    }
+
+    std::cout << "Shard " << shard << "/" << shards << ": serving " << models.size() << " models on 127.0.0.1:" << port << std::endl;
+    while (true)
+    {
+        SOCKET client = accept(server, nullptr, nullptr);
+        if (client == INVALID_SOCKET)
+        {
+            break;
+        }
+        std::thread(serve, client, &verification, &models).detach();
+    }
+
+    closesocket(server);
+    WSACleanup();
+    return 0;
+}
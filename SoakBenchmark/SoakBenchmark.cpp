@@ -0,0 +1,491 @@
+/*
+ * CompanionWinRT is a Windows Runtime wrapper for Companion.
+ * Copyright (C) 2017-2018 Dimitri Kotlovsky, Andreas Sekulski
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/calib3d.hpp>
+#include <opencv2/features2d.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/imgproc.hpp>
+#include <companion/algo/detection/ShapeDetection.h>
+#include <companion/algo/recognition/hashing/LSH.h>
+#include <companion/processing/recognition/HashRecognition.h>
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#include <unistd.h>
+#endif
+
+#include "CompanionWinRT/native/FeatureVerification.h"
+#include "CompanionWinRT/native/HybridProcessing.h"
+#include "CompanionWinRT/native/ImageBuffer.h"
+#include "CompanionWinRT/native/MatchProcessing.h"
+#include "CompanionWinRT/native/MemoryAccount.h"
+#include "CompanionWinRT/native/ProcessingSession.h"
+#include "CompanionWinRT/native/StreamGate.h"
+
+using namespace CompanionWinRT::Native;
+
+/**
+ * Long running stress benchmark of the processing life cycle. Several producers add images as fast as possible, while the
+ * processing is started and stopped at random intervals and models and result handlers are replaced during the processing.
+ *
+ * Usage: SoakBenchmark <seconds> <producers> <match|hybrid> <model image> <scene image> [<scene image> ...]
+ *
+ * The benchmark runs the native processing of the wrapper ('MatchProcessing' or 'HybridProcessing') in a 'ProcessingSession' on an
+ * 'ImageBuffer', the same objects 'Configuration', 'ImageStream' and the recognition wrappers assemble. In match mode the models are
+ * removed and added again, in hybrid mode (where models can't be removed from the hash recognition) the active tags are switched.
+ *
+ * Reports throughput, resident memory, the accounted memory per component ('MemoryAccount') and latency percentiles of 'addImage',
+ * 'stop' and the result interval. A call that doesn't return within
+ * the hang timeout is reported as a hang (exit code 2). Build with -DSOAK_TSAN=ON to run it under ThreadSanitizer.
+ */
+
+using Clock = std::chrono::steady_clock;
+
+/**
+ * A call that takes longer is reported as a hang (in milliseconds).
+ */
+static const long long HANG_TIMEOUT = 5000;
+
+/**
+ * Number of images in the image buffer.
+ */
+static const int IMAGE_BUFFER = 4;
+
+/**
+ * Number of model IDs the mutator cycles through.
+ */
+static const int MODEL_SLOTS = 8;
+
+/**
+ * Return the current and peak resident memory of this process (the working set on Windows).
+ *
+ * @param current   current resident memory (in bytes, 0 if unknown)
+ * @param peak      peak resident memory (in bytes, 0 if unknown)
+ */
+static void getResidentMemory(long long& current, long long& peak)
+{
+    current = 0;
+    peak = 0;
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+    {
+        current = static_cast<long long>(counters.WorkingSetSize);
+        peak = static_cast<long long>(counters.PeakWorkingSetSize);
+    }
+#else
+    long long size, resident;
+    std::ifstream statm("/proc/self/statm");
+    if (statm >> size >> resident)
+    {
+        current = resident * sysconf(_SC_PAGESIZE);
+    }
+
+    // The maximum resident set size is reported in kilobytes on Linux
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) == 0)
+    {
+        peak = static_cast<long long>(usage.ru_maxrss) * 1024;
+    }
+#endif
+}
+
+/**
+ * Print the current and peak bytes of all memory components.
+ */
+static void printMemoryAccounts()
+{
+    const char* names[] = { "stream buffers", "model images", "descriptors", "indexes", "scratch", "result buffers" };
+    std::cout << std::left << std::setw(16) << "Component" << std::right << std::setw(14) << "current [MB]" << std::setw(14) << "peak [MB]" << std::endl;
+    for (int i = 0; i < static_cast<int>(MemoryComponent::COUNT); i++)
+    {
+        MemoryAccount& account = MemoryAccount::get(static_cast<MemoryComponent>(i));
+        std::cout << std::left << std::setw(16) << names[i] << std::right << std::fixed << std::setprecision(3) << std::setw(14)
+                  << (account.getCurrent() / (1024.0 * 1024.0)) << std::setw(14) << (account.getPeak() / (1024.0 * 1024.0)) << std::endl;
+    }
+}
+
+/**
+ * Latency samples of one operation.
+ */
+class Latencies
+{
+    public:
+
+        /**
+         * Add a sample.
+         *
+         * @param start start of the operation
+         */
+        void add(Clock::time_point start)
+        {
+            double milliseconds = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+            std::lock_guard<std::mutex> lock(this->mutex);
+            this->samples.push_back(milliseconds);
+        }
+
+        /**
+         * Return the number of samples.
+         *
+         * @return number of samples
+         */
+        size_t count()
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            return this->samples.size();
+        }
+
+        /**
+         * Print the number of samples and the latency percentiles.
+         *
+         * @param name  name of the operation
+         */
+        void print(const std::string& name)
+        {
+            std::lock_guard<std::mutex> lock(this->mutex);
+            std::sort(this->samples.begin(), this->samples.end());
+            std::cout << std::left << std::setw(16) << name << std::right << std::setw(10) << this->samples.size() << std::fixed << std::setprecision(3)
+                      << std::setw(12) << this->percentile(0.5) << std::setw(12) << this->percentile(0.99) << std::setw(12) << this->percentile(0.999)
+                      << std::setw(12) << (this->samples.empty() ? 0.0 : this->samples.back()) << std::endl;
+        }
+
+    private:
+
+        /**
+         * Return a percentile of the sorted samples.
+         *
+         * @param rank  rank of the percentile (0 - 1)
+         * @return the percentile (in milliseconds)
+         */
+        double percentile(double rank) const
+        {
+            return this->samples.empty() ? 0.0 : this->samples[static_cast<size_t>(rank * (this->samples.size() - 1))];
+        }
+
+        /**
+         * Mutex of the samples.
+         */
+        std::mutex mutex;
+
+        /**
+         * Latency samples (in milliseconds).
+         */
+        std::vector<double> samples;
+};
+
+/**
+ * Watch of a call that may hang.
+ */
+struct Watch
+{
+    /**
+     * Name of the watched call.
+     */
+    std::string name;
+
+    /**
+     * Start of the current call (in milliseconds since the epoch of the clock, 0 if outside the call).
+     */
+    std::atomic<long long> since{ 0 };
+
+    /**
+     * Enter the watched call.
+     */
+    void enter()
+    {
+        this->since = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * Leave the watched call.
+     */
+    void leave()
+    {
+        this->since = 0;
+    }
+};
+
+int main(int argc, char* argv[])
+{
+    if (argc < 6)
+    {
+        std::cerr << "Usage: SoakBenchmark <seconds> <producers> <match|hybrid> <model image> <scene image> [<scene image> ...]" << std::endl;
+        return 1;
+    }
+
+    int seconds = std::max(1, std::stoi(argv[1]));
+    int producerCount = std::max(1, std::stoi(argv[2]));
+    std::string mode = argv[3];
+    if ((mode != "match") && (mode != "hybrid"))
+    {
+        std::cerr << "Unknown mode '" << mode << "' (match or hybrid)." << std::endl;
+        return 1;
+    }
+
+    cv::Mat modelImage = cv::imread(argv[4], cv::IMREAD_GRAYSCALE);
+    std::vector<cv::Mat> scenes;
+    for (int i = 5; i < argc; i++)
+    {
+        scenes.push_back(cv::imread(argv[i], cv::IMREAD_COLOR));
+        if (scenes.back().empty())
+        {
+            std::cerr << "Could not read '" << argv[i] << "'." << std::endl;
+            return 1;
+        }
+    }
+    if (modelImage.empty())
+    {
+        std::cerr << "Could not read '" << argv[4] << "'." << std::endl;
+        return 1;
+    }
+
+    // Native processing as it is assembled by the default wrappers ('FeatureMatching', 'ShapeDetection', 'HashRecognition')
+    cv::Ptr<cv::BRISK> detector = cv::BRISK::create(60);
+    cv::Ptr<cv::DescriptorMatcher> matcher = cv::DescriptorMatcher::create(cv::DescriptorMatcher::BRUTEFORCE_HAMMING);
+    FeatureVerification verification(detector, "BRISK/60/4", matcher, cv::DescriptorMatcher::BRUTEFORCE_HAMMING, 10, 40, 3.0, 500, cv::RANSAC);
+
+    std::unique_ptr<Companion::Algorithm::Detection::ShapeDetection> shapeDetection;
+    std::unique_ptr<Companion::Algorithm::Recognition::Hashing::LSH> lsh;
+    std::unique_ptr<Companion::Processing::Recognition::HashRecognition> hashRecognition;
+    std::unique_ptr<RecognitionProcessing> recognition;
+    if (mode == "hybrid")
+    {
+        shapeDetection.reset(new Companion::Algorithm::Detection::ShapeDetection(4, 20, "Polygon", 50.0, 3, cv::getStructuringElement(cv::MORPH_RECT, cv::Size(30, 30)),
+                                                                                 cv::getStructuringElement(cv::MORPH_RECT, cv::Size(10, 10)),
+                                                                                 cv::getStructuringElement(cv::MORPH_RECT, cv::Size(40, 40))));
+        lsh.reset(new Companion::Algorithm::Recognition::Hashing::LSH());
+        hashRecognition.reset(new Companion::Processing::Recognition::HashRecognition(cv::Size(50, 70), shapeDetection.get(), lsh.get()));
+        recognition.reset(new HybridProcessing(hashRecognition.get(), &verification, 50));
+    }
+    else
+    {
+        recognition.reset(new MatchProcessing(&verification, cv::Size(640, 360)));
+    }
+
+    // Models are tagged in two groups, so the hybrid mode can switch between them
+    for (int id = 0; id < MODEL_SLOTS; id++)
+    {
+        recognition->addModel(id, modelImage, (id % 2 == 0) ? "even" : "odd");
+    }
+
+    ImageBuffer stream(IMAGE_BUFFER);
+    StreamGate gate;
+    ProcessingSession session;
+    session.setProcessing(recognition.get());
+    session.setSource(&stream, &gate);
+    session.setImageBuffer(IMAGE_BUFFER);
+
+    // Result handlers are replaced during the processing, like the wrapper does with new result callbacks
+    std::atomic<long long> results(0);
+    std::atomic<long long> errors(0);
+    std::atomic<long long> callbackSwaps(0);
+    Latencies resultIntervals;
+    std::mutex intervalMutex;
+    Clock::time_point lastResult = Clock::now();
+    auto resultHandler = [&](std::vector<Companion::Model::Result::Result*>& frameResults, cv::Mat& image,
+                             const std::shared_ptr<const FrameWork>& work)
+    {
+        {
+            std::lock_guard<std::mutex> lock(intervalMutex);
+            resultIntervals.add(lastResult);
+            lastResult = Clock::now();
+        }
+
+        results += static_cast<long long>(frameResults.size());
+        image.release();
+    };
+    session.setResultHandler(resultHandler, Companion::ColorFormat::BGR, false);
+    session.setErrorHandler([&errors](Companion::Error::Code code)
+    {
+        errors++;
+    });
+
+    std::atomic<bool> done(false);
+    std::atomic<bool> runnerFinished(false);
+    std::atomic<long long> accepted(0);
+    std::atomic<long long> rejected(0);
+    std::atomic<long long> runs(0);
+    std::atomic<long long> modelChanges(0);
+    Latencies addLatencies;
+    Latencies stopLatencies;
+    std::vector<std::unique_ptr<Watch>> watches;
+
+    // Producers add images as fast as possible
+    std::vector<std::thread> threads;
+    for (int i = 0; i < producerCount; i++)
+    {
+        watches.emplace_back(new Watch());
+        watches.back()->name = "addImage (producer " + std::to_string(i) + ")";
+        Watch* watch = watches.back().get();
+        threads.emplace_back([&, i, watch]()
+        {
+            for (size_t frame = i; !done; frame++)
+            {
+                const cv::Mat& scene = scenes[frame % scenes.size()];
+                Clock::time_point start = Clock::now();
+                watch->enter();
+                bool added = false;
+                if (gate.enter())
+                {
+                    added = stream.addImage(scene.cols, scene.rows, scene.type(), scene.data);
+                    gate.leave();
+                }
+                watch->leave();
+                addLatencies.add(start);
+                (added ? accepted : rejected)++;
+            }
+        });
+    }
+
+    // The runner restarts the processing whenever it was stopped
+    threads.emplace_back([&]()
+    {
+        while (!done)
+        {
+            runs++;
+            try
+            {
+                session.run();
+            }
+            catch (Companion::Error::Code code)
+            {
+                errors++;
+            }
+        }
+        runnerFinished = true;
+    });
+
+    // The mutator replaces models and result handlers during the processing
+    threads.emplace_back([&]()
+    {
+        std::mt19937 random(42);
+        while (!done)
+        {
+            int id = static_cast<int>(random() % MODEL_SLOTS);
+            if (mode == "hybrid")
+            {
+                recognition->setActiveTags((id % 2 == 0) ? std::set<std::string>{ "even" } : std::set<std::string>{ "odd" });
+            }
+            else
+            {
+                recognition->removeModel(id);
+                recognition->addModel(id, modelImage, (id % 2 == 0) ? "even" : "odd");
+            }
+            modelChanges++;
+
+            session.setResultHandler(resultHandler, Companion::ColorFormat::BGR, false);
+            callbackSwaps++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(random() % 10));
+        }
+    });
+
+    // The toggler stops the processing at random intervals, the runner starts it again
+    watches.emplace_back(new Watch());
+    watches.back()->name = "stop";
+    Watch* stopWatch = watches.back().get();
+    threads.emplace_back([&]()
+    {
+        std::mt19937 random(7);
+        auto stop = [&]()
+        {
+            Clock::time_point start = Clock::now();
+            stopWatch->enter();
+            session.stop();
+            stopWatch->leave();
+            stopLatencies.add(start);
+        };
+
+        while (!done)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(20 + random() % 200));
+            stop();
+        }
+
+        // The runner may have started the processing once more after the last stop
+        while (!runnerFinished)
+        {
+            stop();
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+    });
+
+    // Watch for hanging calls until the time is up
+    Clock::time_point start = Clock::now();
+    Clock::time_point end = start + std::chrono::seconds(seconds);
+    while (!done)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        long long now = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now().time_since_epoch()).count();
+        for (size_t i = 0; i < watches.size(); i++)
+        {
+            long long since = watches[i]->since;
+            if ((since != 0) && (now - since > HANG_TIMEOUT))
+            {
+                std::cerr << "HANG: " << watches[i]->name << " blocked for " << (now - since) << " ms." << std::endl;
+                std::_Exit(2);
+            }
+        }
+        done = (Clock::now() >= end);
+    }
+
+    for (size_t i = 0; i < threads.size(); i++)
+    {
+        threads[i].join();
+    }
+
+    double elapsed = std::chrono::duration<double>(Clock::now() - start).count();
+    std::cout << "Duration:        " << std::fixed << std::setprecision(1) << elapsed << " s" << std::endl;
+    std::cout << "Runs:            " << runs << std::endl;
+    std::cout << "Images accepted: " << accepted << " (" << (accepted / elapsed) << " per second), rejected: " << rejected << std::endl;
+    std::cout << "Frames:          " << resultIntervals.count() << " (" << (resultIntervals.count() / elapsed) << " per second)" << std::endl;
+    std::cout << "Results:         " << results << std::endl;
+    std::cout << "Model changes:   " << modelChanges << ", handler swaps: " << callbackSwaps << ", errors: " << errors << std::endl;
+    long long residentCurrent, residentPeak;
+    getResidentMemory(residentCurrent, residentPeak);
+    std::cout << "Resident memory: " << (residentCurrent / (1024.0 * 1024.0)) << " MB (peak " << (residentPeak / (1024.0 * 1024.0)) << " MB)" << std::endl;
+    std::cout << std::endl;
+    printMemoryAccounts();
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(16) << "Operation" << std::right << std::setw(10) << "Count" << std::setw(12) << "p50 [ms]"
+              << std::setw(12) << "p99 [ms]" << std::setw(12) << "p99.9 [ms]" << std::setw(12) << "max [ms]" << std::endl;
+    addLatencies.print("addImage");
+    stopLatencies.print("stop");
+    resultIntervals.print("result interval");
+
+    return 0;
+}
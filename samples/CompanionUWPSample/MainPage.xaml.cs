@@ -240,9 +240,9 @@ namespace CompanionUWPSample {
                 CW.ShapeDetection quadDetection = new CW.ShapeDetection(4, 4, "Quad");
 
                 // Configure image processing
-                CW.MatchRecognition matchRecognition = new CW.MatchRecognition(feature, CW.Scaling.SCALE_640x360);
+                CW.MatchRecognition matchRecognition = new CW.MatchRecognition(feature, CW.Scaling.SCALE_640x360, true);
                 CW.HashRecognition hashRecognition = new CW.HashRecognition(polygonDetection, lsh);
-                CW.HybridRecognition hybridRecognition = new CW.HybridRecognition(hashRecognition, feature, 50);
+                CW.HybridRecognition hybridRecognition = new CW.HybridRecognition(hashRecognition, feature, 50, true);
                 CW.ObjectDetection objectDetection = new CW.ObjectDetection(quadDetection);
 
                 // Set callback methods (result image should have an alpha channel (required for WritableBitmap))
@@ -269,6 +269,10 @@ namespace CompanionUWPSample {
                 hybridRecognition.addModel(model0, 0);
                 hybridRecognition.addModel(model1, 1);
 
+                // At most both posters can be visible at the same time
+                matchRecognition.setMaxObjects(2);
+                hybridRecognition.setMaxObjects(2);
+
                 // Choose processing method
                 switch (processingMethod) {
                     case ImageProcessingMethod.FEATUE_MATCHING: